@@ -0,0 +1,52 @@
+#ifndef _BENCH_UTIL_H_
+#define _BENCH_UTIL_H_
+
+#include "minirel.h"
+
+class HeapFile;
+
+// Setup shared by the heap file benchmarks.
+
+const int benchNameLen = 24;
+
+// Same record as the heap file tests.
+struct BenchRecord
+{
+	int ival;
+	double fval;
+	char name[benchNameLen];
+};
+
+// Records per HeapFile::InsertBatch call when a benchmark loads its file.
+const int benchBatchSize = 4096;
+
+// Create a scratch database <name>.DB, with its log, and the global
+// buffer pool. Prints an error and returns FAIL if it cannot be created.
+Status OpenBenchDB(const char *name, int numOfDBPages, int numOfBufs);
+
+// Tear down what OpenBenchDB set up and remove its files.
+void CloseBenchDB(const char *name);
+
+// Fill recs and lens with records first to first + n - 1. Record i has
+// ival i, so a file of records 0 to n - 1 sums to n * (n - 1) / 2.
+void MakeBenchRecords(BenchRecord *recs, int *lens, int first, int n);
+
+// Load records 0 to numOfRecords - 1 into f with InsertBatch. rids, if
+// not NULL, receives the record id of every record.
+Status LoadBenchFile(HeapFile &f, int numOfRecords, RecordID *rids);
+
+// Run timeRun numOfRuns times and return the shortest time it reports.
+template <class Run>
+double BestOf(int numOfRuns, Run timeRun)
+{
+	double best = 0;
+	for (int run = 0; run < numOfRuns; run++)
+	{
+		double time = timeRun();
+		if (run == 0 || time < best)
+			best = time;
+	}
+	return best;
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef _FREESPACEMAP_H
+#define _FREESPACEMAP_H
+
+#include "minirel.h"
+#include "page.h"
+#include "heapfile.h"
+#include "heappage.h"
+#include "pagetable.h"
+
+// FreeSpaceMap finds a page of a heap file with room for a new record without
+// walking the directory of the file.
+//
+// Every data page of the file is kept in one of NUM_BUCKETS buckets according
+// to the space available on it, each bucket being a doubly linked list threaded
+// through arrays indexed by the position of the page in the map. A record of
+// a given length fits on any page of the buckets above its own, so an insert
+// looks at no more than NUM_BUCKETS list heads and pins only the data page it
+// writes to and the directory page holding its PageInfo entry.
+//
+// The map is rebuilt from the PageInfo entries of the directory when it is
+// opened, which pins each directory page once and no data page. While it is
+// open, records of the file should be inserted and deleted through it so that
+// the buckets stay accurate; a page whose bucket is out of date is moved to
+// the right one the first time an insert finds it too full. Pages emptied by
+// deletions are kept for later inserts rather than freed.
+class FreeSpaceMap
+{
+private:
+
+	enum { NUM_BUCKETS = 32 };
+	enum { BUCKET_WIDTH = (HEAPPAGE_DATA_SIZE + NUM_BUCKETS - 1) / NUM_BUCKETS };
+
+	HeapFile *file;
+
+	int capacity;		// Length of the per-page arrays.
+	int numOfPages;		// Number of pages in the map.
+	PageID *pids;		// Data page at each position.
+	PageID *dirPids;	// Directory page holding its PageInfo entry.
+	short *entries;		// Index of its PageInfo entry in that directory page.
+	short *spaces;		// Space available on the page.
+	int *prev;			// Previous page in the same bucket, or -1.
+	int *next;			// Next page in the same bucket, or -1.
+
+	int heads[NUM_BUCKETS];	// First page of each bucket, or -1.
+
+	PageTable *positions;	// Position of each data page in the map.
+
+	int BucketOf(int space);
+	void Link(int pos);
+	void Unlink(int pos);
+	void Add(PageID pid, PageID dirPid, int entry, int space);
+	void SetSpace(int pos, int space);
+
+	// Position of a page the record should fit on, or -1 if there is none.
+	int FindPage(int recLen);
+
+	// Allocate a data page, enter it in the directory and in the map.
+	Status AddNewPage(int &pos);
+
+	// Bring the PageInfo entry of the page at pos up to date.
+	Status UpdatePageInfo(int pos, int space, int recordDelta);
+
+public:
+
+	FreeSpaceMap(HeapFile *file, Status &status);
+	~FreeSpaceMap();
+
+	Status InsertRecord(char *recPtr, int recLen, RecordID &outRid);
+	Status DeleteRecord(const RecordID &rid);
+
+	int GetNumOfPages();
+};
+
+#endif
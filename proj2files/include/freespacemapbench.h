@@ -0,0 +1,27 @@
+#ifndef _FREE_SPACE_MAP_BENCH_H_
+#define _FREE_SPACE_MAP_BENCH_H_
+
+#include "minirel.h"
+
+// This is a driver class for timing inserts into a large heap file with
+// holes left by random deletions, comparing HeapFile::InsertRecord, which
+// walks the directory, against FreeSpaceMap::InsertRecord.
+class FreeSpaceMapBench
+{
+public:
+
+	FreeSpaceMapBench();
+	~FreeSpaceMapBench();
+
+	Status RunBenchmarks();
+
+private:
+
+	// Load a heap file, delete a random part of it and time refilling it.
+	// Returns the time taken in seconds and the pages pinned per insert.
+	double TimeWorkload(const char *fileName, bool useMap, double &pinsPerInsert);
+
+	RecordID *rids;		// Record ids of the loaded records.
+};
+
+#endif
@@ -8,10 +8,15 @@
 #define PERMENANT 1
 
 class HeapPage;
+class DirPage;
+class PinnedRecord;
 
 class HeapFile 
 {
 	friend class Scan;
+	friend class FreeSpaceMap;
+	friend class BatchScan;
+	friend class ParallelScan;
 
 private :
 
@@ -26,6 +31,9 @@ private :
 
 	PageID GetFirstDirPage() { return dirPid; }
 
+	// Append a directory page after the pinned last one, which is unpinned.
+	Status AppendDirPage(PageID &lastPid, DirPage *&lastPage);
+
 
 public:
 
@@ -34,10 +42,14 @@ public:
 
 	int GetNumOfRecords();
 	Status InsertRecord(char* recPtr, int recLen, RecordID& outRid); 
+	Status InsertBatch(const char* recs, const int* lens, int n, RecordID* outRids);
 	Status DeleteRecord(const RecordID& rid); 
 	Status UpdateRecord(const RecordID& rid, char* recPtr, int recLen);
 	Status GetRecord(const RecordID& rid, char* recPtr, int& recLen); 
+	Status GetRecord(const RecordID& rid, PinnedRecord& record);
 	class Scan* OpenScan(Status& status);
+	class BatchScan* OpenBatchScan(Status& status);
+	class ParallelScan* OpenParallelScan(int numOfWorkers, Status& status);
 
 	Status DeleteFile();
 };
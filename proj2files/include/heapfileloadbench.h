@@ -0,0 +1,29 @@
+#ifndef _HEAP_FILE_LOAD_BENCH_H_
+#define _HEAP_FILE_LOAD_BENCH_H_
+
+#include "minirel.h"
+#include "benchutil.h"
+
+// This is a driver class for timing the load of a large heap file, one
+// record at a time against HeapFile::InsertBatch.
+class HeapFileLoadBench
+{
+public:
+
+	HeapFileLoadBench();
+	~HeapFileLoadBench();
+
+	Status RunBenchmarks();
+
+private:
+
+	// Load numOfRecords records into a new heap file, in batches of
+	// batchSize when useBatch is set. Returns the time taken in seconds.
+	double TimeLoad(bool useBatch);
+
+	BenchRecord *recs;	// Records of the current batch.
+	int *lens;			// Length of each record of the batch.
+	RecordID *rids;		// Record ids of the batch.
+};
+
+#endif
@@ -23,7 +23,7 @@ protected :
 	short   numOfSlots;	// Number of slots available (maybe filled or empty).
 	short   freePtr;	// Offset from start of data area, where begins the free space for adding new records.
 	short   freeSpace;	// Amount of free space in bytes in this page.
-	short   type;		// Not used for HeapFile assignment, but will be used in B+-tree assignment.
+	short   freeSlot;	// First slot of the chain of empty slots, INVALID_SLOT if there is none.
 
 	PageID  pid;		// Page ID of this page  
 	PageID  nextPage;	// Page ID of the next page.
@@ -48,6 +48,14 @@ protected :
 		slot->length = INVALID_SLOT;
 	}
 
+	// Empty slots are chained through their offset field, so that a free
+	// slot can be found without scanning the slot directory.
+	void PushFreeSlot(int slotNumber);
+	int PopFreeSlot();
+
+	// Rechain all the empty slots after the slot directory has shrunk.
+	void RebuildFreeSlotList();
+
 	// Get the pointer to the slot at slot slotNumber in the slot directory.
 	Slot* GetSlotAtIndex(int slotNumber);
 
@@ -61,9 +69,6 @@ protected :
 	// Appends a new slot to the end of the slot directory.
 	Slot* AppendNewSlot();
 
-	// sorts the slot ordered by slot->offset
-	Slot** SortSlotDirectory(Slot** slotDir, int begin, int end);
-
 	// Checks if the record given by rid is a valid record on the page
 	bool CheckRecordValidity(RecordID rid);
 
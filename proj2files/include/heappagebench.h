@@ -0,0 +1,29 @@
+#ifndef _HEAP_PAGE_BENCH_H_
+#define _HEAP_PAGE_BENCH_H_
+
+#include "minirel.h"
+
+// This is a driver class for timing delete/insert churn on a single heap
+// page, the pattern that exercises slot reuse and page compaction.
+class HeapPageBench
+{
+public:
+
+	HeapPageBench();
+	~HeapPageBench();
+
+	Status RunBenchmarks();
+
+private:
+
+	// Time the current workload on a fresh page. Returns nanoseconds per
+	// delete/insert pair, and the average number of records on the page.
+	double TimeWorkload(double &avgNumOfRecords);
+
+	void MakeWorkload(int recLen);
+
+	int *victims;		// Random numbers choosing the record to delete.
+	short *lengths;		// Length of the record inserted by each operation.
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef _PAGE_TABLE_BENCH_H_
+#define _PAGE_TABLE_BENCH_H_
+
+#include "minirel.h"
+
+// This is a driver class for timing the page-to-frame lookup of the buffer
+// manager, comparing the chained HashTable against the open addressing PageTable.
+class PageTableBench
+{
+public:
+
+	PageTableBench();
+	~PageTableBench();
+
+	Status RunBenchmarks();
+
+private:
+
+	// Time one workload against one table. Returns nanoseconds per operation.
+	template <class Table>
+	double TimeWorkload(Table &table, int numOfBuf);
+
+	void MakeWorkload(int numOfBuf);
+
+	PageID *resident;	// Pages resident before the timed run, one per frame.
+	PageID *requests;	// Page requested by each operation.
+	int *victims;		// Frame evicted when the request misses.
+};
+
+#endif
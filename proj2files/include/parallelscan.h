@@ -0,0 +1,90 @@
+#ifndef _PARALLELSCAN_H_
+#define _PARALLELSCAN_H_
+
+#include <mutex>
+
+#include "minirel.h"
+#include "heappage.h"
+
+class HeapFile;
+class ScanCursor;
+
+// ParallelScan splits the data pages of a heap file between a number of
+// workers, each of which reads its share through its own ScanCursor.
+//
+// The pages listed in the directory are divided into one contiguous range per
+// worker. A worker takes pages from the front of its own range. Once that is
+// empty, it steals the back half of the next range that still has pages, so a
+// worker that falls behind does not hold up the others.
+//
+// The BufMgr of the library is not thread safe, so the cursors of a scan pin
+// and unpin through a latch owned by the scan. Only those calls are
+// serialized; records are read from the pinned pages without holding it. No
+// other thread may use the buffer manager while the cursors are in use, and
+// the pool needs a free frame for each worker.
+class ParallelScan
+{
+	friend class ScanCursor;
+
+public:
+
+	ParallelScan(HeapFile *hf, int numOfWorkers, Status &status);
+	~ParallelScan();
+
+	int GetNumOfWorkers();
+
+	// The cursor of the given worker, to be used by one thread at a time.
+	// It is deleted with the scan.
+	ScanCursor *GetCursor(int worker);
+
+private:
+
+	// Pages pids[begin] to pids[end - 1] are left for a worker.
+	struct Range
+	{
+		int begin;
+		int end;
+		std::mutex latch;
+	};
+
+	Status ClaimPage(int worker, PageID &pid);
+	Status SwapPages(PageID oldPid, PageID newPid, Page *&newPage);
+
+	PageID *pids;			// Data pages of the file, in directory order.
+	int numOfPids;
+
+	int numOfWorkers;
+	Range *ranges;			// One range per worker.
+	ScanCursor **cursors;	// One cursor per worker.
+
+	std::mutex bmLatch;		// Held around every call to the buffer manager.
+};
+
+// The Scan-like cursor of one worker of a ParallelScan. It keeps the page
+// it is reading pinned until it moves to the next one.
+class ScanCursor
+{
+	friend class ParallelScan;
+
+public:
+
+	// Copy the next record of the worker's share of the file into the
+	// recLen bytes at recPtr. Returns DONE when no page is left for any
+	// worker, and FAIL if the record is longer than recLen.
+	Status GetNext(RecordID &rid, char *recPtr, int &recLen);
+
+private:
+
+	ScanCursor(ParallelScan *scan, int worker);
+	~ScanCursor();
+
+	ParallelScan *scan;
+	int worker;
+
+	PageID pid;				// Page being read, INVALID_PAGE if none.
+	HeapPage *page;
+	int slotNo;				// Next slot to look at.
+	int numOfRecordsLeft;	// Records of the page not returned yet.
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef _PARALLEL_SCAN_BENCH_H_
+#define _PARALLEL_SCAN_BENCH_H_
+
+#include "minirel.h"
+
+class HeapFile;
+
+// This is a driver class for timing a full scan of a heap file by 1 to 16
+// threads sharing a ParallelScan.
+class ParallelScanBench
+{
+public:
+
+	Status RunBenchmarks();
+
+private:
+
+	// Scan the whole file with the given number of threads, each adding up
+	// its records. Returns the wall clock time taken in seconds.
+	double TimeScan(HeapFile &f, int numOfThreads, long long &sum);
+};
+
+#endif
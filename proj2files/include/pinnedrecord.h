@@ -0,0 +1,41 @@
+#ifndef _PINNEDRECORD_H_
+#define _PINNEDRECORD_H_
+
+#include "minirel.h"
+
+// A record of a heap file read in place.
+//
+// HeapFile::GetRecord(rid, record) pins the page holding the record and points
+// the handle at the record on that page, instead of copying it into a buffer
+// the caller has to size. The page stays pinned for as long as the handle
+// holds the record: until Release, until the handle is filled again, or until
+// it is destroyed. A handle cannot be copied, so exactly one owner unpins the
+// page. The record must not be changed through the handle.
+class PinnedRecord
+{
+	friend class HeapFile;
+
+public:
+
+	PinnedRecord();
+	~PinnedRecord();
+
+	// Unpin the page, if a record is held.
+	void Release();
+
+	bool IsPinned() const { return pid != INVALID_PAGE; }
+	const char *GetData() const { return recPtr; }
+	int GetLength() const { return length; }
+
+private:
+
+	// Not copyable, see above.
+	PinnedRecord(const PinnedRecord &);
+	PinnedRecord &operator=(const PinnedRecord &);
+
+	PageID pid;				// Page pinned by the handle, INVALID_PAGE if none.
+	const char *recPtr;		// The record on that page.
+	int length;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef _RECORD_LOOKUP_BENCH_H_
+#define _RECORD_LOOKUP_BENCH_H_
+
+#include "minirel.h"
+
+class HeapFile;
+
+// This is a driver class for timing random lookups of records by RecordID,
+// copying each record out against reading it in place through a
+// PinnedRecord.
+class RecordLookupBench
+{
+public:
+
+	Status RunBenchmarks();
+
+private:
+
+	// Look up every record of rids in turn and add up a field of each.
+	// Returns the time taken in seconds.
+	double TimeLookups(HeapFile &f, const RecordID *rids, int n, bool usePin, long long &sum);
+};
+
+#endif
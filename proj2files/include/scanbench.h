@@ -0,0 +1,23 @@
+#ifndef _SCAN_BENCH_H_
+#define _SCAN_BENCH_H_
+
+#include "minirel.h"
+
+class HeapFile;
+
+// This is a driver class for timing a full scan of a large heap file, one
+// record at a time with Scan against a page at a time with BatchScan.
+class ScanBench
+{
+public:
+
+	Status RunBenchmarks();
+
+private:
+
+	// Scan the whole file and add up a field of every record, so that each
+	// record is actually read. Returns the time taken in seconds.
+	double TimeScan(HeapFile &f, bool useBatch, long long &sum);
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include <iostream>
+
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "dirpage.h"
+#include "batchscan.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------
+// HeapFile::OpenBatchScan
+//
+// Input   : None.
+// Output  : status - OK, or FAIL if the scan cannot be opened.
+// Purpose : Open a scan returning the records a page at a time.
+// Return  : The new scan, to be deleted by the caller.
+//-------------------------------------------------------------------
+BatchScan *HeapFile::OpenBatchScan(Status &status)
+{
+	return new BatchScan(this, status);
+}
+
+BatchScan::BatchScan(HeapFile *hf, Status &status)
+{
+	nextDirPid = hf->GetFirstDirPage();
+	pidsCapacity = 64;
+	pids = new PageID[pidsCapacity];
+	numOfPids = 0;
+	nextEntry = 0;
+	pinnedPid = INVALID_PAGE;
+	status = OK;
+}
+
+BatchScan::~BatchScan()
+{
+	if (pinnedPid != INVALID_PAGE)
+		MINIBASE_BM->UnpinPage(pinnedPid);
+	delete [] pids;
+}
+
+//-------------------------------------------------------------------
+// BatchScan::NextDirPage
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Copy the page ids of the entries of the next directory
+//           page, so that the directory page is pinned only once.
+// Return  : OK, DONE if there are no more directory pages, or FAIL.
+//-------------------------------------------------------------------
+Status BatchScan::NextDirPage()
+{
+	if (nextDirPid == INVALID_PAGE)
+		return DONE;
+
+	Page *page;
+	if (MINIBASE_BM->PinPage(nextDirPid, page) != OK)
+		return FAIL;
+	DirPage *dirPage = (DirPage *)page;
+
+	numOfPids = 0;
+	nextEntry = 0;
+	PageInfoIterator iterator(dirPage);
+	PageInfo *info;
+	while ((info = iterator()) != NULL)
+	{
+		if (numOfPids == pidsCapacity)
+		{
+			PageID *newPids = new PageID[pidsCapacity * 2];
+			for (int i = 0; i < numOfPids; i++)
+				newPids[i] = pids[i];
+			delete [] pids;
+			pids = newPids;
+			pidsCapacity *= 2;
+		}
+		// Empty pages are not worth a pin.
+		if (info->numOfRecords > 0)
+			pids[numOfPids++] = info->pid;
+	}
+
+	PageID dirPid = nextDirPid;
+	nextDirPid = dirPage->GetNextPage();
+	MINIBASE_BM->UnpinPage(dirPid);
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// BatchScan::GetNextBatch
+//
+// Input   : None.
+// Output  : records      - the records of the next page, valid until
+//                          the next call.
+//           numOfRecords - the number of records.
+// Purpose : Unpin the page of the previous batch, pin the next data
+//           page and point at each record on it.
+// Return  : OK, DONE if the whole file has been returned, or FAIL.
+//-------------------------------------------------------------------
+Status BatchScan::GetNextBatch(ScanRecord *&records, int &numOfRecords)
+{
+	if (pinnedPid != INVALID_PAGE)
+	{
+		MINIBASE_BM->UnpinPage(pinnedPid);
+		pinnedPid = INVALID_PAGE;
+	}
+
+	while (true)
+	{
+		while (nextEntry == numOfPids)
+		{
+			Status status = NextDirPage();
+			if (status != OK)
+				return status;
+		}
+
+		PageID pid = pids[nextEntry++];
+		Page *page;
+		if (MINIBASE_BM->PinPage(pid, page) != OK)
+			return FAIL;
+		HeapPage *heapPage = (HeapPage *)page;
+
+		// Empty slots are skipped until every record has been found.
+		int expected = heapPage->GetNumOfRecords();
+		int found = 0;
+		RecordID rid;
+		rid.pageNo = pid;
+		for (rid.slotNo = 0; found < expected; rid.slotNo++)
+		{
+			ScanRecord &record = this->records[found];
+			if (heapPage->ReturnRecord(rid, record.recPtr, record.length) == OK)
+			{
+				record.rid = rid;
+				found++;
+			}
+		}
+
+		if (found == 0)
+		{
+			MINIBASE_BM->UnpinPage(pid);
+			continue;
+		}
+
+		pinnedPid = pid;
+		records = this->records;
+		numOfRecords = found;
+		return OK;
+	}
+}
@@ -0,0 +1,105 @@
+//*****************************************
+//  Setup shared by the heap file benchmarks
+//****************************************
+
+#include <stdio.h>
+#include <iostream>
+#include <string>
+#include <string.h>
+
+#include "db.h"
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "benchutil.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------
+// OpenBenchDB
+//
+// Input   : name         - the base name of the database and log files.
+//           numOfDBPages - the size of the database.
+//           numOfBufs    - the size of the buffer pool.
+// Output  : None.
+// Purpose : Create a fresh database and buffer pool for one benchmark.
+// Return  : OK, or FAIL if the database could not be created.
+//-------------------------------------------------------------------
+Status OpenBenchDB(const char *name, int numOfDBPages, int numOfBufs)
+{
+	Status status;
+	string base(name);
+	minibase_globals = new SystemDefs(status, (base + ".DB").c_str(), (base + ".LOG").c_str(),
+		numOfDBPages, 500, numOfBufs, "Clock");
+	if (status != OK)
+	{
+		cerr << "*** Could not create the benchmark database" << endl;
+		delete minibase_globals;
+		minibase_globals = NULL;
+		return FAIL;
+	}
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// CloseBenchDB
+//
+// Input   : name - the name given to OpenBenchDB.
+// Output  : None.
+// Purpose : Close the database and delete its files.
+//-------------------------------------------------------------------
+void CloseBenchDB(const char *name)
+{
+	string base(name);
+	delete minibase_globals;
+	minibase_globals = NULL;
+	remove((base + ".DB").c_str());
+	remove((base + ".LOG").c_str());
+}
+
+//-------------------------------------------------------------------
+// MakeBenchRecords
+//
+// Input   : first - the number of the first record.
+//           n     - the number of records.
+// Output  : recs, lens - the records and their lengths.
+// Purpose : Fill a batch with records first to first + n - 1.
+//-------------------------------------------------------------------
+void MakeBenchRecords(BenchRecord *recs, int *lens, int first, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		recs[i].ival = first + i;
+		recs[i].fval = (first + i) * 2.5;
+		memcpy(recs[i].name, "record name of 23 chars", benchNameLen);
+		lens[i] = sizeof(BenchRecord);
+	}
+}
+
+//-------------------------------------------------------------------
+// LoadBenchFile
+//
+// Input   : f            - an empty heap file.
+//           numOfRecords - the number of records to load.
+// Output  : rids - if not NULL, the record id of each record in order.
+// Purpose : Load the file benchBatchSize records at a time.
+// Return  : OK, or the status of the first InsertBatch that failed.
+//-------------------------------------------------------------------
+Status LoadBenchFile(HeapFile &f, int numOfRecords, RecordID *rids)
+{
+	BenchRecord *recs = new BenchRecord[benchBatchSize];
+	int *lens = new int[benchBatchSize];
+	RecordID *batchRids = (rids == NULL) ? new RecordID[benchBatchSize] : NULL;
+
+	Status status = OK;
+	for (int first = 0; first < numOfRecords && status == OK; first += benchBatchSize)
+	{
+		int n = numOfRecords - first < benchBatchSize ? numOfRecords - first : benchBatchSize;
+		MakeBenchRecords(recs, lens, first, n);
+		status = f.InsertBatch((char *)recs, lens, n, rids != NULL ? rids + first : batchRids);
+	}
+
+	delete [] recs;
+	delete [] lens;
+	delete [] batchRids;
+	return status;
+}
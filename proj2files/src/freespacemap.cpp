@@ -0,0 +1,403 @@
+#include <iostream>
+#include <string.h>
+
+#include "bufmgr.h"
+#include "dirpage.h"
+#include "freespacemap.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::FreeSpaceMap
+//
+// Input   : file - an open heap file.
+// Output  : status - OK, or FAIL if a directory page cannot be read.
+// Purpose : Build the map from the PageInfo entries of every directory
+//           page of the file.
+//-------------------------------------------------------------------
+FreeSpaceMap::FreeSpaceMap(HeapFile *file, Status &status)
+{
+	this->file = file;
+	capacity = 64;
+	numOfPages = 0;
+	pids = new PageID[capacity];
+	dirPids = new PageID[capacity];
+	entries = new short[capacity];
+	spaces = new short[capacity];
+	prev = new int[capacity];
+	next = new int[capacity];
+	positions = new PageTable(capacity);
+	for (int b = 0; b < NUM_BUCKETS; b++)
+	{
+		heads[b] = -1;
+	}
+
+	status = OK;
+	PageID dirPid = file->GetFirstDirPage();
+	while (dirPid != INVALID_PAGE)
+	{
+		Page *page;
+		if (MINIBASE_BM->PinPage(dirPid, page) != OK)
+		{
+			status = FAIL;
+			return;
+		}
+
+		DirPage *dirPage = (DirPage *)page;
+		PageInfoIterator iterator(dirPage);
+		PageInfo *info;
+		for (int entry = 0; (info = iterator()) != NULL; entry++)
+		{
+			Add(info->pid, dirPid, entry, info->spaceAvailable);
+		}
+
+		PageID nextDirPid = dirPage->GetNextPage();
+		MINIBASE_BM->UnpinPage(dirPid);
+		dirPid = nextDirPid;
+	}
+}
+
+FreeSpaceMap::~FreeSpaceMap()
+{
+	delete [] pids;
+	delete [] dirPids;
+	delete [] entries;
+	delete [] spaces;
+	delete [] prev;
+	delete [] next;
+	delete positions;
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::BucketOf
+//
+// Input   : space - the space available on a page.
+// Output  : None.
+// Return  : The bucket a page with that much space belongs to.
+//-------------------------------------------------------------------
+int FreeSpaceMap::BucketOf(int space)
+{
+	int b = space / BUCKET_WIDTH;
+	if (b < 0)
+		return 0;
+	if (b >= NUM_BUCKETS)
+		return NUM_BUCKETS - 1;
+	return b;
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::Link
+//
+// Input   : pos - the position of a page that is in no bucket.
+// Output  : None.
+// Purpose : Put the page at the head of the bucket its space maps to.
+//-------------------------------------------------------------------
+void FreeSpaceMap::Link(int pos)
+{
+	int b = BucketOf(spaces[pos]);
+	prev[pos] = -1;
+	next[pos] = heads[b];
+	if (heads[b] != -1)
+		prev[heads[b]] = pos;
+	heads[b] = pos;
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::Unlink
+//
+// Input   : pos - the position of a page.
+// Output  : None.
+// Purpose : Take the page out of its bucket.
+//-------------------------------------------------------------------
+void FreeSpaceMap::Unlink(int pos)
+{
+	if (prev[pos] != -1)
+		next[prev[pos]] = next[pos];
+	else
+		heads[BucketOf(spaces[pos])] = next[pos];
+	if (next[pos] != -1)
+		prev[next[pos]] = prev[pos];
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::Add
+//
+// Input   : pid    - a data page of the file.
+//           dirPid - the directory page holding its PageInfo entry.
+//           entry  - the index of that entry.
+//           space  - the space available on the page.
+// Output  : None.
+// Purpose : Enter the page in the map, growing the arrays if needed.
+//-------------------------------------------------------------------
+void FreeSpaceMap::Add(PageID pid, PageID dirPid, int entry, int space)
+{
+	if (numOfPages == capacity)
+	{
+		int newCapacity = capacity * 2;
+		PageID *newPids = new PageID[newCapacity];
+		PageID *newDirPids = new PageID[newCapacity];
+		short *newEntries = new short[newCapacity];
+		short *newSpaces = new short[newCapacity];
+		int *newPrev = new int[newCapacity];
+		int *newNext = new int[newCapacity];
+		memcpy(newPids, pids, capacity * sizeof(PageID));
+		memcpy(newDirPids, dirPids, capacity * sizeof(PageID));
+		memcpy(newEntries, entries, capacity * sizeof(short));
+		memcpy(newSpaces, spaces, capacity * sizeof(short));
+		memcpy(newPrev, prev, capacity * sizeof(int));
+		memcpy(newNext, next, capacity * sizeof(int));
+		delete [] pids;
+		delete [] dirPids;
+		delete [] entries;
+		delete [] spaces;
+		delete [] prev;
+		delete [] next;
+		pids = newPids;
+		dirPids = newDirPids;
+		entries = newEntries;
+		spaces = newSpaces;
+		prev = newPrev;
+		next = newNext;
+
+		// The page table does not grow, so build a bigger one.
+		delete positions;
+		positions = new PageTable(newCapacity);
+		for (int i = 0; i < numOfPages; i++)
+		{
+			positions->Insert(pids[i], i);
+		}
+		capacity = newCapacity;
+	}
+
+	int pos = numOfPages++;
+	pids[pos] = pid;
+	dirPids[pos] = dirPid;
+	entries[pos] = entry;
+	spaces[pos] = space;
+	positions->Insert(pid, pos);
+	Link(pos);
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::SetSpace
+//
+// Input   : pos   - the position of a page.
+//           space - the space now available on it.
+// Output  : None.
+// Purpose : Move the page to the bucket of its new space.
+//-------------------------------------------------------------------
+void FreeSpaceMap::SetSpace(int pos, int space)
+{
+	if (BucketOf(space) == BucketOf(spaces[pos]))
+	{
+		spaces[pos] = space;
+		return;
+	}
+	Unlink(pos);
+	spaces[pos] = space;
+	Link(pos);
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::FindPage
+//
+// Input   : recLen - the length of the record to insert.
+// Output  : None.
+// Purpose : Try the head of the bucket of recLen, whose pages may or may
+//           not have enough room, then the first page of the lowest
+//           bucket above it, all of whose pages do.
+// Return  : The position of the page, or -1 if no page has room.
+//-------------------------------------------------------------------
+int FreeSpaceMap::FindPage(int recLen)
+{
+	int b = BucketOf(recLen);
+	if (heads[b] != -1 && spaces[heads[b]] >= recLen)
+		return heads[b];
+
+	for (b++; b < NUM_BUCKETS; b++)
+	{
+		if (heads[b] != -1)
+			return heads[b];
+	}
+	return -1;
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::AddNewPage
+//
+// Input   : None.
+// Output  : pos - the position of the new page in the map.
+// Purpose : Allocate and initialize a data page and enter it in the last
+//           directory page of the file, appending a directory page
+//           first if the last one is full.
+// Return  : OK, or FAIL if a page cannot be allocated or read.
+//-------------------------------------------------------------------
+Status FreeSpaceMap::AddNewPage(int &pos)
+{
+	PageID pid;
+	Page *page;
+	if (MINIBASE_BM->NewPage(pid, page) != OK)
+		return FAIL;
+	HeapPage *heapPage = (HeapPage *)page;
+	heapPage->Init(pid);
+
+	PageID dirPid = file->lastDirPid;
+	Page *dir;
+	if (MINIBASE_BM->PinPage(dirPid, dir) != OK)
+	{
+		MINIBASE_BM->UnpinPage(pid);
+		MINIBASE_BM->FreePage(pid);
+		return FAIL;
+	}
+	DirPage *dirPage = (DirPage *)dir;
+
+	if (!dirPage->HasFreeSpace() && file->AppendDirPage(dirPid, dirPage) != OK)
+	{
+		MINIBASE_BM->UnpinPage(dirPid);
+		MINIBASE_BM->UnpinPage(pid);
+		MINIBASE_BM->FreePage(pid);
+		return FAIL;
+	}
+
+	Status status = dirPage->InsertPage(pid, heapPage);
+	int entry = dirPage->FindPageInfoEntry(pid);
+	int space = heapPage->AvailableSpace();
+	MINIBASE_BM->UnpinPage(dirPid, true);
+	MINIBASE_BM->UnpinPage(pid, true);
+	if (status != OK)
+	{
+		MINIBASE_BM->FreePage(pid);
+		return FAIL;
+	}
+
+	pos = numOfPages;
+	Add(pid, dirPid, entry, space);
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::UpdatePageInfo
+//
+// Input   : pos         - the position of a page.
+//           space       - the space now available on it.
+//           recordDelta - the change in its number of records.
+// Output  : None.
+// Purpose : Update the PageInfo entry of the page, looking the entry up
+//           again if the directory page has been rearranged.
+// Return  : OK, or FAIL if the entry cannot be found.
+//-------------------------------------------------------------------
+Status FreeSpaceMap::UpdatePageInfo(int pos, int space, int recordDelta)
+{
+	Page *page;
+	if (MINIBASE_BM->PinPage(dirPids[pos], page) != OK)
+		return FAIL;
+	DirPage *dirPage = (DirPage *)page;
+
+	PageInfo *info = dirPage->GetPageInfo(entries[pos]);
+	if (info == NULL || info->pid != pids[pos])
+	{
+		entries[pos] = dirPage->FindPageInfoEntry(pids[pos]);
+		info = dirPage->FindPageInfo(pids[pos]);
+	}
+	if (info == NULL)
+	{
+		MINIBASE_BM->UnpinPage(dirPids[pos]);
+		return FAIL;
+	}
+
+	info->spaceAvailable = space;
+	info->numOfRecords += recordDelta;
+	MINIBASE_BM->UnpinPage(dirPids[pos], true);
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::InsertRecord
+//
+// Input   : recPtr - the record.
+//           recLen - its length.
+// Output  : outRid - the id of the inserted record.
+// Purpose : Insert the record on a page found through the buckets, or on
+//           a new page if none has room.
+// Return  : OK, or FAIL if the record does not fit on an empty page or a
+//           page cannot be read or allocated.
+//-------------------------------------------------------------------
+Status FreeSpaceMap::InsertRecord(char *recPtr, int recLen, RecordID &outRid)
+{
+	int pos = FindPage(recLen);
+	while (true)
+	{
+		bool newPage = false;
+		if (pos == -1)
+		{
+			if (AddNewPage(pos) != OK)
+				return FAIL;
+			newPage = true;
+		}
+
+		Page *page;
+		if (MINIBASE_BM->PinPage(pids[pos], page) != OK)
+			return FAIL;
+		HeapPage *heapPage = (HeapPage *)page;
+		Status status = heapPage->InsertRecord(recPtr, recLen, outRid);
+		int space = heapPage->AvailableSpace();
+		MINIBASE_BM->UnpinPage(pids[pos], status == OK);
+
+		if (status == OK)
+		{
+			SetSpace(pos, space);
+			return UpdatePageInfo(pos, space, 1);
+		}
+		if (status != DONE || newPage)
+		{
+			cerr << "*** Record of length " << recLen << " does not fit on a heap page" << endl;
+			return FAIL;
+		}
+
+		// The bucket was out of date; file the page correctly and retry.
+		SetSpace(pos, space);
+		pos = FindPage(recLen);
+	}
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::DeleteRecord
+//
+// Input   : rid - the id of a record of the file.
+// Output  : None.
+// Purpose : Delete the record and move its page to the bucket of its
+//           new space. A page that is not in the map is left to
+//           HeapFile::DeleteRecord.
+// Return  : OK, or FAIL if the record does not exist.
+//-------------------------------------------------------------------
+Status FreeSpaceMap::DeleteRecord(const RecordID &rid)
+{
+	int pos = positions->LookUp(rid.pageNo);
+	if (pos == INVALID_FRAME)
+		return file->DeleteRecord(rid);
+
+	Page *page;
+	if (MINIBASE_BM->PinPage(pids[pos], page) != OK)
+		return FAIL;
+	HeapPage *heapPage = (HeapPage *)page;
+	Status status = heapPage->DeleteRecord(rid);
+	int space = heapPage->AvailableSpace();
+	MINIBASE_BM->UnpinPage(pids[pos], status == OK);
+	if (status != OK)
+		return FAIL;
+
+	SetSpace(pos, space);
+	return UpdatePageInfo(pos, space, -1);
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMap::GetNumOfPages
+//
+// Input   : None.
+// Output  : None.
+// Return  : The number of data pages in the map.
+//-------------------------------------------------------------------
+int FreeSpaceMap::GetNumOfPages()
+{
+	return numOfPages;
+}
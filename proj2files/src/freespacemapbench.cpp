@@ -0,0 +1,138 @@
+//*****************************************
+//  Benchmark for inserts through the free-space map
+//****************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <time.h>
+
+#include "db.h"
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "freespacemap.h"
+#include "benchutil.h"
+#include "freespacemapbench.h"
+
+using namespace std;
+
+static const int numOfRecords = 1000000;
+
+// Share of the records deleted before the timed inserts refill the holes.
+static const int deletePercent = 30;
+static const int numOfInserts = numOfRecords / 100 * deletePercent;
+
+// Room for two loaded files.
+static const int numOfDBPages = 150000;
+static const int numOfBufs = 1000;
+
+FreeSpaceMapBench::FreeSpaceMapBench()
+{
+	rids = new RecordID[numOfRecords];
+}
+
+FreeSpaceMapBench::~FreeSpaceMapBench()
+{
+	delete [] rids;
+}
+
+//-------------------------------------------------------------------
+// FreeSpaceMapBench::TimeWorkload
+//
+// Input   : fileName - the heap file to create.
+//           useMap   - whether the timed inserts go through a
+//                      FreeSpaceMap or through HeapFile::InsertRecord.
+// Output  : pinsPerInsert - pages pinned per timed insert.
+// Purpose : Load the file, delete a random deletePercent of its records
+//           and time inserting as many records again. Opening the map,
+//           which rebuilds it from the directory, is part of the timed
+//           run.
+// Return  : The time taken by the timed run in seconds.
+//-------------------------------------------------------------------
+double FreeSpaceMapBench::TimeWorkload(const char *fileName, bool useMap, double &pinsPerInsert)
+{
+	Status status;
+	HeapFile f(fileName, status);
+
+	BenchRecord rec;
+	memset(&rec, 0, sizeof(rec));
+
+	// The load goes through a map too, so that both files start from
+	// the same layout.
+	FreeSpaceMap *loader = new FreeSpaceMap(&f, status);
+	for (int i = 0; i < numOfRecords; i++)
+	{
+		rec.ival = i;
+		rec.fval = i * 2.5;
+		sprintf(rec.name, "record %i", i);
+		loader->InsertRecord((char *)&rec, sizeof(rec), rids[i]);
+	}
+
+	srand(1);
+	for (int i = 0; i < numOfInserts; i++)
+	{
+		int j = i + ((rand() % 32768) * 32768 + rand() % 32768) % (numOfRecords - i);
+		RecordID rid = rids[j];
+		rids[j] = rids[i];
+		rids[i] = rid;
+		loader->DeleteRecord(rid);
+	}
+	delete loader;
+
+	long pinNo, missNo;
+	MINIBASE_BM->ResetStat();
+	clock_t start = clock();
+	if (useMap)
+	{
+		FreeSpaceMap map(&f, status);
+		for (int i = 0; i < numOfInserts; i++)
+		{
+			rec.ival = i;
+			map.InsertRecord((char *)&rec, sizeof(rec), rids[i]);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < numOfInserts; i++)
+		{
+			rec.ival = i;
+			f.InsertRecord((char *)&rec, sizeof(rec), rids[i]);
+		}
+	}
+	clock_t end = clock();
+	MINIBASE_BM->GetStat(pinNo, missNo);
+
+	if (f.GetNumOfRecords() != numOfRecords)
+	{
+		cerr << "*** " << fileName << " has " << f.GetNumOfRecords() << " records instead of "
+			<< numOfRecords << endl;
+	}
+
+	f.DeleteFile();
+	pinsPerInsert = (double)pinNo / numOfInserts;
+	return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+Status FreeSpaceMapBench::RunBenchmarks()
+{
+	if (OpenBenchDB("FSMBENCH", numOfDBPages, numOfBufs) != OK)
+		return FAIL;
+
+	cout << "\nRunning free-space map benchmarks...\n" << endl;
+	cout << "  " << numOfRecords << " records loaded, " << deletePercent << "% deleted at random, "
+		<< numOfInserts << " records inserted\n" << endl;
+	cout << "  insert path                  seconds   inserts/s     pins/insert" << endl;
+
+	double pinsPerInsert;
+	double time = TimeWorkload("fsmbench.walk", false, pinsPerInsert);
+	printf("  HeapFile::InsertRecord       %-8.2f  %-12.0f  %-10.1f\n", time, numOfInserts / time, pinsPerInsert);
+
+	time = TimeWorkload("fsmbench.map", true, pinsPerInsert);
+	printf("  FreeSpaceMap::InsertRecord   %-8.2f  %-12.0f  %-10.1f\n", time, numOfInserts / time, pinsPerInsert);
+
+	cout << "\n...free-space map benchmarks completed.\n" << endl;
+
+	CloseBenchDB("FSMBENCH");
+	return OK;
+}
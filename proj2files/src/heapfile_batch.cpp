@@ -0,0 +1,163 @@
+#include <iostream>
+
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "heappage.h"
+#include "dirpage.h"
+
+using namespace std;
+
+// Most pages InsertBatch allocates with one call to BufMgr::NewPage.
+static const int maxPagesPerRun = 64;
+
+// Space a record takes on a fresh heap page, its slot included.
+static int SpaceFor(int recLen)
+{
+	return recLen + 2 * sizeof(short);
+}
+
+//------------------------------------------------------------------
+// HeapFile::AppendDirPage
+//
+// Input    : lastPid  - the last directory page of the file.
+//            lastPage - that page, pinned.
+// Output   : lastPid and lastPage are the new last directory page,
+//            pinned.
+// Purpose  : Allocate a directory page, link it after the last one and
+//            unpin the old last page.
+// Return   : OK, or FAIL if no page can be allocated, in which case the
+//            old last page stays pinned.
+//------------------------------------------------------------------
+Status HeapFile::AppendDirPage(PageID &lastPid, DirPage *&lastPage)
+{
+	PageID newPid;
+	Page *newPage;
+	if (MINIBASE_BM->NewPage(newPid, newPage) != OK)
+		return FAIL;
+
+	DirPage *newDirPage = (DirPage *)newPage;
+	newDirPage->Init(newPid);
+	newDirPage->SetPrevPage(lastPid);
+	lastPage->SetNextPage(newPid);
+	MINIBASE_BM->UnpinPage(lastPid, true);
+
+	lastPid = newPid;
+	lastPage = newDirPage;
+	lastDirPid = newPid;
+	return OK;
+}
+
+//------------------------------------------------------------------
+// HeapFile::InsertBatch
+//
+// Input    : recs     - n records stored one after another.
+//            lens     - the length of each record.
+//            n        - the number of records.
+// Output   : outRids  - the id of each inserted record, unless NULL.
+// Purpose  : Append the records to fresh pages. The pages are allocated
+//            in runs of up to maxPagesPerRun, sized by packing the records
+//            the way HeapPage::InsertRecord does, and each page is entered
+//            in the directory once, when it is full, instead of the
+//            directory being updated for every record. The last directory
+//            page stays pinned for the whole batch.
+// Return   : OK, or FAIL if a record does not fit on an empty page or a
+//            page cannot be allocated. Records inserted before the
+//            failure stay in the file; the ids of the others are left
+//            untouched, or set to INVALID_PAGE for the records of a
+//            page that could not be entered in the directory.
+//------------------------------------------------------------------
+Status HeapFile::InsertBatch(const char *recs, const int *lens, int n, RecordID *outRids)
+{
+	PageID curDirPid = lastDirPid;
+	Page *dir;
+	if (MINIBASE_BM->PinPage(curDirPid, dir) != OK)
+		return FAIL;
+	DirPage *dirPage = (DirPage *)dir;
+
+	Status status = OK;
+	const char *recPtr = recs;
+	int i = 0;
+	while (i < n && status == OK)
+	{
+		// Count the fresh pages the next records fill.
+		int numOfPages = 0;
+		int used = HEAPPAGE_DATA_SIZE;
+		for (int j = i; j < n; j++)
+		{
+			if (used + SpaceFor(lens[j]) > HEAPPAGE_DATA_SIZE)
+			{
+				if (numOfPages == maxPagesPerRun)
+					break;
+				numOfPages++;
+				used = 0;
+			}
+			used += SpaceFor(lens[j]);
+		}
+
+		// Only the first page of the run comes back pinned.
+		PageID firstPid;
+		Page *page;
+		if (MINIBASE_BM->NewPage(firstPid, page, numOfPages) != OK)
+		{
+			status = FAIL;
+			break;
+		}
+
+		int p = 0;
+		for (; p < numOfPages && i < n; p++)
+		{
+			PageID pid = firstPid + p;
+			if (p > 0 && MINIBASE_BM->PinPage(pid, page, true) != OK)
+			{
+				status = FAIL;
+				break;
+			}
+
+			HeapPage *heapPage = (HeapPage *)page;
+			heapPage->Init(pid);
+			RecordID rid;
+			while (i < n && heapPage->InsertRecord(recPtr, lens[i], rid) == OK)
+			{
+				if (outRids != NULL)
+					outRids[i] = rid;
+				recPtr += lens[i];
+				i++;
+			}
+
+			if (heapPage->GetNumOfRecords() == 0)
+			{
+				cerr << "*** Record of length " << lens[i] << " does not fit on a heap page" << endl;
+				MINIBASE_BM->UnpinPage(pid);
+				status = FAIL;
+				break;
+			}
+
+			if (!dirPage->HasFreeSpace() && AppendDirPage(curDirPid, dirPage) != OK)
+			{
+				// The page never reaches the directory, so its records are
+				// taken back and it is freed with the rest of the run.
+				for (int k = heapPage->GetNumOfRecords(); k > 0; k--)
+				{
+					i--;
+					recPtr -= lens[i];
+					if (outRids != NULL)
+						outRids[i].pageNo = INVALID_PAGE;
+				}
+				MINIBASE_BM->UnpinPage(pid);
+				status = FAIL;
+				break;
+			}
+			dirPage->InsertPage(pid, heapPage);
+			MINIBASE_BM->UnpinPage(pid, true);
+		}
+
+		// Give back the pages the run did not use.
+		for (; p < numOfPages; p++)
+		{
+			MINIBASE_BM->FreePage(firstPid + p);
+		}
+	}
+
+	MINIBASE_BM->UnpinPage(curDirPid, true);
+	return status;
+}
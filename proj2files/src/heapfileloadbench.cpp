@@ -0,0 +1,116 @@
+//*****************************************
+//  Benchmark for loading heap files
+//****************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <time.h>
+
+#include "db.h"
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "heappage.h"
+#include "freespacemap.h"
+#include "benchutil.h"
+#include "heapfileloadbench.h"
+
+using namespace std;
+
+static const int numOfRecords = 10000000;
+static const int batchSize = benchBatchSize;
+
+// Room for one loaded file, a quarter more than its data pages for the
+// directory and the free space map's partly filled pages; each load
+// deletes its file afterwards.
+static const int recordsPerPage = HEAPPAGE_DATA_SIZE / (sizeof(BenchRecord) + 2 * sizeof(short));
+static const int numOfDBPages = numOfRecords / recordsPerPage * 5 / 4 + 1000;
+static const int numOfBufs = 1000;
+
+HeapFileLoadBench::HeapFileLoadBench()
+{
+	recs = new BenchRecord[batchSize];
+	lens = new int[batchSize];
+	rids = new RecordID[batchSize];
+}
+
+HeapFileLoadBench::~HeapFileLoadBench()
+{
+	delete [] recs;
+	delete [] lens;
+	delete [] rids;
+}
+
+//-------------------------------------------------------------------
+// HeapFileLoadBench::TimeLoad
+//
+// Input   : useBatch - whether to load with HeapFile::InsertBatch.
+// Output  : None.
+// Purpose : Load the records batch by batch. Without useBatch each
+//           record of a batch goes through FreeSpaceMap::InsertRecord,
+//           the cheapest single record insert, since HeapFile::InsertRecord
+//           walks the whole directory and would not finish at this size.
+// Return  : The time taken in seconds.
+//-------------------------------------------------------------------
+double HeapFileLoadBench::TimeLoad(bool useBatch)
+{
+	Status status;
+	HeapFile f("loadbench", status);
+	FreeSpaceMap map(&f, status);
+
+	clock_t start = clock();
+	for (int first = 0; first < numOfRecords; first += batchSize)
+	{
+		int n = numOfRecords - first < batchSize ? numOfRecords - first : batchSize;
+		MakeBenchRecords(recs, lens, first, n);
+		if (useBatch)
+		{
+			status = f.InsertBatch((char *)recs, lens, n, rids);
+		}
+		else
+		{
+			for (int i = 0; i < n && status == OK; i++)
+			{
+				status = map.InsertRecord((char *)&recs[i], sizeof(BenchRecord), rids[i]);
+			}
+		}
+		if (status != OK)
+		{
+			cerr << "*** Load failed after " << first << " records" << endl;
+			break;
+		}
+	}
+	clock_t end = clock();
+
+	if (f.GetNumOfRecords() != numOfRecords)
+	{
+		cerr << "*** Loaded file has " << f.GetNumOfRecords() << " records instead of "
+			<< numOfRecords << endl;
+	}
+
+	f.DeleteFile();
+	return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+Status HeapFileLoadBench::RunBenchmarks()
+{
+	if (OpenBenchDB("LOADBENCH", numOfDBPages, numOfBufs) != OK)
+		return FAIL;
+
+	cout << "\nRunning heap file load benchmarks...\n" << endl;
+	cout << "  " << numOfRecords << " records of " << sizeof(BenchRecord) << " bytes, "
+		<< batchSize << " records per batch\n" << endl;
+	cout << "  load path                     seconds   records/s" << endl;
+
+	double time = TimeLoad(false);
+	printf("  one InsertRecord per record   %-8.2f  %-12.0f\n", time, numOfRecords / time);
+
+	time = TimeLoad(true);
+	printf("  HeapFile::InsertBatch         %-8.2f  %-12.0f\n", time, numOfRecords / time);
+
+	cout << "\n...heap file load benchmarks completed.\n" << endl;
+
+	CloseBenchDB("LOADBENCH");
+	return OK;
+}
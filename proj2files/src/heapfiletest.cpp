@@ -12,6 +12,7 @@
 #include "db.h"
 #include "heapfile.h"
 #include "scan.h"
+#include "parallelscan.h"
 #include "heapfiletest.h"
 #include "bufmgr.h"
 
@@ -549,6 +550,34 @@ bool HeapFileDriver::Test5()
 
 	delete scan;
 
+	//	Try to read a record into a buffer that is too short -- should fail
+	if ( status == OK )
+	{
+		cout << "  - Try to read a record into a buffer that's too short\n";
+		ParallelScan pscan(&f, 1, status);
+		if (status != OK)
+			cerr << "*** Error opening parallel scan\n";
+		else
+		{
+			ScanCursor *cursor = pscan.GetCursor(0);
+			Rec rec;
+			int len = sizeof(rec) - 1;
+			status = cursor->GetNext(rid, (char *)&rec, len);
+			TestFailure( status, HEAPFILE, "Reading a record into a too-short buffer" );
+			if ( status == OK )
+			{
+				// The record was not skipped.
+				len = sizeof(rec);
+				status = cursor->GetNext(rid, (char *)&rec, len);
+				if ( status != OK || len != reclen )
+				{
+					cerr << "*** Error reading the record into a large enough buffer\n";
+					status = FAIL;
+				}
+			}
+		}
+	}
+
 	//	Try to insert a too long record -- should fail
 	if ( status == OK )
 	{
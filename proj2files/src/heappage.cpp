@@ -1,6 +1,7 @@
 #include <iostream>
 #include <stdlib.h>
 #include <memory.h>
+#include <algorithm>
 
 #include "heappage.h"
 #include "heapfile.h"
@@ -23,6 +24,7 @@ void HeapPage::Init(PageID pageNo)
 	pid = pageNo; //set the pageID of this page to the arg.
 	freePtr = HEAPPAGE_DATA_SIZE; //pointer is at the END of the page
 	freeSpace = HEAPPAGE_DATA_SIZE; //at beginning, page is empty
+	freeSlot = INVALID_SLOT; //no empty slots either
 }
 
 //------------------------------------------------------------------
@@ -140,71 +142,54 @@ HeapPage::Slot* HeapPage::AppendNewSlot(){
 }
 
 //------------------------------------------------------------------
-// HeapPage::Slot** HeapPage::SortSlotDirectory(Slot** slotDir, int begin, int end)
+// HeapPage::PushFreeSlot
 //
-// Input     : The slot directory to be sorted, where to begin sorting, and where to end sorting.
-// Output    : None
-// Purpose   : Helper Function for CompressPage so that shifting slots is easier.
-// Return    : A dynamically created Slot * array, ordered by Slot->offset from Highest to Lowest
-//------------------------------------------------------------------
-HeapPage::Slot** HeapPage::SortSlotDirectory(Slot** slotDir, int begin, int end) {
-	if (begin == end) { //Only one entry.
-		Slot **oneSlot;
-		oneSlot = new Slot *[sizeof(Slot *)];
-		*oneSlot = slotDir[begin];
-		return oneSlot;
-	}
-	else {
-		int leftEnd = ((end - begin)/2) + begin;
-		int rightBegin = leftEnd + 1;
-		//Sort the left side
-		Slot** leftSide = SortSlotDirectory(slotDir, begin, leftEnd);
-
-		//Sort the right side
-		Slot** rightSide = SortSlotDirectory(slotDir, rightBegin, end);
-
-		//Merge the sides
-		Slot** sortedSides;
-		sortedSides = new Slot *[(end - begin + 1) * sizeof(Slot *)];
-
-		int pointerLeft = 0;
-		int pointerRight = 0;
-		int leftSideLength = (leftEnd - begin) + 1;
-		int rightSideLength = (end - rightBegin) + 1;
-		int sortedIndex = 0;
-		//choose the largest between the two and place it first.
-		while (pointerLeft < leftSideLength && pointerRight < rightSideLength) {
-			if (leftSide[pointerLeft] -> offset >= rightSide[pointerRight] -> offset) {
-				sortedSides[sortedIndex] = leftSide[pointerLeft];
-				sortedIndex++;
-				pointerLeft++;
-			}
-			else {
-				sortedSides[sortedIndex] = rightSide[pointerRight];
-				sortedIndex++;
-				pointerRight++;
-			}
-		}
-		//If one array is all in the sorted away, put the rest of the entries in the other array
-		//into the sorted array.
-		if (pointerLeft < leftSideLength) {
-			for (int i = pointerLeft; i < leftSideLength; i++) {
-				sortedSides[sortedIndex] = leftSide[pointerLeft];
-				sortedIndex++;
-			}
-		}
-		if (pointerRight < rightSideLength) {
-			for (int i = pointerRight; i < rightSideLength; i++) {
-				sortedSides[sortedIndex] = rightSide[pointerRight];
-				sortedIndex++;
-			}
-		}
+// Input    : the number of a slot that has just been emptied.
+// Output   : None.
+// Purpose  : Put the slot at the head of the chain of empty slots. The
+//            offset of an empty slot holds the next slot in the chain.
+// Return   : None.
+//------------------------------------------------------------------
+void HeapPage::PushFreeSlot(int slotNumber) {
+	Slot *slot = GetSlotAtIndex(slotNumber);
+	SetSlotEmpty(slot);
+	slot->offset = freeSlot;
+	freeSlot = slotNumber;
+}
 
-		/*These sides are no longer in use. can free them. No recursive delete though.*/
-		delete [] leftSide;
-		delete [] rightSide;
+//------------------------------------------------------------------
+// HeapPage::PopFreeSlot
+//
+// Input    : None.
+// Output   : None.
+// Purpose  : Take the slot at the head of the chain of empty slots.
+// Return   : The slot number, or INVALID_SLOT if no slot is empty.
+//------------------------------------------------------------------
+int HeapPage::PopFreeSlot() {
+	int slotNumber = freeSlot;
+	if (slotNumber != INVALID_SLOT) {
+		freeSlot = GetSlotAtIndex(slotNumber)->offset;
+	}
+	return slotNumber;
+}
 
-		return sortedSides;
+//------------------------------------------------------------------
+// HeapPage::RebuildFreeSlotList
+//
+// Input    : None.
+// Output   : None.
+// Purpose  : Chain every empty slot of the directory again, lowest slot
+//            number first. Needed when empty slots at the end of the
+//            directory have been dropped, as they may be anywhere in
+//            the chain. That only happens when the last slot is deleted.
+// Return   : None.
+//------------------------------------------------------------------
+void HeapPage::RebuildFreeSlotList() {
+	freeSlot = INVALID_SLOT;
+	for (int i = numOfSlots - 1; i >= 0; i--) {
+		if (SlotIsEmpty(GetSlotAtIndex(i))) {
+			PushFreeSlot(i);
+		}
 	}
 }
 
@@ -214,37 +199,36 @@ HeapPage::Slot** HeapPage::SortSlotDirectory(Slot** slotDir, int begin, int end)
 // Input     : None 
 // Output    : The page after compression.
 // Purpose   : To reclaim the free space in the page left as holes after deletion.
+//             Records are moved towards the end of the data area in order of
+//             decreasing offset, so each one only ever moves over space that is
+//             already free and the page is compacted in place. The order is built
+//             on the stack; nothing is allocated.
 // Return    : OK if everything went OK, FAIL otherwise.
 //------------------------------------------------------------------
 Status HeapPage::CompressPage() {
-	
-	/**Firstly, sort the slots by inner offset so that it is easier to shift**/
-	/*Dynamically allocated slot directory, so that the slot directory in data is unaffected during sorting*/
-	Slot **slotDir;
-	slotDir = new Slot *[numOfSlots];
-	/*Initialize slotDir. O(n)*/
-	for (int i = 0; i <= numOfSlots - 1; i++) {
-		slotDir[i] = GetSlotAtIndex(i);
+	// Each entry packs the offset of a record above its slot number, so
+	// sorting the entries sorts the records by offset.
+	int order[HEAPPAGE_DATA_SIZE / sizeof(Slot)];
+	int numOfRecords = 0;
+	for (int i = 0; i < numOfSlots; i++) {
+		Slot *slot = GetSlotAtIndex(i);
+		if (!SlotIsEmpty(slot)) {
+			order[numOfRecords++] = (slot->offset << 16) | i;
+		}
 	}
-	Slot **sortedDir = SortSlotDirectory(slotDir, 0, numOfSlots - 1); //Worst Case: O(n log n)
-	delete [] slotDir;
+	std::sort(order, order + numOfRecords);
 
 	int compressedOffset = HEAPPAGE_DATA_SIZE; //the beginning of the compressed data portion.
-	Slot *currentSlot; //current slot to shift right and compress
-	for (int i = 0; i <= numOfSlots - 1; i++) { //O(n)
-		currentSlot = sortedDir[i];
-		if (SlotIsEmpty(currentSlot)) {
-			continue; //slot does not need shifting.
-		}
-		if (currentSlot->offset + currentSlot->length != compressedOffset) {
-			memmove(&data[compressedOffset - currentSlot->length], &data[currentSlot->offset], currentSlot->length);
-			compressedOffset -= currentSlot->length;
+	for (int i = numOfRecords - 1; i >= 0; i--) {
+		Slot *slot = GetSlotAtIndex(order[i] & 0xFFFF);
+		compressedOffset -= slot->length;
+		if (slot->offset != compressedOffset) {
+			memmove(&data[compressedOffset], &data[slot->offset], slot->length);
+			slot->offset = compressedOffset;
 		}
 	}
 	freePtr = compressedOffset;
-	delete [] sortedDir;
 	return OK;
-	//TODO when can this fail? supposedly never.
 }
 
 //------------------------------------------------------------------
@@ -257,17 +241,9 @@ Status HeapPage::CompressPage() {
 //------------------------------------------------------------------
 Status HeapPage::InsertRecord(const char *recPtr, int length, RecordID& rid) {
 	// check if there are slots left
-	bool slotAvail = false;
 	Slot* slot;
-	int slotNum;
-	for (int i = 0; i < numOfSlots; i++) {
-		slot = GetSlotAtIndex(i);
-		if (SlotIsEmpty(slot)) {
-			slotAvail = true;
-			slotNum = i;
-			break;
-		}
-	}
+	int slotNum = freeSlot;
+	bool slotAvail = (slotNum != INVALID_SLOT);
 
 	// check for available space
 	int spaceNeeded = length;
@@ -287,7 +263,10 @@ Status HeapPage::InsertRecord(const char *recPtr, int length, RecordID& rid) {
 	memcpy(&data[freePtr-length], recPtr, length);
 
 	// insert slot
-	if (!slotAvail) {
+	if (slotAvail) {
+		PopFreeSlot();
+		slot = GetSlotAtIndex(slotNum);
+	} else {
 		slot = AppendNewSlot();
 		slotNum = numOfSlots-1;
 	}
@@ -339,16 +318,26 @@ Status HeapPage::DeleteRecord(RecordID rid) {
 	if (slot->offset == freePtr) { 
 		freePtr += slot->length;
 	}
-	SetSlotEmpty(slot);
 
-	/*Working backwards from the slot directory, remove all invalid slots*/
+	if (rid.slotNo != numOfSlots - 1) {
+		PushFreeSlot(rid.slotNo);
+		return OK;
+	}
+
+	/*The last slot was deleted. Working backwards from the slot directory, remove all invalid slots*/
+	SetSlotEmpty(slot);
+	int oldNumOfSlots = numOfSlots;
 	for (int i = numOfSlots - 1; i >= 0; i--) {
 		if (SlotIsEmpty(GetSlotAtIndex(i))) {
 			numOfSlots--;
-			freeSpace += sizeof(slot);
+			freeSpace += sizeof(Slot);
 		}
 		else break; //hit a valid slot, it is the new end of the directory.
 	}
+	if (oldNumOfSlots - numOfSlots > 1) {
+		// some of the dropped slots were chained.
+		RebuildFreeSlotList();
+	}
 	return OK;
 }
 
@@ -395,8 +384,8 @@ Status HeapPage::NextRecord (RecordID curRid, RecordID& nextRid) {
 		return DONE;
 	}
 
-	int next_slot_no = 0; //guaranteed to change after the for loop
-	short max_offset = 0;
+	int next_slot_no = INVALID_SLOT; //stays invalid if curRid is the last record
+	short max_offset = -1;
 	for (int i = 0; i< numOfSlots; i++) {
 		Slot* slot = GetSlotAtIndex(i);
 		if (slot->offset < curSlot->offset && slot->offset > max_offset && !SlotIsEmpty(slot)) {
@@ -405,6 +394,10 @@ Status HeapPage::NextRecord (RecordID curRid, RecordID& nextRid) {
 			next_slot_no = i;
 		}
 	}
+	// freePtr may point into a hole left by deletions, below the last record.
+	if (next_slot_no == INVALID_SLOT) {
+		return DONE;
+	}
 	nextRid.pageNo = pid;
 	nextRid.slotNo = next_slot_no;
 	return OK;
@@ -464,10 +457,8 @@ int HeapPage::AvailableSpace(void)
 {
 	//If there are no empty slots, return freeSpace - sizeof(slot), since the slot will be
 	//used for an upcoming record.
-	for (int i = 0; i < numOfSlots; i++) {
-		if (SlotIsEmpty(GetSlotAtIndex(i))) {
-			return freeSpace;
-		}
+	if (freeSlot != INVALID_SLOT) {
+		return freeSpace;
 	}
 	return (freeSpace - sizeof(Slot));
 }
@@ -0,0 +1,126 @@
+//*****************************************
+//  Benchmark for heap page slot reuse and compaction
+//****************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <time.h>
+
+#include "heappage.h"
+#include "heappagebench.h"
+
+using namespace std;
+
+// Delete/insert pairs per record size.
+static const int numOfOps = 1000000;
+
+// Records of each run are between half and one and a half times this size,
+// so that holes left by deletions rarely fit the next record exactly and
+// the page has to be compacted.
+static const int recLens[] = { 8, 32, 128, 400 };
+static const int numOfRecLens = sizeof(recLens) / sizeof(recLens[0]);
+
+HeapPageBench::HeapPageBench()
+{
+	victims = new int[numOfOps];
+	lengths = new short[numOfOps];
+}
+
+HeapPageBench::~HeapPageBench()
+{
+	delete [] victims;
+	delete [] lengths;
+}
+
+//-------------------------------------------------------------------
+// HeapPageBench::MakeWorkload
+//
+// Input   : recLen - the average record length.
+// Output  : None.
+// Purpose : Generate the random choices of the run up front so that
+//           only the page is timed.
+//-------------------------------------------------------------------
+void HeapPageBench::MakeWorkload(int recLen)
+{
+	srand(recLen);
+	for (int i = 0; i < numOfOps; i++)
+	{
+		victims[i] = (rand() % 32768) * 32768 + rand() % 32768;
+		lengths[i] = recLen / 2 + rand() % (recLen + 1);
+	}
+}
+
+//-------------------------------------------------------------------
+// HeapPageBench::TimeWorkload
+//
+// Input   : None.
+// Output  : avgNumOfRecords - the average number of records on the page.
+// Purpose : Fill a page, then repeatedly delete a random record and
+//           insert a new one. When the new record does not fit, more
+//           records are deleted until it does, so the page stays full.
+// Return  : Nanoseconds per delete/insert pair.
+//-------------------------------------------------------------------
+double HeapPageBench::TimeWorkload(double &avgNumOfRecords)
+{
+	char rec[HEAPPAGE_DATA_SIZE];
+	memset(rec, 'x', sizeof(rec));
+
+	HeapPage *page = new HeapPage();
+	page->Init(0);
+
+	// Record ids of the records on the page, in no particular order.
+	RecordID rids[HEAPPAGE_DATA_SIZE];
+	int numOfRecords = 0;
+	while (page->InsertRecord(rec, lengths[numOfRecords], rids[numOfRecords]) == OK)
+	{
+		numOfRecords++;
+	}
+
+	long totalNumOfRecords = 0;
+	clock_t start = clock();
+	for (int i = 0; i < numOfOps; i++)
+	{
+		int victim = victims[i] % numOfRecords;
+		do
+		{
+			page->DeleteRecord(rids[victim]);
+			rids[victim] = rids[--numOfRecords];
+			victim = numOfRecords > 0 ? victims[i] % numOfRecords : 0;
+		} while (numOfRecords > 0 && page->AvailableSpace() < lengths[i]);
+
+		page->InsertRecord(rec, lengths[i], rids[numOfRecords++]);
+		totalNumOfRecords += numOfRecords;
+	}
+	clock_t end = clock();
+
+	if (page->GetNumOfRecords() != numOfRecords)
+	{
+		cerr << "*** Heap page lost track of its records" << endl;
+	}
+
+	delete page;
+	avgNumOfRecords = (double)totalNumOfRecords / numOfOps;
+	return (double)(end - start) / CLOCKS_PER_SEC * 1e9 / numOfOps;
+}
+
+Status HeapPageBench::RunBenchmarks()
+{
+	cout << "\nRunning heap page benchmarks...\n" << endl;
+	cout << "  " << numOfOps << " delete/insert pairs per record size on a full page\n" << endl;
+	cout << "  record size   records/page   ns/pair" << endl;
+
+	for (int s = 0; s < numOfRecLens; s++)
+	{
+		MakeWorkload(recLens[s]);
+
+		double avgNumOfRecords;
+		double time = TimeWorkload(avgNumOfRecords);
+
+		printf("  %-12d  %-13.1f  %-10.1f\n", recLens[s], avgNumOfRecords, time);
+	}
+
+	cout << "\n...heap page benchmarks completed.\n" << endl;
+	return OK;
+}
@@ -4,6 +4,13 @@
 #include "heappagetest.h"
 #include "heapfiletest.h"
 #include "heappage.h"
+#include "pagetablebench.h"
+#include "heappagebench.h"
+#include "freespacemapbench.h"
+#include "heapfileloadbench.h"
+#include "scanbench.h"
+#include "parallelscanbench.h"
+#include "recordlookupbench.h"
 
 int MINIBASE_RESTART_FLAG = 0;
 
@@ -27,6 +34,30 @@ int main(int argc, char **argv)
 	HeapPageDriver hpd;
 	hpd.RunTests();
 
+	cout << "Please press any key to run benchmarks" << endl;
+	cin.get();
+
+	PageTableBench ptb;
+	ptb.RunBenchmarks();
+
+	HeapPageBench hpb;
+	hpb.RunBenchmarks();
+
+	FreeSpaceMapBench fsmb;
+	fsmb.RunBenchmarks();
+
+	HeapFileLoadBench hflb;
+	hflb.RunBenchmarks();
+
+	ScanBench sb;
+	sb.RunBenchmarks();
+
+	ParallelScanBench psb;
+	psb.RunBenchmarks();
+
+	RecordLookupBench rlb;
+	rlb.RunBenchmarks();
+
 	cin.get();
 	return(0);
 }
@@ -0,0 +1,173 @@
+#include <iostream>
+#include <assert.h>
+
+#include "pagetable.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------
+// PageTable::PageTable
+//
+// Input   : maxEntries - the most pages the table will hold at once.
+// Output  : None.
+// Purpose : Allocate an empty table large enough to hold maxEntries
+//           pages while staying at most half full.
+//-------------------------------------------------------------------
+PageTable::PageTable(int maxEntries)
+{
+	this->maxEntries = maxEntries;
+	capacity = 16;
+	shift = 28;
+	while (capacity < 2 * maxEntries)
+	{
+		capacity <<= 1;
+		shift--;
+	}
+	mask = capacity - 1;
+
+	pids = new PageID[capacity];
+	frameNos = new int[capacity];
+	EmptyIt();
+}
+
+//-------------------------------------------------------------------
+// PageTable::~PageTable
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Release the entry arrays.
+//-------------------------------------------------------------------
+PageTable::~PageTable()
+{
+	delete [] pids;
+	delete [] frameNos;
+}
+
+//-------------------------------------------------------------------
+// PageTable::Hash
+//
+// Input   : pid - a page id.
+// Output  : None.
+// Purpose : Spread page ids over the table. Page ids handed out by the
+//           space manager are mostly consecutive, so multiplicative
+//           hashing is used rather than a plain modulo.
+// Return  : The home entry of the page.
+//-------------------------------------------------------------------
+int PageTable::Hash(PageID pid)
+{
+	return (int)(((unsigned int)pid * 2654435769u) >> shift) & mask;
+}
+
+//-------------------------------------------------------------------
+// PageTable::FindEntry
+//
+// Input   : pid - a page id.
+// Output  : None.
+// Purpose : Probe from the home entry of pid until pid or a free entry
+//           is found.
+// Return  : The entry holding pid, or -1 if pid is not in the table.
+//-------------------------------------------------------------------
+int PageTable::FindEntry(PageID pid)
+{
+	int i = Hash(pid);
+	while (pids[i] != INVALID_PAGE)
+	{
+		if (pids[i] == pid)
+			return i;
+		i = (i + 1) & mask;
+	}
+	return -1;
+}
+
+//-------------------------------------------------------------------
+// PageTable::Insert
+//
+// Input   : pid     - the page that was read into a frame.
+//           frameNo - the frame holding it.
+// Output  : None.
+// Purpose : Record that pid is resident in frameNo. The page must not
+//           already be in the table, and the table must hold fewer than
+//           maxEntries pages.
+//-------------------------------------------------------------------
+void PageTable::Insert(PageID pid, int frameNo)
+{
+	assert(numOfEntries < maxEntries);
+	numOfEntries++;
+
+	int i = Hash(pid);
+	while (pids[i] != INVALID_PAGE)
+	{
+		i = (i + 1) & mask;
+	}
+	pids[i] = pid;
+	frameNos[i] = frameNo;
+}
+
+//-------------------------------------------------------------------
+// PageTable::Delete
+//
+// Input   : pid - the page being evicted or freed.
+// Output  : None.
+// Purpose : Remove pid from the table. Entries later in the same probe
+//           run are shifted back so that no tombstones are left behind
+//           and lookups never slow down as pages come and go.
+// Return  : OK if pid was in the table, FAIL otherwise.
+//-------------------------------------------------------------------
+Status PageTable::Delete(PageID pid)
+{
+	int hole = FindEntry(pid);
+	if (hole < 0)
+		return FAIL;
+
+	int i = hole;
+	while (true)
+	{
+		i = (i + 1) & mask;
+		if (pids[i] == INVALID_PAGE)
+			break;
+
+		// The entry at i may fill the hole only if its home entry does not
+		// lie cyclically within (hole, i].
+		int home = Hash(pids[i]);
+		bool stays = (hole <= i) ? (hole < home && home <= i) : (hole < home || home <= i);
+		if (!stays)
+		{
+			pids[hole] = pids[i];
+			frameNos[hole] = frameNos[i];
+			hole = i;
+		}
+	}
+	pids[hole] = INVALID_PAGE;
+	numOfEntries--;
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// PageTable::LookUp
+//
+// Input   : pid - a page id.
+// Output  : None.
+// Return  : The frame holding pid, or INVALID_FRAME if pid is not
+//           resident.
+//-------------------------------------------------------------------
+int PageTable::LookUp(PageID pid)
+{
+	int i = FindEntry(pid);
+	return (i < 0) ? INVALID_FRAME : frameNos[i];
+}
+
+//-------------------------------------------------------------------
+// PageTable::EmptyIt
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Remove every entry from the table.
+//-------------------------------------------------------------------
+void PageTable::EmptyIt()
+{
+	for (int i = 0; i < capacity; i++)
+	{
+		pids[i] = INVALID_PAGE;
+	}
+	numOfEntries = 0;
+}
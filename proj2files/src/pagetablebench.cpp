@@ -0,0 +1,158 @@
+//*****************************************
+//  Benchmark for the buffer manager page table
+//****************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <time.h>
+
+#include "hash.h"
+#include "pagetable.h"
+#include "pagetablebench.h"
+
+using namespace std;
+
+// Operations per workload. Every pool size runs the same number of
+// operations so the per-operation times can be compared directly.
+static const int numOfOps = 200000;
+
+// One request in ten asks for a page that is not resident.
+static const int missEvery = 10;
+
+static const int poolSizes[] = { 100, 1000, 10000, 100000 };
+static const int numOfPoolSizes = sizeof(poolSizes) / sizeof(poolSizes[0]);
+
+PageTableBench::PageTableBench()
+{
+	resident = NULL;
+	requests = new PageID[numOfOps];
+	victims = new int[numOfOps];
+}
+
+PageTableBench::~PageTableBench()
+{
+	delete [] resident;
+	delete [] requests;
+	delete [] victims;
+}
+
+//-------------------------------------------------------------------
+// PageTableBench::MakeWorkload
+//
+// Input   : numOfBuf - the number of frames in the simulated pool.
+// Output  : None.
+// Purpose : Fill the pool with scattered page ids and generate a request
+//           stream in which most requests hit a resident page and the
+//           rest bring in a new page, evicting a random frame. The stream
+//           is generated up front so that only the table is timed.
+//-------------------------------------------------------------------
+void PageTableBench::MakeWorkload(int numOfBuf)
+{
+	delete [] resident;
+	resident = new PageID[numOfBuf];
+
+	srand(numOfBuf);
+	for (int i = 0; i < numOfBuf; i++)
+	{
+		resident[i] = i * 7 + 1;
+	}
+
+	// Replay the evictions so that every hit names a page that is
+	// resident at that point of the run.
+	PageID *pool = new PageID[numOfBuf];
+	memcpy(pool, resident, numOfBuf * sizeof(PageID));
+	PageID nextNewPage = numOfBuf * 7 + 1;
+	for (int i = 0; i < numOfOps; i++)
+	{
+		int frameNo = ((rand() % 32768) * 32768 + rand() % 32768) % numOfBuf;
+		if (i % missEvery == 0)
+		{
+			requests[i] = nextNewPage;
+			victims[i] = frameNo;
+			pool[frameNo] = nextNewPage;
+			nextNewPage += 7;
+		}
+		else
+		{
+			requests[i] = pool[frameNo];
+			victims[i] = INVALID_FRAME;
+		}
+	}
+	delete [] pool;
+}
+
+//-------------------------------------------------------------------
+// PageTableBench::TimeWorkload
+//
+// Input   : table    - an empty table.
+//           numOfBuf - the number of frames in the simulated pool.
+// Output  : None.
+// Purpose : Replay the current workload the way BufMgr::PinPage uses its
+//           table: look the page up, and on a miss delete the victim's
+//           page and insert the new one.
+// Return  : Nanoseconds per operation.
+//-------------------------------------------------------------------
+template <class Table>
+double PageTableBench::TimeWorkload(Table &table, int numOfBuf)
+{
+	PageID *pool = new PageID[numOfBuf];
+	for (int i = 0; i < numOfBuf; i++)
+	{
+		pool[i] = resident[i];
+		table.Insert(resident[i], i);
+	}
+
+	long checksum = 0;
+	clock_t start = clock();
+	for (int i = 0; i < numOfOps; i++)
+	{
+		int frameNo = table.LookUp(requests[i]);
+		if (frameNo == INVALID_FRAME)
+		{
+			frameNo = victims[i];
+			table.Delete(pool[frameNo]);
+			table.Insert(requests[i], frameNo);
+			pool[frameNo] = requests[i];
+		}
+		checksum += frameNo;
+	}
+	clock_t end = clock();
+
+	if (checksum < 0)
+	{
+		cerr << "*** Page table returned an invalid frame" << endl;
+	}
+
+	table.EmptyIt();
+	delete [] pool;
+	return (double)(end - start) / CLOCKS_PER_SEC * 1e9 / numOfOps;
+}
+
+Status PageTableBench::RunBenchmarks()
+{
+	cout << "\nRunning page table benchmarks...\n" << endl;
+	cout << "  " << numOfOps << " lookups per pool size, 1 in " << missEvery
+		<< " misses and replaces a page\n" << endl;
+	cout << "  frames      HashTable (ns/op)   PageTable (ns/op)" << endl;
+
+	for (int s = 0; s < numOfPoolSizes; s++)
+	{
+		int numOfBuf = poolSizes[s];
+		MakeWorkload(numOfBuf);
+
+		HashTable *chained = new HashTable();
+		double chainedTime = TimeWorkload(*chained, numOfBuf);
+		delete chained;
+
+		PageTable *open = new PageTable(numOfBuf);
+		double openTime = TimeWorkload(*open, numOfBuf);
+		delete open;
+
+		printf("  %-10d  %-18.1f  %-18.1f\n", numOfBuf, chainedTime, openTime);
+	}
+
+	cout << "\n...page table benchmarks completed.\n" << endl;
+	return OK;
+}
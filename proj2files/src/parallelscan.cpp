@@ -0,0 +1,259 @@
+#include <iostream>
+#include <string.h>
+
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "dirpage.h"
+#include "parallelscan.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------
+// HeapFile::OpenParallelScan
+//
+// Input   : numOfWorkers - the number of threads that will read the file.
+// Output  : status - OK, or FAIL if the directory cannot be read.
+// Purpose : Open a scan that numOfWorkers threads can read at once.
+// Return  : The new scan, to be deleted by the caller.
+//-------------------------------------------------------------------
+ParallelScan *HeapFile::OpenParallelScan(int numOfWorkers, Status &status)
+{
+	return new ParallelScan(this, numOfWorkers, status);
+}
+
+//-------------------------------------------------------------------
+// ParallelScan::ParallelScan
+//
+// Input   : hf           - the file to scan.
+//           numOfWorkers - the number of workers, at least one.
+// Output  : status - OK, or FAIL if a directory page cannot be read.
+// Purpose : Collect the data pages that hold records from the
+//           directory and give each worker an equal range of them.
+//-------------------------------------------------------------------
+ParallelScan::ParallelScan(HeapFile *hf, int numOfWorkers, Status &status)
+{
+	if (numOfWorkers < 1)
+		numOfWorkers = 1;
+	this->numOfWorkers = numOfWorkers;
+
+	int capacity = 64;
+	pids = new PageID[capacity];
+	numOfPids = 0;
+
+	status = OK;
+	PageID dirPid = hf->GetFirstDirPage();
+	while (dirPid != INVALID_PAGE)
+	{
+		Page *page;
+		if (MINIBASE_BM->PinPage(dirPid, page) != OK)
+		{
+			cerr << "Cannot pin directory page " << dirPid << endl;
+			status = FAIL;
+			break;
+		}
+		DirPage *dirPage = (DirPage *)page;
+
+		PageInfoIterator iterator(dirPage);
+		PageInfo *info;
+		while ((info = iterator()) != NULL)
+		{
+			if (info->numOfRecords == 0)
+				continue;
+			if (numOfPids == capacity)
+			{
+				PageID *newPids = new PageID[capacity * 2];
+				memcpy(newPids, pids, numOfPids * sizeof(PageID));
+				delete [] pids;
+				pids = newPids;
+				capacity *= 2;
+			}
+			pids[numOfPids++] = info->pid;
+		}
+
+		PageID nextPid = dirPage->GetNextPage();
+		MINIBASE_BM->UnpinPage(dirPid);
+		dirPid = nextPid;
+	}
+	if (status != OK)
+		numOfPids = 0;
+
+	ranges = new Range[numOfWorkers];
+	cursors = new ScanCursor *[numOfWorkers];
+	for (int w = 0; w < numOfWorkers; w++)
+	{
+		ranges[w].begin = (int)((long long)numOfPids * w / numOfWorkers);
+		ranges[w].end = (int)((long long)numOfPids * (w + 1) / numOfWorkers);
+		cursors[w] = new ScanCursor(this, w);
+	}
+}
+
+//-------------------------------------------------------------------
+// ParallelScan::~ParallelScan
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Delete the cursors, unpinning the pages they still hold.
+//           No worker may be using its cursor.
+//-------------------------------------------------------------------
+ParallelScan::~ParallelScan()
+{
+	for (int w = 0; w < numOfWorkers; w++)
+	{
+		delete cursors[w];
+	}
+	delete [] cursors;
+	delete [] ranges;
+	delete [] pids;
+}
+
+int ParallelScan::GetNumOfWorkers()
+{
+	return numOfWorkers;
+}
+
+ScanCursor *ParallelScan::GetCursor(int worker)
+{
+	if (worker < 0 || worker >= numOfWorkers)
+		return NULL;
+	return cursors[worker];
+}
+
+//-------------------------------------------------------------------
+// ParallelScan::ClaimPage
+//
+// Input   : worker - the worker asking for a page.
+// Output  : pid - the page the worker is to read next.
+// Purpose : Take the first page of the worker's range. If the range is
+//           empty, look at the ranges of the other workers in turn and
+//           move the back half of the first one with pages left into
+//           the worker's range. Each range is latched on its own, and
+//           the victim's latch is released before the worker's range
+//           is updated, so no two latches are ever held together.
+// Return  : OK, or DONE if no worker has a page left.
+//-------------------------------------------------------------------
+Status ParallelScan::ClaimPage(int worker, PageID &pid)
+{
+	Range &own = ranges[worker];
+	{
+		lock_guard<mutex> guard(own.latch);
+		if (own.begin < own.end)
+		{
+			pid = pids[own.begin++];
+			return OK;
+		}
+	}
+
+	for (int i = 1; i < numOfWorkers; i++)
+	{
+		Range &victim = ranges[(worker + i) % numOfWorkers];
+		int begin, end;
+		{
+			lock_guard<mutex> guard(victim.latch);
+			int left = victim.end - victim.begin;
+			if (left == 0)
+				continue;
+			begin = victim.end - (left + 1) / 2;
+			end = victim.end;
+			victim.end = begin;
+		}
+
+		// Until this point the worker's range is empty, so no other worker
+		// steals from it in between.
+		lock_guard<mutex> guard(own.latch);
+		pid = pids[begin];
+		own.begin = begin + 1;
+		own.end = end;
+		return OK;
+	}
+	return DONE;
+}
+
+//-------------------------------------------------------------------
+// ParallelScan::SwapPages
+//
+// Input   : oldPid - the page a cursor is done with, or INVALID_PAGE.
+//           newPid - the page it reads next, or INVALID_PAGE.
+// Output  : newPage - the new page, pinned.
+// Purpose : Unpin the old page and pin the new one under a single
+//           acquisition of the buffer manager latch.
+// Return  : OK, or FAIL if the new page cannot be pinned.
+//-------------------------------------------------------------------
+Status ParallelScan::SwapPages(PageID oldPid, PageID newPid, Page *&newPage)
+{
+	lock_guard<mutex> guard(bmLatch);
+	if (oldPid != INVALID_PAGE)
+		MINIBASE_BM->UnpinPage(oldPid);
+	if (newPid == INVALID_PAGE)
+		return OK;
+	return MINIBASE_BM->PinPage(newPid, newPage);
+}
+
+ScanCursor::ScanCursor(ParallelScan *scan, int worker)
+{
+	this->scan = scan;
+	this->worker = worker;
+	pid = INVALID_PAGE;
+	page = NULL;
+	slotNo = 0;
+	numOfRecordsLeft = 0;
+}
+
+ScanCursor::~ScanCursor()
+{
+	Page *unused;
+	if (pid != INVALID_PAGE)
+		scan->SwapPages(pid, INVALID_PAGE, unused);
+}
+
+//-------------------------------------------------------------------
+// ScanCursor::GetNext
+//
+// Input   : recLen - the size of the buffer at recPtr.
+// Output  : rid    - the id of the record.
+//           recPtr - receives a copy of the record.
+//           recLen - the length of the record.
+// Purpose : Return the next record of the current page, moving to the
+//           next page claimed for the worker once every record of the
+//           page has been returned. Records come in slot order.
+// Return  : OK, DONE if the file is done, or FAIL. A record longer than
+//           the buffer is not copied, and FAIL is returned without
+//           moving past it.
+//-------------------------------------------------------------------
+Status ScanCursor::GetNext(RecordID &rid, char *recPtr, int &recLen)
+{
+	while (numOfRecordsLeft == 0)
+	{
+		PageID nextPid;
+		Page *nextPage;
+		if (scan->ClaimPage(worker, nextPid) != OK)
+			nextPid = INVALID_PAGE;
+
+		if (scan->SwapPages(pid, nextPid, nextPage) != OK)
+		{
+			cerr << "Cannot pin data page " << nextPid << endl;
+			pid = INVALID_PAGE;
+			return FAIL;
+		}
+		pid = nextPid;
+		if (pid == INVALID_PAGE)
+			return DONE;
+
+		page = (HeapPage *)nextPage;
+		slotNo = 0;
+		numOfRecordsLeft = page->GetNumOfRecords();
+	}
+
+	rid.pageNo = pid;
+	char *data;
+	int length;
+	for (rid.slotNo = slotNo; page->ReturnRecord(rid, data, length) != OK; rid.slotNo++)
+		;
+	if (length > recLen)
+		return FAIL;
+
+	memcpy(recPtr, data, length);
+	recLen = length;
+	slotNo = rid.slotNo + 1;
+	numOfRecordsLeft--;
+	return OK;
+}
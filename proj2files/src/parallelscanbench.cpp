@@ -0,0 +1,138 @@
+//*****************************************
+//  Benchmark for parallel heap file scans
+//****************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "db.h"
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "parallelscan.h"
+#include "benchutil.h"
+#include "parallelscanbench.h"
+
+using namespace std;
+
+static const int numOfRecords = 4000000;
+static const int numOfRuns = 3;
+static const int maxThreads = 16;
+
+// The whole file fits in the pool, so that the scans measure the work
+// done per record rather than the speed of the disk.
+static const int numOfDBPages = 60000;
+static const int numOfBufs = 50000;
+
+// Read every record through the cursor. Each record is checksummed in
+// full so that all of its bytes are touched.
+static void ScanWorker(ScanCursor *cursor, long long *sum)
+{
+	RecordID rid;
+	BenchRecord rec;
+	int len = sizeof(rec);
+	long long total = 0;
+	while (cursor->GetNext(rid, (char *)&rec, len) == OK)
+	{
+		len = sizeof(rec);
+		unsigned int hash = 0;
+		for (int i = 0; i < benchNameLen; i++)
+		{
+			hash = hash * 31 + rec.name[i];
+		}
+		total += rec.ival + (hash & 1);
+	}
+	*sum = total;
+}
+
+//-------------------------------------------------------------------
+// ParallelScanBench::TimeScan
+//
+// Input   : f            - the file to scan.
+//           numOfThreads - the number of threads sharing the scan.
+// Output  : sum - the sum over all threads of what they read.
+// Purpose : Open a parallel scan with one worker per thread and run
+//           every worker on its own thread. The time taken includes
+//           opening the scan and starting the threads.
+// Return  : The wall clock time taken in seconds.
+//-------------------------------------------------------------------
+double ParallelScanBench::TimeScan(HeapFile &f, int numOfThreads, long long &sum)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	Status status;
+	ParallelScan *scan = f.OpenParallelScan(numOfThreads, status);
+	vector<long long> sums(numOfThreads);
+	vector<thread> threads;
+	for (int t = 0; t < numOfThreads; t++)
+	{
+		threads.push_back(thread(ScanWorker, scan->GetCursor(t), &sums[t]));
+	}
+	sum = 0;
+	for (int t = 0; t < numOfThreads; t++)
+	{
+		threads[t].join();
+		sum += sums[t];
+	}
+	delete scan;
+
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+Status ParallelScanBench::RunBenchmarks()
+{
+	if (OpenBenchDB("PSCANBENCH", numOfDBPages, numOfBufs) != OK)
+		return FAIL;
+
+	cout << "\nRunning parallel heap file scan benchmarks...\n" << endl;
+
+	Status status;
+	HeapFile *f = new HeapFile("pscanbench", status);
+	if (status == OK)
+		status = LoadBenchFile(*f, numOfRecords, NULL);
+
+	if (status != OK)
+	{
+		cerr << "*** Could not load the benchmark file" << endl;
+	}
+	else
+	{
+		// Read the file into the pool once, and remember what a full scan
+		// adds up to.
+		long long expected;
+		TimeScan(*f, 1, expected);
+
+		cout << "  " << numOfRecords << " records of " << sizeof(BenchRecord) << " bytes, best of "
+			<< numOfRuns << " scans, " << thread::hardware_concurrency() << " hardware threads\n" << endl;
+		cout << "  threads   seconds   records/s      speedup" << endl;
+
+		double single = 0;
+		for (int numOfThreads = 1; numOfThreads <= maxThreads; numOfThreads *= 2)
+		{
+			double best = BestOf(numOfRuns, [&]() {
+				long long sum;
+				double time = TimeScan(*f, numOfThreads, sum);
+				if (sum != expected)
+				{
+					cerr << "*** Scan with " << numOfThreads << " threads returned wrong records" << endl;
+				}
+				return time;
+			});
+			if (numOfThreads == 1)
+				single = best;
+			printf("  %-8d  %-8.3f  %-12.0f   %.2f\n", numOfThreads, best, numOfRecords / best, single / best);
+		}
+	}
+
+	cout << "\n...parallel heap file scan benchmarks completed.\n" << endl;
+
+	f->DeleteFile();
+	delete f;
+	CloseBenchDB("PSCANBENCH");
+	return status;
+}
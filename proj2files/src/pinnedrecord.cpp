@@ -0,0 +1,70 @@
+#include <iostream>
+
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "heappage.h"
+#include "pinnedrecord.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------
+// HeapFile::GetRecord
+//
+// Input   : rid - the id of a record of this file.
+// Output  : record - holds the record, with its page pinned.
+// Purpose : Give access to a record without copying it. The page of
+//           the record is pinned straight from rid, without looking it
+//           up in the directory, so rid must have been returned by this
+//           file. A record already held by the handle is released first.
+// Return  : OK, or FAIL if there is no such record. The handle holds no
+//           record on failure.
+//-------------------------------------------------------------------
+Status HeapFile::GetRecord(const RecordID& rid, PinnedRecord& record)
+{
+	record.Release();
+	if (rid.pageNo == INVALID_PAGE)
+		return FAIL;
+
+	Page *page;
+	if (MINIBASE_BM->PinPage(rid.pageNo, page) != OK)
+	{
+		cerr << "Cannot pin page " << rid.pageNo << endl;
+		return FAIL;
+	}
+
+	char *recPtr;
+	int length;
+	if (((HeapPage *)page)->ReturnRecord(rid, recPtr, length) != OK)
+	{
+		MINIBASE_BM->UnpinPage(rid.pageNo);
+		return FAIL;
+	}
+
+	record.pid = rid.pageNo;
+	record.recPtr = recPtr;
+	record.length = length;
+	return OK;
+}
+
+PinnedRecord::PinnedRecord()
+{
+	pid = INVALID_PAGE;
+	recPtr = NULL;
+	length = 0;
+}
+
+PinnedRecord::~PinnedRecord()
+{
+	Release();
+}
+
+void PinnedRecord::Release()
+{
+	if (pid != INVALID_PAGE)
+	{
+		MINIBASE_BM->UnpinPage(pid);
+		pid = INVALID_PAGE;
+		recPtr = NULL;
+		length = 0;
+	}
+}
@@ -0,0 +1,136 @@
+//*****************************************
+//  Benchmark for heap file record lookups
+//****************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <time.h>
+
+#include "db.h"
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "pinnedrecord.h"
+#include "benchutil.h"
+#include "recordlookupbench.h"
+
+using namespace std;
+
+static const int numOfRecords = 500000;
+static const int numOfLookups = 2000000;
+
+// The whole file fits in the pool, as the pages an index leads to would
+// be in a hot workload.
+static const int numOfDBPages = 20000;
+static const int numOfBufs = 8000;
+
+//-------------------------------------------------------------------
+// RecordLookupBench::TimeLookups
+//
+// Input   : f      - the file to read.
+//           rids   - the records to look up, in order.
+//           n      - the number of lookups.
+//           usePin - whether to read through a PinnedRecord.
+// Output  : sum - the sum of the ival fields of the records looked up.
+// Purpose : Fetch each record the way an index lookup would, either
+//           copied into a buffer by HeapFile::GetRecord or in place
+//           through one PinnedRecord handle that is refilled each time.
+// Return  : The time taken in seconds.
+//-------------------------------------------------------------------
+double RecordLookupBench::TimeLookups(HeapFile &f, const RecordID *rids, int n, bool usePin, long long &sum)
+{
+	sum = 0;
+
+	clock_t start = clock();
+	if (usePin)
+	{
+		PinnedRecord record;
+		for (int i = 0; i < n; i++)
+		{
+			if (f.GetRecord(rids[i], record) != OK)
+			{
+				cerr << "*** Lookup of record " << i << " failed" << endl;
+				break;
+			}
+			sum += ((const BenchRecord *)record.GetData())->ival;
+		}
+	}
+	else
+	{
+		BenchRecord rec;
+		for (int i = 0; i < n; i++)
+		{
+			int len = sizeof(BenchRecord);
+			if (f.GetRecord(rids[i], (char *)&rec, len) != OK)
+			{
+				cerr << "*** Lookup of record " << i << " failed" << endl;
+				break;
+			}
+			sum += rec.ival;
+		}
+	}
+	clock_t end = clock();
+
+	return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+Status RecordLookupBench::RunBenchmarks()
+{
+	if (OpenBenchDB("LOOKUPBENCH", numOfDBPages, numOfBufs) != OK)
+		return FAIL;
+
+	cout << "\nRunning heap file record lookup benchmarks...\n" << endl;
+
+	Status status;
+	HeapFile *f = new HeapFile("lookupbench", status);
+	RecordID *rids = new RecordID[numOfRecords];
+	if (status == OK)
+		status = LoadBenchFile(*f, numOfRecords, rids);
+
+	if (status != OK)
+	{
+		cerr << "*** Could not load the benchmark file" << endl;
+	}
+	else
+	{
+		// Random record ids, as an unclustered index would return them.
+		RecordID *lookups = new RecordID[numOfLookups];
+		long long expected = 0;
+		srand(1);
+		for (int i = 0; i < numOfLookups; i++)
+		{
+			int r = (int)(((long long)rand() * (RAND_MAX + 1LL) + rand()) % numOfRecords);
+			lookups[i] = rids[r];
+			expected += r;
+		}
+
+		cout << "  " << numOfLookups << " random lookups in " << numOfRecords << " records of "
+			<< sizeof(BenchRecord) << " bytes\n" << endl;
+		cout << "  lookup                        seconds   lookups/s" << endl;
+
+		// The first pass also reads the file into the pool.
+		long long sum;
+		TimeLookups(*f, lookups, numOfLookups, false, sum);
+
+		for (int usePin = 0; usePin <= 1; usePin++)
+		{
+			double time = TimeLookups(*f, lookups, numOfLookups, usePin != 0, sum);
+			if (sum != expected)
+			{
+				cerr << "*** Lookups returned wrong records" << endl;
+			}
+			printf("  %-28s  %-8.2f  %-12.0f\n", usePin ? "GetRecord into PinnedRecord" : "GetRecord into a buffer",
+				time, numOfLookups / time);
+		}
+		delete [] lookups;
+	}
+	delete [] rids;
+
+	cout << "\n...heap file record lookup benchmarks completed.\n" << endl;
+
+	f->DeleteFile();
+	delete f;
+	CloseBenchDB("LOOKUPBENCH");
+	return status;
+}
@@ -0,0 +1,120 @@
+//*****************************************
+//  Benchmark for scanning heap files
+//****************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <time.h>
+
+#include "db.h"
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "scan.h"
+#include "batchscan.h"
+#include "benchutil.h"
+#include "scanbench.h"
+
+using namespace std;
+
+static const int numOfRecords = 2000000;
+static const int numOfRuns = 5;
+
+static const int numOfDBPages = 110000;
+static const int numOfBufs = 1000;
+
+//-------------------------------------------------------------------
+// ScanBench::TimeScan
+//
+// Input   : f        - the file to scan.
+//           useBatch - whether to scan with BatchScan.
+// Output  : sum - the sum of the ival fields of all records.
+// Purpose : Scan the file once. Scan::GetNext copies each record into
+//           a buffer; BatchScan reads it where it lies on the page.
+// Return  : The time taken in seconds.
+//-------------------------------------------------------------------
+double ScanBench::TimeScan(HeapFile &f, bool useBatch, long long &sum)
+{
+	Status status;
+	sum = 0;
+
+	clock_t start = clock();
+	if (useBatch)
+	{
+		BatchScan *scan = f.OpenBatchScan(status);
+		ScanRecord *records;
+		int n;
+		while (scan->GetNextBatch(records, n) == OK)
+		{
+			for (int i = 0; i < n; i++)
+			{
+				sum += ((BenchRecord *)records[i].recPtr)->ival;
+			}
+		}
+		delete scan;
+	}
+	else
+	{
+		Scan *scan = f.OpenScan(status);
+		RecordID rid;
+		BenchRecord rec;
+		int len = sizeof(rec);
+		while (scan->GetNext(rid, (char *)&rec, len) == OK)
+		{
+			sum += rec.ival;
+			len = sizeof(rec);
+		}
+		delete scan;
+	}
+	clock_t end = clock();
+
+	return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+Status ScanBench::RunBenchmarks()
+{
+	if (OpenBenchDB("SCANBENCH", numOfDBPages, numOfBufs) != OK)
+		return FAIL;
+
+	cout << "\nRunning heap file scan benchmarks...\n" << endl;
+
+	Status status;
+	HeapFile *f = new HeapFile("scanbench", status);
+	if (status == OK)
+		status = LoadBenchFile(*f, numOfRecords, NULL);
+	long long expected = (long long)numOfRecords * (numOfRecords - 1) / 2;
+
+	if (status != OK)
+	{
+		cerr << "*** Could not load the benchmark file" << endl;
+	}
+	else
+	{
+		cout << "  " << numOfRecords << " records of " << sizeof(BenchRecord) << " bytes, best of "
+			<< numOfRuns << " scans\n" << endl;
+		cout << "  scan                          seconds   records/s" << endl;
+
+		for (int useBatch = 0; useBatch <= 1; useBatch++)
+		{
+			double best = BestOf(numOfRuns, [&]() {
+				long long sum;
+				double time = TimeScan(*f, useBatch != 0, sum);
+				if (sum != expected)
+				{
+					cerr << "*** Scan returned wrong records" << endl;
+				}
+				return time;
+			});
+			printf("  %-28s  %-8.2f  %-12.0f\n", useBatch ? "BatchScan::GetNextBatch" : "Scan::GetNext",
+				best, numOfRecords / best);
+		}
+	}
+
+	cout << "\n...heap file scan benchmarks completed.\n" << endl;
+
+	f->DeleteFile();
+	delete f;
+	CloseBenchDB("SCANBENCH");
+	return status;
+}
@@ -5,11 +5,15 @@
 #include "BTreeFileScan.h"
 #include "BTreeTest.h"
 #include "BTreeInclude.h"
+#include "SortedKVStream.h"
 
 class BTreeFile
 {
 public:
 	friend class BTreeDriver;
+	friend class SortedKVPageBench;
+	friend class PrefixKeyBench;
+	friend class BulkLoadBench;
 
 	BTreeFile(Status &status, const char *filename);
 
@@ -19,6 +23,8 @@ public:
 
 	Status Insert(const char *key, const RecordID rid);
 
+	Status BulkLoad(SortedKVStream &input, double fillFactor = 0.9);
+
 	BTreeFileScan *OpenScan(const char *lowKey, const char *highKey);
 
 	Status PrintTree(PageID pageID, bool printContents);
@@ -32,8 +38,10 @@ private:
 	PageID GetLeftLeaf();
 
 	Status FreeTree(PageID root_pid);
-	void SplitIndex(IndexPage* newPage, IndexPage* oldPage, const char* newKey, PageID newValue, char*& newIndexKey, PageID& newIndexValue);
-	void SplitPage(LeafPage* newPage, LeafPage* oldPage, const char* newKey, RecordID newValue);
+	Status InsertInto(PageID pid, const char *key, const RecordID rid,
+					  bool &split, char *new_index_key, PageID &new_index_value);
+	void SplitIndex(IndexPage* newPage, IndexPage* oldPage, const char* newKey, PageID newValue, char* newIndexKey, PageID& newIndexValue);
+	void SplitPage(LeafPage* newPage, LeafPage* oldPage, const char* newKey, RecordID newValue, char* separator);
 
 	//Added variable: filename
 	char *fname;
@@ -8,10 +8,6 @@
 #define INDEX_PAGE 0
 #define LEAF_PAGE 1
 
-// This is likely unnecessary, but if you want a bound on path length,
-// this should suffice.
-#define MAX_TREE_DEPTH 4
-
 // Define index and leaf page types
 typedef SortedKVPage<PageID> IndexPage;
 typedef SortedKVPage<RecordID> LeafPage;
@@ -10,6 +10,7 @@ class BTreeDriver
 {
 public:
 	static void toString(const int n, char *str, int pad = BTREE_DEFAULT_PAD);
+	static void toLongString(const int n, char *str);
 
 	static bool InsertKey(BTreeFile *btf, int key,
 						  int ridOffset = BTREE_DEFAULT_RID_OFFSET,
@@ -39,6 +40,7 @@ public:
 	static bool TestNumLeafPages(BTreeFile *btf, int expected);
 	static bool TestScanCount(BTreeFileScan *scan, int expected);
 	static bool TestNumEntries(BTreeFile *btf, int expected);
+	static int TreeHeight(BTreeFile *btf);
 	
 	static bool SizeForKeyOnLeafPage(ResizableRecordPage *page,
 									 const char *key,
@@ -61,6 +63,8 @@ public:
 
 	static bool TestDeleteCurrent();
 
+	static bool TestDeepTree();
+
 	static bool TestDestroyFile();
 };
 
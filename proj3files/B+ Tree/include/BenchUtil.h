@@ -0,0 +1,23 @@
+#ifndef _BENCH_UTIL_H_
+#define _BENCH_UTIL_H_
+
+#include "minirel.h"
+
+// Helpers shared by the B+ tree and heap file benchmarks.
+
+// A random number in [0, n). rand() alone is too small on some platforms
+// to cover n.
+int RandomInt(int n);
+
+// Put the n values in a random order drawn with RandomInt, so that srand
+// fixes the order.
+void Shuffle(int *values, int n);
+
+// Create a scratch database <name>.DB, with its log, and the global buffer
+// pool. Prints an error and returns FAIL if it cannot be created.
+Status OpenBenchDB(const char *name, int numOfDBPages, int numOfBufs);
+
+// Tear down what OpenBenchDB set up and remove its files.
+void CloseBenchDB(const char *name);
+
+#endif
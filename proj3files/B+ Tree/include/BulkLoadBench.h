@@ -0,0 +1,31 @@
+#ifndef _BULK_LOAD_BENCH_H_
+#define _BULK_LOAD_BENCH_H_
+
+#include "minirel.h"
+
+class BTreeFile;
+
+// This is a driver class for timing how long it takes to build a large
+// index from sorted entries, with BTreeFile::BulkLoad at a few fill factors
+// and with one BTreeFile::Insert per entry.
+class BulkLoadBench
+{
+public:
+	Status RunBenchmarks();
+
+private:
+	// Build an index of numOfEntries keys, with BulkLoad if fillFactor is
+	// above 0 and with Insert otherwise, then print how long it took and
+	// the shape of the tree.
+	Status TimeBuild(double fillFactor);
+
+	enum { MAX_LEVELS = 16 };
+
+	int pagesPerLevel[MAX_LEVELS];
+	int height;
+
+	// Add the page and the subtree below it to pagesPerLevel.
+	Status CountPages(PageID pid, int level);
+};
+
+#endif
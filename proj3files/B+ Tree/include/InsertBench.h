@@ -0,0 +1,24 @@
+#ifndef _INSERT_BENCH_H_
+#define _INSERT_BENCH_H_
+
+#include "minirel.h"
+
+class BTreeFile;
+
+// This is a driver class for timing BTreeFile::Insert, in inserts per
+// second, on short keys in random and ascending order and on long keys that
+// grow the tree past four index levels.
+class InsertBench
+{
+public:
+	Status RunBenchmarks();
+
+private:
+	// Insert numOfKeys keys made by makeKey into a new index, in ascending
+	// order of their numbers or shuffled, then print the time taken and
+	// the height of the tree.
+	Status TimeInserts(const char *name, void (*makeKey)(int, char *),
+					   int numOfKeys, bool shuffle);
+};
+
+#endif
@@ -0,0 +1,454 @@
+#ifndef _INT_B_TREE_FILE_H_
+#define _INT_B_TREE_FILE_H_
+
+#include "BTreeheaderPage.h"
+#include "BTreeInclude.h"
+#include "IntKeyPage.h"
+#include "db.h"
+#include "bufmgr.h"
+#include "system_defs.h"
+
+template<typename KeyType> class IntBTreeFile;
+
+// A scan over a range of an IntBTreeFile, returned by
+// IntBTreeFile::OpenScan. It keeps the leaf it is on pinned until it moves
+// to the next leaf or is deleted.
+template<typename KeyType>
+class IntBTreeFileScan
+{
+public:
+	friend class IntBTreeFile<KeyType>;
+
+	typedef IntKeyPage<KeyType, RecordID> LeafPage;
+
+	//-------------------------------------------------------------------
+	// IntBTreeFileScan::GetNext
+	//
+	// Input   : None
+	// Output  : rid - record id of the scanned record.
+	//           key - its key.
+	// Return  : OK if successful, DONE if no more records to read
+	//           or if high key has been passed.
+	// Purpose : Return the next record from the B+-tree index.
+	//-------------------------------------------------------------------
+	Status GetNext(RecordID &rid, KeyType &key) {
+		// Empty leaves are skipped, since DeleteCurrent may leave some.
+		while (leaf != NULL && pos >= leaf->GetNumOfKeys()) {
+			AdvanceLeaf();
+		}
+		if (leaf == NULL) {
+			return DONE;
+		}
+
+		key = leaf->GetKey(pos);
+		if (hasHigh && high < key) {
+			return DONE;
+		}
+		rid = leaf->GetVal(pos);
+		pos++;
+		return OK;
+	}
+
+	//-------------------------------------------------------------------
+	// IntBTreeFileScan::DeleteCurrent
+	//
+	// Input   : None
+	// Output  : None
+	// Return  : OK, or FAIL if GetNext has not returned a record since
+	//           the last delete.
+	// Purpose : Delete the entry most recently returned by GetNext. As in
+	//           BTreeFileScan, the leaf is not merged or redistributed.
+	//-------------------------------------------------------------------
+	Status DeleteCurrent() {
+		if (leaf == NULL || pos == 0 || leaf->DeleteAt(pos - 1) != OK) {
+			return FAIL;
+		}
+		pos--;
+		isDirty = true;
+		return OK;
+	}
+
+	~IntBTreeFileScan() {
+		if (leaf != NULL) {
+			MINIBASE_BM->UnpinPage(leaf->PageNo(), isDirty);
+		}
+	}
+
+private:
+	IntBTreeFileScan() {
+		leaf = NULL;
+		pos = 0;
+		isDirty = false;
+		hasHigh = false;
+	}
+
+	/** Unpins the current leaf and pins the next one, if there is one. **/
+	void AdvanceLeaf() {
+		PageID nextPid = leaf->GetNextPage();
+		MINIBASE_BM->UnpinPage(leaf->PageNo(), isDirty);
+		leaf = NULL;
+		pos = 0;
+		isDirty = false;
+
+		Page *page;
+		if (nextPid != INVALID_PAGE && MINIBASE_BM->PinPage(nextPid, page) == OK) {
+			leaf = (LeafPage *)page;
+		}
+	}
+
+	LeafPage *leaf;			// The pinned leaf, NULL once the scan is done.
+	int pos;				// The position of the next pair on leaf.
+	bool isDirty;
+	bool hasHigh;
+	KeyType high;
+};
+
+// A B+ tree index over integer keys, such as int or long long, built from
+// IntKeyPage pages instead of SortedKVPage. It shares its file layout with
+// BTreeFile: a header page registered under the file name that holds the
+// root PageID. Keys are passed and compared by value, so nothing is
+// formatted into strings or compared with strcmp.
+//
+// Inserts descend recursively and pass splits back up on the way out, so
+// the tree has no depth limit.
+template<typename KeyType>
+class IntBTreeFile
+{
+public:
+	typedef IntKeyPage<KeyType, PageID> IntIndexPage;
+	typedef IntKeyPage<KeyType, RecordID> IntLeafPage;
+	typedef IntBTreeFileScan<KeyType> Scan;
+
+	//-------------------------------------------------------------------
+	// IntBTreeFile::IntBTreeFile
+	//
+	// Input   : filename - filename of an index.
+	// Output  : returnStatus - OK if successful, FAIL otherwise.
+	// Purpose : Open the index file if it exists, otherwise create it.
+	//           The header page stays pinned until the index is
+	//           destroyed or closed.
+	//-------------------------------------------------------------------
+	IntBTreeFile(Status &returnStatus, const char *filename) {
+		PageID headerPid;
+		Page *headerPage;
+
+		header = NULL;
+		fname = NULL;
+		returnStatus = FAIL;
+
+		if (MINIBASE_DB->GetFileEntry(filename, headerPid) == OK) {
+			if (MINIBASE_BM->PinPage(headerPid, headerPage) != OK) {
+				std::cerr << "Error pinning header page in IntBTreeFile Constructor." << std::endl;
+				return;
+			}
+			header = (BTreeHeaderPage *)headerPage;
+		}
+		else {
+			if (MINIBASE_BM->NewPage(headerPid, headerPage) != OK) {
+				std::cerr << "Error getting new header page in IntBTreeFile Constructor." << std::endl;
+				return;
+			}
+			if (MINIBASE_DB->AddFileEntry(filename, headerPid) != OK) {
+				std::cerr << "Error adding file entry in IntBTreeFile Constructor." << std::endl;
+				MINIBASE_BM->FreePage(headerPid);
+				return;
+			}
+			header = (BTreeHeaderPage *)headerPage;
+			header->Init(headerPid);
+		}
+
+		fname = new char[strlen(filename) + 1];
+		strcpy(fname, filename);
+		returnStatus = OK;
+	}
+
+	~IntBTreeFile() {
+		if (fname != NULL) {
+			delete [] fname;
+		}
+		if (header != NULL) {
+			MINIBASE_BM->UnpinPage(((HeapPage *)header)->PageNo(), DIRTY);
+		}
+	}
+
+	//-------------------------------------------------------------------
+	// IntBTreeFile::DestroyFile
+	//
+	// Input   : None
+	// Output  : None
+	// Return  : OK if successful, FAIL otherwise.
+	// Purpose : Free all pages and delete the entire index file.
+	//-------------------------------------------------------------------
+	Status DestroyFile() {
+		PageID rootPid = header->GetRootPageID();
+		if (rootPid != INVALID_PAGE && FreeTree(rootPid) != OK) {
+			return FAIL;
+		}
+
+		FREEPAGE(((HeapPage *)header)->PageNo());
+		header = NULL;
+		return MINIBASE_DB->DeleteFileEntry(fname);
+	}
+
+	//-------------------------------------------------------------------
+	// IntBTreeFile::Insert
+	//
+	// Input   : key - the key to insert.
+	//           rid - RecordID of the record to insert.
+	// Output  : None
+	// Return  : OK if successful, FAIL otherwise.
+	// Purpose : Insert an index entry with this rid and key. A key may be
+	//           inserted any number of times.
+	//-------------------------------------------------------------------
+	Status Insert(KeyType key, const RecordID rid) {
+		PageID rootPid = header->GetRootPageID();
+
+		if (rootPid == INVALID_PAGE) {
+			IntLeafPage *root;
+			NEWPAGE(rootPid, root);
+			root->Init(rootPid, LEAF_PAGE);
+			root->InsertAt(0, key, rid);
+			header->SetRootPageID(rootPid);
+			UNPIN(rootPid, DIRTY);
+			return OK;
+		}
+
+		bool split;
+		KeyType splitKey;
+		PageID splitPid;
+		if (InsertInto(rootPid, key, rid, split, splitKey, splitPid) != OK) {
+			return FAIL;
+		}
+
+		// The root split, so the tree grows a level.
+		if (split) {
+			PageID newRootPid;
+			IntIndexPage *newRoot;
+			NEWPAGE(newRootPid, newRoot);
+			newRoot->Init(newRootPid, INDEX_PAGE);
+			newRoot->SetPrevPage(rootPid);
+			newRoot->InsertAt(0, splitKey, splitPid);
+			header->SetRootPageID(newRootPid);
+			UNPIN(newRootPid, DIRTY);
+		}
+		return OK;
+	}
+
+	//-------------------------------------------------------------------
+	// IntBTreeFile::OpenScan
+	//
+	// Input   : lowKey, highKey - pointers to the bounds of the range to
+	//                             scan, or NULL for no bound, as for
+	//                             BTreeFile::OpenScan. Both bounds are
+	//                             included.
+	// Output  : None
+	// Return  : A new scan, which the caller deletes, or NULL if a page
+	//           could not be pinned.
+	// Purpose : Initialize a scan.
+	//-------------------------------------------------------------------
+	Scan *OpenScan(const KeyType *lowKey, const KeyType *highKey) {
+		Scan *scan = new Scan();
+		if (highKey != NULL) {
+			scan->hasHigh = true;
+			scan->high = *highKey;
+		}
+
+		PageID pid = header->GetRootPageID();
+		if (pid == INVALID_PAGE) {
+			return scan;
+		}
+
+		Page *page;
+		if (MINIBASE_BM->PinPage(pid, page) != OK) {
+			delete scan;
+			return NULL;
+		}
+
+		while (((IntIndexPage *)page)->GetType() == INDEX_PAGE) {
+			IntIndexPage *indexPage = (IntIndexPage *)page;
+			PageID child = (lowKey == NULL) ? indexPage->GetPrevPage() : ChildFor(indexPage, *lowKey);
+
+			MINIBASE_BM->UnpinPage(pid, CLEAN);
+			pid = child;
+			if (MINIBASE_BM->PinPage(pid, page) != OK) {
+				delete scan;
+				return NULL;
+			}
+		}
+
+		scan->leaf = (IntLeafPage *)page;
+		scan->pos = (lowKey == NULL) ? 0 : scan->leaf->LowerBound(*lowKey);
+		return scan;
+	}
+
+private:
+	BTreeHeaderPage *header;
+	char *fname;
+
+	//-------------------------------------------------------------------
+	// IntBTreeFile::ChildPosition
+	//
+	// Input   : page - an index page.
+	//           key  - a key.
+	// Output  : None
+	// Return  : The position of the child to descend to for key, 0 for
+	//           the prev page and i for the value of key i - 1.
+	// Note    : A leaf split between equal keys leaves copies of its
+	//           separator on both sides of it, so an equal separator
+	//           leads to the child on its left. Scans move right from
+	//           there to find the rest.
+	//-------------------------------------------------------------------
+	static int ChildPosition(IntIndexPage *page, KeyType key) {
+		return page->LowerBound(key);
+	}
+
+	static PageID ChildFor(IntIndexPage *page, KeyType key) {
+		int c = ChildPosition(page, key);
+		return (c == 0) ? page->GetPrevPage() : page->GetVal(c - 1);
+	}
+
+	//-------------------------------------------------------------------
+	// IntBTreeFile::InsertInto
+	//
+	// Input   : pid - the root of the subtree to insert into.
+	//           key, rid - the entry to insert.
+	// Output  : split - whether page pid was split.
+	//           splitKey, splitPid - if so, the separator and the new page
+	//                                to insert into the parent.
+	// Return  : OK if successful, FAIL otherwise.
+	// Purpose : Insert into the subtree, splitting full pages on the way
+	//           back up.
+	//-------------------------------------------------------------------
+	Status InsertInto(PageID pid, KeyType key, const RecordID rid,
+					  bool &split, KeyType &splitKey, PageID &splitPid) {
+		Page *page;
+		PIN(pid, page);
+		split = false;
+
+		if (((IntLeafPage *)page)->GetType() == LEAF_PAGE) {
+			IntLeafPage *leaf = (IntLeafPage *)page;
+			int pos = leaf->LowerBound(key);
+
+			if (!leaf->IsFull()) {
+				leaf->InsertAt(pos, key, rid);
+				UNPIN(pid, DIRTY);
+				return OK;
+			}
+
+			// Move the upper half to a new page to the right and link it
+			// into the leaf chain.
+			IntLeafPage *newLeaf;
+			NEWPAGE(splitPid, newLeaf);
+			newLeaf->Init(splitPid, LEAF_PAGE);
+
+			int mid = IntLeafPage::CAPACITY / 2;
+			leaf->MoveTo(newLeaf, mid);
+			if (pos <= mid) {
+				leaf->InsertAt(pos, key, rid);
+			}
+			else {
+				newLeaf->InsertAt(pos - mid, key, rid);
+			}
+
+			PageID nextPid = leaf->GetNextPage();
+			newLeaf->SetNextPage(nextPid);
+			newLeaf->SetPrevPage(pid);
+			leaf->SetNextPage(splitPid);
+			if (nextPid != INVALID_PAGE) {
+				IntLeafPage *nextLeaf;
+				PIN(nextPid, nextLeaf);
+				nextLeaf->SetPrevPage(splitPid);
+				UNPIN(nextPid, DIRTY);
+			}
+
+			split = true;
+			splitKey = newLeaf->GetKey(0);
+			UNPIN(splitPid, DIRTY);
+			UNPIN(pid, DIRTY);
+			return OK;
+		}
+
+		IntIndexPage *index = (IntIndexPage *)page;
+		int c = ChildPosition(index, key);
+		PageID child = (c == 0) ? index->GetPrevPage() : index->GetVal(c - 1);
+
+		// The page stays pinned while the subtree below it is changed, so
+		// that the separator from a child split can be added without
+		// pinning it again.
+		bool childSplit;
+		KeyType childKey;
+		PageID childPid;
+		if (InsertInto(child, key, rid, childSplit, childKey, childPid) != OK) {
+			MINIBASE_BM->UnpinPage(pid, CLEAN);
+			return FAIL;
+		}
+		if (!childSplit) {
+			UNPIN(pid, CLEAN);
+			return OK;
+		}
+
+		// The separator from the child goes in front of the key the
+		// search stopped at.
+		if (!index->IsFull()) {
+			index->InsertAt(c, childKey, childPid);
+			UNPIN(pid, DIRTY);
+			return OK;
+		}
+
+		// Split the index page around its middle key, which moves up to
+		// the parent, and whose child becomes the prev page of the new
+		// page.
+		IntIndexPage *newIndex;
+		NEWPAGE(splitPid, newIndex);
+		newIndex->Init(splitPid, INDEX_PAGE);
+
+		int mid = IntIndexPage::CAPACITY / 2;
+		splitKey = index->GetKey(mid);
+		newIndex->SetPrevPage(index->GetVal(mid));
+		index->MoveTo(newIndex, mid + 1);
+		index->DeleteAt(mid);
+
+		if (c <= mid) {
+			index->InsertAt(c, childKey, childPid);
+		}
+		else {
+			newIndex->InsertAt(c - mid - 1, childKey, childPid);
+		}
+
+		split = true;
+		UNPIN(splitPid, DIRTY);
+		UNPIN(pid, DIRTY);
+		return OK;
+	}
+
+	//-------------------------------------------------------------------
+	// IntBTreeFile::FreeTree
+	//
+	// Input   : pid - the root of a subtree.
+	// Output  : None
+	// Return  : OK if successful, FAIL otherwise.
+	// Purpose : Free every page of the subtree.
+	//-------------------------------------------------------------------
+	Status FreeTree(PageID pid) {
+		Page *page;
+		PIN(pid, page);
+
+		if (((IntIndexPage *)page)->GetType() == INDEX_PAGE) {
+			IntIndexPage *index = (IntIndexPage *)page;
+			if (FreeTree(index->GetPrevPage()) != OK) {
+				return FAIL;
+			}
+			for (int i = 0; i < index->GetNumOfKeys(); i++) {
+				if (FreeTree(index->GetVal(i)) != OK) {
+					return FAIL;
+				}
+			}
+		}
+
+		UNPIN(pid, CLEAN);
+		FREEPAGE(pid);
+		return OK;
+	}
+};
+
+#endif
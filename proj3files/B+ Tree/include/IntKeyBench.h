@@ -0,0 +1,34 @@
+#ifndef _INT_KEY_BENCH_H_
+#define _INT_KEY_BENCH_H_
+
+#include "minirel.h"
+
+// This is a driver class for timing inserts and point lookups of integer
+// keys in an IntBTreeFile, with 4 and 8 byte keys, against the same keys
+// formatted as strings in a BTreeFile.
+class IntKeyBench
+{
+public:
+	Status RunBenchmarks();
+
+private:
+	struct Timings
+	{
+		double insertTime;
+		double lookupTime;
+		int numOfMisses;
+	};
+
+	int *insertOrder;
+	int *lookupKeys;
+
+	// Build a BTreeFile from the keys formatted with "%08d", then look
+	// them up.
+	Status TimeStringTree(Timings &timings);
+
+	// Build an IntBTreeFile<KeyType> from the keys, then look them up.
+	template<typename KeyType>
+	Status TimeIntTree(Timings &timings);
+};
+
+#endif
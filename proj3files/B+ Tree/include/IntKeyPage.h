@@ -0,0 +1,187 @@
+#ifndef _INT_KEY_PAGE_
+#define _INT_KEY_PAGE_
+
+#include "minirel.h"
+#include "page.h"
+
+// A B+ tree page for fixed-width integer keys, such as int or long long.
+//
+// Unlike SortedKVPage there is no slot directory and no record per key: the
+// keys are kept sorted in one dense array and the values in a second array
+// at the same positions, so a search reads nothing but keys and compares
+// them as integers. A key that has several values is simply stored once per
+// value, next to each other.
+//
+// As on SortedKVPage, the prev page of an index page is the child holding
+// the keys smaller than the first key on the page, and the value of each
+// key is the child to its right.
+template<typename KeyType, typename ValType>
+class IntKeyPage
+{
+public:
+	enum {
+		HEADER_SIZE = 2 * sizeof(short) + 3 * sizeof(PageID),
+		CAPACITY = (MINIBASE_PAGESIZE - HEADER_SIZE) / (sizeof(KeyType) + sizeof(ValType))
+	};
+
+	//-------------------------------------------------------------------
+	// IntKeyPage::Init
+	//
+	// Input   : pid, the PageID of this page.
+	//           pageType, the type of this page
+	//                     -- whether it is index or leaf.
+	// Output  : None.
+	// Return  : None.
+	// Purpose : Initializes an empty page of the given type.
+	//-------------------------------------------------------------------
+	void Init(PageID pid, short pageType) {
+		type = pageType;
+		numOfKeys = 0;
+		this->pid = pid;
+		prevPage = INVALID_PAGE;
+		nextPage = INVALID_PAGE;
+	}
+
+	// Accessor methods.
+	short GetType() { return type; }
+	PageID PageNo() { return pid; }
+	PageID GetPrevPage() { return prevPage; }
+	PageID GetNextPage() { return nextPage; }
+	void SetPrevPage(PageID pageNo) { prevPage = pageNo; }
+	void SetNextPage(PageID pageNo) { nextPage = pageNo; }
+	int GetNumOfKeys() { return numOfKeys; }
+	bool IsEmpty() { return numOfKeys == 0; }
+	bool IsFull() { return numOfKeys == CAPACITY; }
+	KeyType GetKey(int i) { return keys[i]; }
+	ValType GetVal(int i) { return vals[i]; }
+
+	//-------------------------------------------------------------------
+	// IntKeyPage::LowerBound
+	//
+	// Input   : key, the key to search for.
+	// Output  : None.
+	// Return  : The position of the first key that is not smaller than
+	//           the search key, or the number of keys if every key is
+	//           smaller.
+	// Purpose : Binary search without branches on the comparisons. Each
+	//           step halves the range by moving its start or not, which
+	//           the compiler turns into a conditional move, so the search
+	//           does not stall on mispredicted branches.
+	//-------------------------------------------------------------------
+	int LowerBound(KeyType key) {
+		if (numOfKeys == 0) {
+			return 0;
+		}
+
+		const KeyType *base = keys;
+		int n = numOfKeys;
+
+		while (n > 1) {
+			int half = n / 2;
+			base = (base[half] < key) ? base + half : base;
+			n -= half;
+		}
+
+		return (int)(base - keys) + (*base < key);
+	}
+
+	//-------------------------------------------------------------------
+	// IntKeyPage::InsertAt
+	//
+	// Input   : pos, the position for the new key, which must keep the
+	//                keys sorted.
+	//           key, the key to insert.
+	//           val, the value to insert.
+	// Output  : None.
+	// Return  : OK   if the key-value pair was inserted.
+	//           FAIL if the page is full.
+	// Purpose : Inserts a key-value pair, shifting the following pairs
+	//           up one position.
+	//-------------------------------------------------------------------
+	Status InsertAt(int pos, KeyType key, ValType val) {
+		if (IsFull()) {
+			return FAIL;
+		}
+
+		assert(pos >= 0 && pos <= numOfKeys);
+		memmove(keys + pos + 1, keys + pos, (numOfKeys - pos) * sizeof(KeyType));
+		memmove(vals + pos + 1, vals + pos, (numOfKeys - pos) * sizeof(ValType));
+		keys[pos] = key;
+		vals[pos] = val;
+		numOfKeys++;
+		return OK;
+	}
+
+	//-------------------------------------------------------------------
+	// IntKeyPage::DeleteAt
+	//
+	// Input   : pos, the position of the key-value pair to delete.
+	// Output  : None.
+	// Return  : OK   if the key-value pair was deleted.
+	//           FAIL if there is no pair at pos.
+	// Purpose : Deletes a key-value pair, shifting the following pairs
+	//           down one position.
+	//-------------------------------------------------------------------
+	Status DeleteAt(int pos) {
+		if (pos < 0 || pos >= numOfKeys) {
+			return FAIL;
+		}
+
+		memmove(keys + pos, keys + pos + 1, (numOfKeys - pos - 1) * sizeof(KeyType));
+		memmove(vals + pos, vals + pos + 1, (numOfKeys - pos - 1) * sizeof(ValType));
+		numOfKeys--;
+		return OK;
+	}
+
+	//-------------------------------------------------------------------
+	// IntKeyPage::MoveTo
+	//
+	// Input   : from, the position of the first pair to move.
+	// Output  : dest, an empty page receiving the pairs.
+	// Return  : None.
+	// Purpose : Moves the pairs from position from on to dest, for
+	//           splitting this page.
+	//-------------------------------------------------------------------
+	void MoveTo(IntKeyPage *dest, int from) {
+		assert(dest->numOfKeys == 0 && from <= numOfKeys);
+		int n = numOfKeys - from;
+		memcpy(dest->keys, keys + from, n * sizeof(KeyType));
+		memcpy(dest->vals, vals + from, n * sizeof(ValType));
+		dest->numOfKeys = n;
+		numOfKeys = from;
+	}
+
+	//-------------------------------------------------------------------
+	// IntKeyPage::PrintPage
+	//
+	// Input   : printContents, Indicates whether pairs should be printed.
+	// Output  : None.
+	// Return  : None.
+	// Purpose : Prints metadata about this page and pairs if specified.
+	//-------------------------------------------------------------------
+	void PrintPage(bool printContents = true) {
+		std::cout << "page_id: " << pid << " type: "
+				  << (type == 0/*INDEX_PAGE*/ ? "INDEX_PAGE" : "LEAF_PAGE")
+				  << " prevPage: " << prevPage << " nextPage: " << nextPage
+				  << " numKeys: " << numOfKeys << std::endl;
+
+		if (!printContents) {
+			return;
+		}
+
+		for (int i = 0; i < numOfKeys; i++) {
+			std::cout << i << ": " << keys[i] << "[" << vals[i] << "]" << std::endl;
+		}
+	}
+
+private:
+	short type;
+	short numOfKeys;
+	PageID pid;
+	PageID prevPage;
+	PageID nextPage;
+	KeyType keys[CAPACITY];
+	ValType vals[CAPACITY];
+};
+
+#endif
@@ -3,6 +3,9 @@
 
 template<typename ValType> class SortedKVPage;
 
+// Room for any key, including its terminating '\0'. Keys handed to a page
+// are limited to MAX_KEY_LENGTH, which is defined after this header.
+const int KEY_BUFFER_SIZE = 200;
 
 template<typename ValType>
 class PageKVScan
@@ -14,7 +17,9 @@ public:
 	// PageKVScan::GetNext
 	//
 	// Input   : None.
-	// Output  : key, Pointer to current key.
+	// Output  : key, Pointer to current key. It points into the page if the
+	//                page stores the key in full, and into this scan
+	//                otherwise, so it is only valid until the scan moves.
 	//           val, Pointer to current value.
 	// Return  : OK   if successful.
 	//           DONE if there are no more key-value pairs on this page
@@ -68,7 +73,7 @@ public:
 		}
 
 		key = curKey;
-		val = GetVal(curKey, curValNum);
+		val = GetVal(curValNum);
 		return OK;
 	}
 
@@ -119,7 +124,7 @@ public:
 		}
 
 		key = curKey;
-		val = GetVal(curKey, curValNum);
+		val = GetVal(curValNum);
 		return OK;
 	}
 	
@@ -145,7 +150,7 @@ public:
 		}
 
 		char *keyToDelete = curKey;
-		ValType valToDelete = GetVal(curKey, curValNum);
+		ValType valToDelete = GetVal(curValNum);
 		
 		if (page->Delete(keyToDelete, valToDelete) == FAIL) {
 			return FAIL;
@@ -168,20 +173,16 @@ private:
 	RecordID curRid;
 	int curValNum, numValsWithKey;
 	char *curKey;
+	char *curVals;
 	bool curDeleted;
+	char keyBuf[KEY_BUFFER_SIZE];	// The current key, if the page stores only its suffix.
 
 	/* Private method that sets the iterator variables using rid.
 	 * Sets the iterator to the first value for the key if prev is
 	 * false or the last value for the key if prev is true.
 	 */
 	void setKey(RecordID rid, bool prev = false) {
-		int recLen;
-		page->ReturnRecord(rid, curKey, recLen);
-
-		int keyLength = strlen(curKey) + 1;
-
-		assert(((recLen - keyLength) % sizeof(ValType)) == 0);
-		numValsWithKey = (recLen - keyLength) / sizeof(ValType);
+		page->GetEntry(rid.slotNo, keyBuf, curKey, curVals, numValsWithKey);
 
 		if (prev) {
 			curValNum = numValsWithKey - 1;
@@ -205,8 +206,8 @@ private:
 		}
 	}
 	
-	ValType GetVal(char *key, int valNum) {
-		return *((ValType *)(curKey + strlen(key) + 1 + valNum * sizeof(ValType)));
+	ValType GetVal(int valNum) {
+		return *((ValType *)(curVals + valNum * sizeof(ValType)));
 	}
 };
 
@@ -0,0 +1,35 @@
+#ifndef _PREFIX_KEY_BENCH_H_
+#define _PREFIX_KEY_BENCH_H_
+
+#include "minirel.h"
+
+class BTreeFile;
+
+// This is a driver class for measuring a B+ tree built from keys with long
+// shared prefixes: its height, the fanout of each level, the space an entry
+// takes on a page against what it would take with the whole key stored,
+// and point lookup latency.
+class PrefixKeyBench
+{
+public:
+	Status RunBenchmarks();
+
+private:
+	struct LevelStats
+	{
+		int numOfPages;
+		int numOfEntries;
+		long long keyBytes;		// Length of the keys, without their '\0'.
+		long long usedBytes;	// Space used on the pages, slots included.
+	};
+
+	enum { MAX_LEVELS = 16 };
+
+	LevelStats levels[MAX_LEVELS];
+	int height;
+
+	// Add the page and the subtree below it to the statistics.
+	Status CollectStats(PageID pid, int level);
+};
+
+#endif
@@ -18,6 +18,12 @@ public:
 						 int length,
 						 const RecordID &rid);
 
+	// Replaces an existing record with one of a different length,
+	// keeping its record id.
+	Status ResizeRecord(const RecordID &rid,
+						const char *newData,
+						int newLength);
+
 	// Returns the mount of space available to append.
 	int AvailableSpaceForAppend() {
 		return freeSpace;
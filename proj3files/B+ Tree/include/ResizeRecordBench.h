@@ -0,0 +1,22 @@
+#ifndef _RESIZE_RECORD_BENCH_H_
+#define _RESIZE_RECORD_BENCH_H_
+
+#include "minirel.h"
+
+class HeapFile;
+
+// This is a driver class for timing an update-heavy heap file workload
+// whose records keep growing, updated by deleting and reinserting each
+// record against HeapFile::ResizeRecord.
+class ResizeRecordBench
+{
+public:
+	Status RunBenchmarks();
+
+private:
+	// Apply the same sequence of updates to a new file. Returns the time
+	// taken in seconds.
+	double TimeUpdates(bool useResize, int &numOfRidChanges, int &numOfFailures);
+};
+
+#endif
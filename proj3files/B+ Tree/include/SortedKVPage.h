@@ -4,10 +4,16 @@
 #include "ResizableRecordPage.h"
 #include "PageKVScan.h"
 
+// A page of keys in sorted order, each stored once with the list of its
+// values. The first and last key are stored in full. Every other key is
+// stored without the prefix that the first and last key have in common,
+// which all keys in between share.
 template<typename ValType>
 class SortedKVPage : public ResizableRecordPage
 {
 public:
+	// The most keys a page can hold, each with one value and its slot.
+	enum { MAX_KEYS = HEAPPAGE_DATA_SIZE / (sizeof(Slot) + 1 + sizeof(ValType)) + 1 };
 
 	//-------------------------------------------------------------------
 	// SortedKVPage::Init
@@ -124,8 +130,9 @@ public:
 	//-------------------------------------------------------------------
 	Status Insert(const char *key, ValType val) {
 		RecordID rid;
+		Status found = FindKey(key, rid);
 
-		if (FindKey(key, rid) == OK) {
+		if (found == OK) {
 			if (AvailableSpaceForAppend() < sizeof(ValType)) {
 				return FAIL;
 			}
@@ -133,16 +140,28 @@ public:
 			//RecordID rid;
 			return AppendToRecord((char *) &val, sizeof(ValType), rid);
 		} else {
-			int recSize = strlen(key) + 1 + sizeof(ValType);
+			// FindKey has found the largest key smaller than the new key, if
+			// there is one, and the new key goes right after it.
+			int i = (found == DONE) ? rid.slotNo + 1 : 0;
+
+			// A new first or last key changes which keys are stored in full
+			// and maybe the prefix, so the page is rewritten.
+			if (i == 0 || i == numOfSlots) {
+				return Rebuild(-1, key, &val, i, false);
+			}
+
+			// Otherwise only the suffix of the key is stored.
+			const char *suffix = key + PrefixLength();
+			int recSize = strlen(suffix) + 1 + sizeof(ValType);
 			
 			if (AvailableSpace() < recSize) {
 				return FAIL;
 			}
 
 			//Create record to pass into insert.
-			char recPtr[200];
-			memcpy(recPtr, key, strlen(key) + 1);
-			memcpy(recPtr + strlen(key) + 1, &val, sizeof(ValType));
+			char recPtr[KEY_BUFFER_SIZE + sizeof(ValType)];
+			memcpy(recPtr, suffix, strlen(suffix) + 1);
+			memcpy(recPtr + strlen(suffix) + 1, &val, sizeof(ValType));
 
 			RecordID rid2;
 
@@ -154,38 +173,26 @@ public:
 			//add it to the appropriate location based on the sort order.
 			assert(rid2.slotNo == numOfSlots - 1);
 
-			//Slot array of length 1 is trivially sorted.
-			if (numOfSlots == 1) {
-				return OK;
-			}
-
 			Slot *keySlot = GetFirstSlotPointer() - rid2.slotNo;
 			int keyOffset = keySlot->offset;
 			int keyLength = keySlot->length;
 
-			for (int i = 0; i < numOfSlots; i++) {
-				Slot *slot = GetFirstSlotPointer() - i;
-				char *keyInSlot = data + slot->offset;
-
-				// We've found the location at which to insert the new slot.
-				if (strcmp(key, keyInSlot) <= 0) {
+			Slot *slot = GetFirstSlotPointer() - i;
 
-					// Move this slot and all following slots down one position.
-					Slot *dest = GetFirstSlotPointer() - (numOfSlots - 1);
-					Slot *src = GetFirstSlotPointer() - (numOfSlots - 2);
+			// Move this slot and all following slots down one position.
+			Slot *dest = GetFirstSlotPointer() - (numOfSlots - 1);
+			Slot *src = GetFirstSlotPointer() - (numOfSlots - 2);
 
-					// Want to mv all slots, except the last slot and those
-					// preceding slot i.
-					int mvLength = (numOfSlots - 1 - i) * sizeof(Slot);
-					memmove(dest, src, mvLength);
+			// Want to mv all slots, except the last slot and those
+			// preceding slot i.
+			int mvLength = (numOfSlots - 1 - i) * sizeof(Slot);
+			memmove(dest, src, mvLength);
 
-					// Update slot at appropriate location.
-					slot->offset = keyOffset;
-					slot->length = keyLength;
+			// Update slot at appropriate location.
+			slot->offset = keyOffset;
+			slot->length = keyLength;
 
-					return OK;
-				}
-			}
+			return OK;
 		}
 
 		return FAIL;
@@ -212,19 +219,24 @@ public:
 
 		Slot *slot = GetFirstSlotPointer() - rid.slotNo;
 
-		int numVals = (slot->length - (strlen(key) + 1)) / sizeof(ValType);
-		ValType *valPtr = (ValType *)(data + slot->offset + strlen(key) + 1);
+		// The key may be stored without the page prefix.
+		int keyLength = strlen(data + slot->offset) + 1;
+		int numVals = (slot->length - keyLength) / sizeof(ValType);
+		ValType *valPtr = (ValType *)(data + slot->offset + keyLength);
 
 		// The value we are deleting is the only value for this key
 		// (on this page), so we delete the key as well.
 		if (numVals == 1) {
+			if (*valPtr != val) {
+				return FAIL;
+			}
 			return DeleteKey(key);
 		}
 
 		//Else iterate through values and cut the one that matches.
 		for (int i = 0; i < numVals; i++) {
 			if ((*valPtr) == val) {
-				return CutFromRecord(strlen(key) + 1 + i*sizeof(ValType), sizeof(ValType), rid);
+				return CutFromRecord(keyLength + i*sizeof(ValType), sizeof(ValType), rid);
 			}
 
 			valPtr += 1;
@@ -250,6 +262,12 @@ public:
 			return FAIL;
 		}
 
+		// Without the first or last key, its neighbour is stored in full
+		// and the prefix may grow, so the page is rewritten.
+		if (rid.slotNo == 0 || rid.slotNo == numOfSlots - 1) {
+			return Rebuild(rid.slotNo, NULL, NULL, -1, false);
+		}
+
 		if (HeapPage::DeleteRecord(rid) == FAIL) {
 			return FAIL;
 		}
@@ -384,14 +402,45 @@ public:
 	//-------------------------------------------------------------------
 	bool HasSpaceForValue(const char *key) {
 		RecordID rid;
+		Status found = FindKey(key, rid);
 
-		if (FindKey(key, rid) == OK) {
+		if (found == OK) {
 			return (AvailableSpaceForAppend() > sizeof(ValType));
+		}
+
+		int i = (found == DONE) ? rid.slotNo + 1 : 0;
+		if (i == 0 || i == numOfSlots) {
+			return (Rebuild(-1, key, NULL, i, true) == OK);
 		} else {
-			return (AvailableSpace() > (int)(strlen(key) + 1 + sizeof(ValType)));
+			return (AvailableSpace() > (int)(strlen(key + PrefixLength()) + 1 + sizeof(ValType)));
 		}
 	}
 
+	//-------------------------------------------------------------------
+	// SortedKVPage::SpaceNeeded
+	//
+	// Input   : firstKey, lastKey, The smallest and largest of some keys.
+	//           numOfKeys,      The number of keys.
+	//           totalKeyLength, The sum of their lengths, without '\0'.
+	//           numOfVals,      The number of values of all the keys.
+	// Output  : None.
+	// Return  : The space, slots included, that a page holding these keys
+	//           and values uses. They fit on one page if it is at most
+	//           HEAPPAGE_DATA_SIZE.
+	// Purpose : Lets a caller fill a page to a given size without trying
+	//           each insert, as for BTreeFile::BulkLoad.
+	//-------------------------------------------------------------------
+	static int SpaceNeeded(const char *firstKey, const char *lastKey, int numOfKeys,
+						   int totalKeyLength, int numOfVals) {
+		// The keys other than the first and last are stored without the
+		// prefix those two share.
+		int numOfSuffixes = (numOfKeys > 2) ? numOfKeys - 2 : 0;
+		int prefixLength = (numOfKeys >= 2) ? CommonPrefixLength(firstKey, lastKey) : 0;
+
+		return totalKeyLength - numOfSuffixes * prefixLength
+			   + numOfKeys * (1 + sizeof(Slot)) + numOfVals * sizeof(ValType);
+	}
+
 	//-------------------------------------------------------------------
 	// SortedKVPage::GetNumValuesForKey
 	//
@@ -418,6 +467,43 @@ public:
 
 
 
+	//-------------------------------------------------------------------
+	// SortedKVPage::GetEntry
+	//
+	// Input   : slotNo, The slot of a key.
+	//           keyBuf, Room for KEY_BUFFER_SIZE bytes.
+	// Output  : key,     The key. Points into the page if the page stores
+	//                    the key in full, and to keyBuf otherwise.
+	//           vals,    The array of values of the key.
+	//           numVals, The number of values.
+	// Return  : OK   if the slot holds a key.
+	//           FAIL otherwise.
+	// Purpose : Gets a key and its values by position.
+	//-------------------------------------------------------------------
+	Status GetEntry(int slotNo, char *keyBuf, char *&key, char *&vals, int &numVals) {
+		if (IsEmpty() || slotNo < 0 || slotNo >= numOfSlots) {
+			return FAIL;
+		}
+
+		Slot *slot = GetFirstSlotPointer() - slotNo;
+		char *stored = data + slot->offset;
+		int keyLength = strlen(stored) + 1;
+
+		if (IsStoredInFull(slotNo)) {
+			key = stored;
+		} else {
+			int prefixLength = PrefixLength();
+			memcpy(keyBuf, data + GetFirstSlotPointer()->offset, prefixLength);
+			strcpy(keyBuf + prefixLength, stored);
+			key = keyBuf;
+		}
+
+		assert(((slot->length - keyLength) % sizeof(ValType)) == 0);
+		vals = stored + keyLength;
+		numVals = (slot->length - keyLength) / sizeof(ValType);
+		return OK;
+	}
+
 	//-------------------------------------------------------------------
 	// SortedKVPage::OpenScan
 	//
@@ -502,28 +588,238 @@ private:
 
 		rid.pageNo = pid;
 
-		for (int i = 0; i < numOfSlots; i++) {
-			assert(!SlotIsEmpty(GetFirstSlotPointer() - i));
+		bool equal;
+		int i = LowerBound(key, equal);
 
-			Slot *slot = GetFirstSlotPointer() - i;
+		// We find the key directly.
+		if (equal) {
+			rid.slotNo = i;
+			return OK;
+		}
 
-			const char *str = data + slot->offset;
-			
-			// We find the key directly.
-			if (strcmp(str, key) == 0) {
-				rid.slotNo = i;
-				return OK;
+		// Otherwise rid points to the largest key smaller than the search key.
+		rid.slotNo = i - 1;
+		return DONE;
+	}
+
+	//-------------------------------------------------------------------
+	// SortedKVPage::LowerBound
+	//
+	// Input   : key, the key to search for. The page must not be empty.
+	// Output  : equal, whether the returned slot holds the search key.
+	// Return  : The first slot whose key is not smaller than the search
+	//           key, or numOfSlots if every key is smaller.
+	// Purpose : Binary search over the sorted slot directory, so that a
+	//           search costs O(log n) key comparisons rather than O(n).
+	//           The page prefix is compared once, then only suffixes.
+	//-------------------------------------------------------------------
+	int LowerBound(const char *key, bool &equal) {
+		int prefixLength = PrefixLength();
+		int cmp = strncmp(key, data + GetFirstSlotPointer()->offset, prefixLength);
+
+		// Every key on the page starts with the prefix.
+		equal = false;
+		if (cmp != 0) {
+			return (cmp < 0) ? 0 : numOfSlots;
+		}
+
+		const char *suffix = key + prefixLength;
+		int low = 0;
+		int high = numOfSlots;
+
+		while (low < high) {
+			int mid = (low + high) / 2;
+			Slot *slot = GetFirstSlotPointer() - mid;
+			assert(!SlotIsEmpty(slot));
+
+			const char *stored = data + slot->offset;
+			if (IsStoredInFull(mid)) {
+				stored += prefixLength;
 			}
-			// When we see a key larger than the search key, then we set
-			// rid to point to previous key and return DONE.
-			else if (strcmp(str, key) > 0) {
-				rid.slotNo = i - 1;
-				return DONE;
+
+			cmp = strcmp(stored, suffix);
+			if (cmp < 0) {
+				low = mid + 1;
+			} else {
+				high = mid;
+				equal = (cmp == 0);
 			}
 		}
 
-		rid.slotNo = numOfSlots - 1;
-		return DONE;
+		return low;
+	}
+
+	//-------------------------------------------------------------------
+	// SortedKVPage::IsStoredInFull
+	//
+	// Input   : slotNo, The slot of a key.
+	// Output  : None.
+	// Return  : true  if the key is the first or last on the page, which
+	//                 are stored with the prefix.
+	//           false if only its suffix is stored.
+	//-------------------------------------------------------------------
+	bool IsStoredInFull(int slotNo) {
+		return (slotNo == 0 || slotNo == numOfSlots - 1);
+	}
+
+	//-------------------------------------------------------------------
+	// SortedKVPage::PrefixLength
+	//
+	// Input   : None.
+	// Output  : None.
+	// Return  : The length of the prefix shared by every key on the page,
+	//           taken from the first and last key. 0 if there are fewer
+	//           than two keys.
+	//-------------------------------------------------------------------
+	int PrefixLength() {
+		if (numOfSlots < 2) {
+			return 0;
+		}
+
+		const char *first = data + GetFirstSlotPointer()->offset;
+		const char *last = data + (GetFirstSlotPointer() - (numOfSlots - 1))->offset;
+		return CommonPrefixLength(first, last);
+	}
+
+	//-------------------------------------------------------------------
+	// SortedKVPage::CommonPrefixLength
+	//
+	// Input   : a, b, Two keys.
+	// Output  : None.
+	// Return  : The number of leading bytes a and b have in common.
+	//-------------------------------------------------------------------
+	static int CommonPrefixLength(const char *a, const char *b) {
+		int length = 0;
+		while (a[length] != '\0' && a[length] == b[length]) {
+			length++;
+		}
+		return length;
+	}
+
+	//-------------------------------------------------------------------
+	// SortedKVPage::CopyKeyTail
+	//
+	// Input   : prefix, prefixLength, The part of a key held elsewhere.
+	//           suffix, The rest of the key.
+	//           from,   The first byte of the key to copy.
+	// Output  : dest, The key from byte from on, with its '\0'.
+	// Return  : None.
+	//-------------------------------------------------------------------
+	static void CopyKeyTail(char *dest, const char *prefix, int prefixLength, const char *suffix, int from) {
+		if (from < prefixLength) {
+			memcpy(dest, prefix + from, prefixLength - from);
+			dest += prefixLength - from;
+			from = 0;
+		} else {
+			from -= prefixLength;
+		}
+		strcpy(dest, suffix + from);
+	}
+
+	//-------------------------------------------------------------------
+	// SortedKVPage::Rebuild
+	//
+	// Input   : dropSlot, The slot of a key to leave out, or -1.
+	//           newKey,   A key to add with a single value, or NULL.
+	//           newVal,   The value of newKey. Unused if dryRun.
+	//           newPos,   The slot newKey goes in front of.
+	//           dryRun,   Whether to only check that the result fits.
+	// Output  : None.
+	// Return  : OK   if the page was rewritten, or would fit if dryRun.
+	//           FAIL if the result does not fit. The page is unchanged.
+	// Purpose : Rewrites the page for a new first or last key, storing
+	//           those two keys in full and the others without their new
+	//           common prefix.
+	//-------------------------------------------------------------------
+	Status Rebuild(int dropSlot, const char *newKey, const ValType *newVal, int newPos, bool dryRun) {
+		const char *keys[MAX_KEYS];		// Each key as stored, or newKey.
+		bool isSuffix[MAX_KEYS];		// Whether the key lacks the old prefix.
+		const char *vals[MAX_KEYS];
+		int valsLength[MAX_KEYS];
+
+		int numOfOldKeys = IsEmpty() ? 0 : numOfSlots;
+		int oldPrefixLength = PrefixLength();
+
+		// The records are read from a copy, as they are rewritten in place.
+		char oldData[HEAPPAGE_DATA_SIZE];
+		memcpy(oldData, data, HEAPPAGE_DATA_SIZE);
+		Slot *oldSlots = (Slot *)(oldData + HEAPPAGE_DATA_SIZE - sizeof(Slot));
+		const char *oldPrefix = oldData + oldSlots->offset;
+
+		if (newKey >= data && newKey < data + HEAPPAGE_DATA_SIZE) {
+			newKey = oldData + (newKey - data);
+		}
+
+		int numOfKeys = 0;
+		for (int i = 0; i <= numOfOldKeys; i++) {
+			if (newKey != NULL && i == newPos) {
+				keys[numOfKeys] = newKey;
+				isSuffix[numOfKeys] = false;
+				vals[numOfKeys] = (const char *)newVal;
+				valsLength[numOfKeys] = sizeof(ValType);
+				numOfKeys++;
+			}
+			if (i == numOfOldKeys) {
+				break;
+			}
+			if (i == dropSlot) {
+				continue;
+			}
+
+			Slot *slot = oldSlots - i;
+			const char *stored = oldData + slot->offset;
+			int keyLength = strlen(stored) + 1;
+			keys[numOfKeys] = stored;
+			isSuffix[numOfKeys] = !(i == 0 || i == numOfOldKeys - 1);
+			vals[numOfKeys] = stored + keyLength;
+			valsLength[numOfKeys] = slot->length - keyLength;
+			numOfKeys++;
+		}
+
+		// The new prefix is the one shared by the new first and last key.
+		int prefixLength = 0;
+		if (numOfKeys >= 2) {
+			char first[KEY_BUFFER_SIZE];
+			char last[KEY_BUFFER_SIZE];
+			int n = numOfKeys - 1;
+			CopyKeyTail(first, oldPrefix, isSuffix[0] ? oldPrefixLength : 0, keys[0], 0);
+			CopyKeyTail(last, oldPrefix, isSuffix[n] ? oldPrefixLength : 0, keys[n], 0);
+			prefixLength = CommonPrefixLength(first, last);
+		}
+
+		int totalLength = 0;
+		for (int i = 0; i < numOfKeys; i++) {
+			int keyLength = strlen(keys[i]) + (isSuffix[i] ? oldPrefixLength : 0);
+			if (i != 0 && i != numOfKeys - 1) {
+				keyLength -= prefixLength;
+			}
+			totalLength += keyLength + 1 + valsLength[i] + sizeof(Slot);
+		}
+
+		if (totalLength > HEAPPAGE_DATA_SIZE) {
+			return FAIL;
+		}
+		if (dryRun) {
+			return OK;
+		}
+
+		DeleteAll();
+		for (int i = 0; i < numOfKeys; i++) {
+			char rec[HEAPPAGE_DATA_SIZE];
+			int from = (i != 0 && i != numOfKeys - 1) ? prefixLength : 0;
+			CopyKeyTail(rec, oldPrefix, isSuffix[i] ? oldPrefixLength : 0, keys[i], from);
+
+			int keyLength = strlen(rec) + 1;
+			memcpy(rec + keyLength, vals[i], valsLength[i]);
+
+			RecordID rid;
+			if (HeapPage::InsertRecord(rec, keyLength + valsLength[i], rid) != OK) {
+				return FAIL;
+			}
+			assert(rid.slotNo == i);
+		}
+
+		return OK;
 	}
 
 	//-------------------------------------------------------------------
@@ -566,13 +862,16 @@ private:
 		assert(!SlotIsEmpty(slot));
 
 		// Print the key
-		char *start = data + slot->offset;
-		std::cout << start << "[";
+		char keyBuf[KEY_BUFFER_SIZE];
+		char *key;
+		char *vals;
+		int numVals;
+		GetEntry(slotNo, keyBuf, key, vals, numVals);
+		std::cout << key << "[";
 
 		// Print the array of values. Note that this assume that ValType
 		// can be printed with cout
-		ValType *valArray = (ValType *)(start + strlen(start) + 1);
-		int numVals = (slot->length - strlen(start) - 1) / sizeof(ValType);
+		ValType *valArray = (ValType *)vals;
 
 		for (int j = 0; j < numVals; j++) {
 			std::cout << *(valArray + j);
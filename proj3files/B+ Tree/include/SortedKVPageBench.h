@@ -0,0 +1,26 @@
+#ifndef _SORTED_KV_PAGE_BENCH_H_
+#define _SORTED_KV_PAGE_BENCH_H_
+
+#include "minirel.h"
+
+class BTreeFile;
+
+// This is a driver class for timing key lookups in a single sorted page
+// and in a large B+ tree, comparing the binary search done by
+// SortedKVPage::Search against a linear walk of the same page.
+class SortedKVPageBench
+{
+public:
+	Status RunBenchmarks();
+
+private:
+	// Look up keys in one full leaf page. Returns the time taken in seconds.
+	double TimePageLookups(bool useSearch, int &numOfKeys);
+
+	// Look up numOfLookups random keys in the tree, descending from the root
+	// with either SortedKVPage::Search or a linear walk of each page, or with
+	// BTreeFile::OpenScan. Returns the time taken in seconds.
+	double TimeTreeLookups(BTreeFile *btf, int how, int &numOfMisses);
+};
+
+#endif
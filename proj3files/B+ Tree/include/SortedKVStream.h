@@ -0,0 +1,19 @@
+#ifndef _SORTED_KV_STREAM_H_
+#define _SORTED_KV_STREAM_H_
+
+#include "minirel.h"
+
+// A source of (key, RecordID) pairs in ascending key order, such as a scan
+// of a file written by Sort, for BTreeFile::BulkLoad. Pairs with equal keys
+// come one after another.
+class SortedKVStream
+{
+public:
+	virtual ~SortedKVStream() {}
+
+	// Retrieves the next pair. Returns OK, or DONE once there are no more
+	// pairs. The key only needs to stay valid until the next call.
+	virtual Status GetNext(RecordID &rid, char *&keyPtr) = 0;
+};
+
+#endif
@@ -30,6 +30,9 @@ private :
 		return dirPid;
 	}
 
+	// Set the free space of a page in its directory entry.
+	Status UpdatePageInfo(PageID pid, HeapPage *page);
+
 
 public:
 
@@ -41,6 +44,12 @@ public:
 	Status DeleteRecord(const RecordID &rid);
 	Status UpdateRecord(const RecordID &rid, char *recPtr, int recLen);
 	Status GetRecord(const RecordID &rid, char *recPtr, int &recLen);
+
+	// Variable-length updates that keep the record id, see heapfile_update.cpp.
+	Status ResizeRecord(const RecordID &rid, const char *recPtr, int recLen);
+	Status FetchRecord(const RecordID &rid, char *recPtr, int &recLen);
+	Status RemoveRecord(const RecordID &rid);
+
 	class Scan *OpenScan(Status &status);
 
 	Status DeleteFile();
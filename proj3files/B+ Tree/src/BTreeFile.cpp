@@ -4,6 +4,8 @@
 #include "bufmgr.h"
 #include "system_defs.h"
 
+#include <vector>
+
 
 //-------------------------------------------------------------------
 // BTreeFile::BTreeFile
@@ -149,11 +151,19 @@ Status BTreeFile::FreeTree(PageID root_pid) {
 // Input   : key - pointer to the value of the key to be inserted.
 //           rid - RecordID of the record to be inserted.
 // Output  : None
-// Return  : OK if successful, FAIL otherwise.
+// Return  : OK if successful, FAIL otherwise, including when the key
+//           does not fit in MAX_KEY_LENGTH bytes.
 // Purpose : Insert an index entry with this rid and key.
-// Note    : If the root didn't exist, create it.
+// Note    : If the root didn't exist, create it. If the root splits,
+//           a new root is created above it, so the tree can grow to
+//           any depth.
 //-------------------------------------------------------------------
 Status BTreeFile::Insert(const char *key, const RecordID rid) {
+	if (strlen(key) >= MAX_KEY_LENGTH) {
+		std::cerr << "Insert key " << key << " is too long." << std::endl;
+		return FAIL;
+	}
+
 	PageID root_pid = header->GetRootPageID();
 	Page* root_pg;
 
@@ -178,194 +188,480 @@ Status BTreeFile::Insert(const char *key, const RecordID rid) {
 		//Write the new record onto disk and unpin the page
 		return MINIBASE_BM->UnpinPage(root_pid, DIRTY);
 	}
+
 	/**CASE: B+ Tree has a Root Node**/
-	else {
-		if (MINIBASE_BM->PinPage(root_pid, root_pg) != OK) {
-			std::cerr << "Error pinning root page in Insert." << std::endl;
-			return FAIL; //cannot pin root page
-		}
+	bool split;
+	char new_index_key[MAX_KEY_LENGTH];
+	PageID new_index_value;
+	if (InsertInto(root_pid, key, rid, split, new_index_key, new_index_value) != OK) {
+		return FAIL;
+	}
 
-		/**Traverse from the root page until you get the leaf page associated
-		  *with this key*/
-		LeafPage *leaf_pg;
-		IndexPage *index_pg;
-		PageKVScan<PageID> possiblePages;
-		Page *current_pg = root_pg;
-		PageID* traversed_pages = new PageID [MAX_TREE_DEPTH];
-		
-		int tree_depth = 0;
-		while (((ResizableRecordPage *) current_pg)->GetType() == INDEX_PAGE) {
-			index_pg = (IndexPage *)current_pg;
-			traversed_pages[tree_depth] = index_pg->PageNo();
-			tree_depth++;
-			
-			Status searchResult = index_pg->Search(key, possiblePages);
-
-			PageID next_search_pg;
-			char *key_ptr;
-			if (searchResult == DONE || searchResult == OK) {
-				possiblePages.GetNext(key_ptr, next_search_pg);
-			} else {
-				// there is no key smaller than the search key, go to pointer0
-				next_search_pg = index_pg->GetPrevPage();
-			}
-			
-			if (MINIBASE_BM->UnpinPage(index_pg->PageNo(), CLEAN) != OK) {
-				std::cerr << "Error unpinning page " << index_pg->PageNo() << std::endl;
-				delete [] traversed_pages;
-				return FAIL;
-			}
-			if (MINIBASE_BM->PinPage(next_search_pg, (Page *&) current_pg) != OK) {
-				std::cerr << "Error pinning page " << next_search_pg << std::endl;
-				delete [] traversed_pages;
-				return FAIL;
-			}
+	if (split) {
+		// the root was split, need to create new index root above it
+		IndexPage* new_root_pg;
+		PageID new_root_pid;
+		if (MINIBASE_BM->NewPage(new_root_pid, (Page*&)new_root_pg) != OK) {
+			std::cerr << "Error allocating new index page " << new_root_pid << std::endl;
+			return FAIL;
+		}
+		new_root_pg->Init(new_root_pid, INDEX_PAGE);
+		new_root_pg->Insert(new_index_key, new_index_value);
+		new_root_pg->SetPrevPage(root_pid);
+		header->SetRootPageID(new_root_pid);
+		if (MINIBASE_BM->UnpinPage(new_root_pid, DIRTY) != OK) {
+			std::cerr << "Error unpinning page " << new_root_pid << std::endl;
+			return FAIL;
 		}
+	}
+	return OK;
+}
 
-		// at leaf level
-		leaf_pg = (LeafPage *)current_pg;
+
+//-------------------------------------------------------------------
+// BTreeFile::InsertInto
+//
+// Input   : pid - the root of the subtree to insert into.
+//           key - pointer to the value of the key to be inserted.
+//           rid - RecordID of the record to be inserted.
+// Output  : split - whether page pid was split.
+//           new_index_key - if so, the key to insert into the parent,
+//                           in a buffer of MAX_KEY_LENGTH bytes.
+//           new_index_value - and the new page to insert with it.
+// Return  : OK if successful, FAIL otherwise.
+// Purpose : Insert into a subtree, splitting full pages on the way back
+//           up. The path from the root is held by the call stack, one
+//           frame per level, so there is no bound on the depth of the
+//           tree and nothing to allocate per insert. Each index page is
+//           unpinned before descending and pinned again only if its
+//           child split.
+//-------------------------------------------------------------------
+Status BTreeFile::InsertInto(PageID pid, const char *key, const RecordID rid,
+							 bool &split, char *new_index_key, PageID &new_index_value) {
+	Page *current_pg;
+	PIN(pid, current_pg);
+	split = false;
+
+	if (((ResizableRecordPage *) current_pg)->GetType() == LEAF_PAGE) {
+		LeafPage *leaf_pg = (LeafPage *)current_pg;
 		if (leaf_pg->HasSpaceForValue(key)) {
 			if (leaf_pg->Insert(key, rid) != OK) { //Should not happen, there is space on the page.
 				std::cerr << "Error in inserting record in leaf page in Insert." << std::endl;
-				delete [] traversed_pages;
-				return FAIL;
-			}
-			delete [] traversed_pages;
-			return MINIBASE_BM->UnpinPage(leaf_pg->PageNo(), DIRTY);
-		} else { // splitting
-			// create a new page
-			PageID split_pid;
-			LeafPage* new_page;
-			if (MINIBASE_BM->NewPage(split_pid, (Page*&)new_page) != OK) {
-				std::cerr << "Error allocating new page " << split_pid << " for page split." << std::endl;
-				delete [] traversed_pages;
+				MINIBASE_BM->UnpinPage(pid, CLEAN);
 				return FAIL;
 			}
+			return MINIBASE_BM->UnpinPage(pid, DIRTY);
+		}
 
-			// splits leaf into 2 pages
-			new_page->Init(split_pid, LEAF_PAGE);
-			SplitPage(new_page, leaf_pg, key, rid);
-
-			// set next/prev pointers
-			new_page->SetNextPage(leaf_pg->GetNextPage());
-			leaf_pg->SetNextPage(new_page->PageNo());
-			new_page->SetPrevPage(leaf_pg->PageNo());
-
-			// updating index
-			char* new_index_key;
-			PageID new_index_value;
-			PageID index_pid = leaf_pg->PageNo(); // for creating new index root
-			bool update_index = true;
-			
-			new_page->GetMinKey(new_index_key);
-			new_index_value = new_page->PageNo();
-
-			// unpin the leaf pages
-			if (MINIBASE_BM->UnpinPage(leaf_pg->PageNo(), DIRTY) != OK) {
-				std::cerr << "Error unpinning page " << leaf_pg->PageNo() << std::endl;
-				delete [] traversed_pages;
-				return FAIL;
-			}
-			if (MINIBASE_BM->UnpinPage(new_page->PageNo(), DIRTY) != OK) {
-				std::cerr << "Error unpinning page " << leaf_pg->PageNo() << std::endl;
-				delete [] traversed_pages;
-				return FAIL;
-			}
+		// splitting: create a new page
+		PageID split_pid;
+		LeafPage* new_page;
+		if (MINIBASE_BM->NewPage(split_pid, (Page*&)new_page) != OK) {
+			std::cerr << "Error allocating new page " << split_pid << " for page split." << std::endl;
+			MINIBASE_BM->UnpinPage(pid, CLEAN);
+			return FAIL;
+		}
 
-			if (tree_depth == 0) {
-				// tree contains a single leaf page, need to create new index root
-				IndexPage* new_root_pg;
-				PageID new_root_pid;
-				if (MINIBASE_BM->NewPage(new_root_pid, (Page*&)new_root_pg) != OK) {
-					std::cerr << "Error allocating new index page " << new_root_pid << std::endl;
-					delete [] traversed_pages;
-					return FAIL;
-				}
-				new_root_pg->Init(new_root_pid, INDEX_PAGE);
-				new_root_pg->Insert(new_index_key, new_index_value);
-				new_root_pg->SetPrevPage(index_pid);
-				header->SetRootPageID(new_root_pid);
-				if (MINIBASE_BM->UnpinPage(new_root_pid, DIRTY) != OK) {
-					std::cerr << "Error unpinning page " << new_root_pid << std::endl;
-					delete [] traversed_pages;
+		// splits leaf into 2 pages
+		new_page->Init(split_pid, LEAF_PAGE);
+		SplitPage(new_page, leaf_pg, key, rid, new_index_key);
+
+		// set next/prev pointers, including those of the page after
+		// the new one
+		PageID next_pid = leaf_pg->GetNextPage();
+		new_page->SetNextPage(next_pid);
+		leaf_pg->SetNextPage(split_pid);
+		new_page->SetPrevPage(pid);
+		if (next_pid != INVALID_PAGE) {
+			LeafPage* next_page;
+			PIN(next_pid, next_page);
+			next_page->SetPrevPage(split_pid);
+			UNPIN(next_pid, DIRTY);
+		}
+
+		split = true;
+		new_index_value = split_pid;
+		UNPIN(pid, DIRTY);
+		UNPIN(split_pid, DIRTY);
+		return OK;
+	}
+
+	// index page: find the child to descend to
+	IndexPage *index_pg = (IndexPage *)current_pg;
+	PageKVScan<PageID> possiblePages;
+	Status searchResult = index_pg->Search(key, possiblePages);
+
+	PageID next_search_pg;
+	char *key_ptr;
+	if (searchResult == DONE || searchResult == OK) {
+		possiblePages.GetNext(key_ptr, next_search_pg);
+	} else {
+		// there is no key smaller than the search key, go to pointer0
+		next_search_pg = index_pg->GetPrevPage();
+	}
+	UNPIN(pid, CLEAN);
+
+	bool child_split;
+	char child_key[MAX_KEY_LENGTH];
+	PageID child_value;
+	if (InsertInto(next_search_pg, key, rid, child_split, child_key, child_value) != OK) {
+		return FAIL;
+	}
+	if (!child_split) {
+		return OK;
+	}
+
+	// updating index
+	PIN(pid, index_pg);
+	if (index_pg->HasSpaceForValue(child_key)) {
+		if (index_pg->Insert(child_key, child_value) != OK) {
+			std::cerr << "Error inserting index key." << std::endl;
+			MINIBASE_BM->UnpinPage(pid, CLEAN);
+			return FAIL;
+		}
+		return MINIBASE_BM->UnpinPage(pid, DIRTY);
+	}
+
+	// split index node
+	PageID new_index_pid;
+	IndexPage* new_index;
+	if (MINIBASE_BM->NewPage(new_index_pid, (Page*&)new_index) != OK) {
+		std::cerr << "Error allocating new page " << new_index_pid << " for index splitting" << std::endl;
+		MINIBASE_BM->UnpinPage(pid, CLEAN);
+		return FAIL;
+	}
+	new_index->Init(new_index_pid, INDEX_PAGE);
+	SplitIndex(new_index, index_pg, child_key, child_value, new_index_key, new_index_value);
+
+	new_index->SetPrevPage(new_index_value);
+	new_index_value = new_index_pid;
+	split = true;
+
+	UNPIN(pid, DIRTY);
+	UNPIN(new_index_pid, DIRTY);
+	return OK;
+}
+
+
+//-------------------------------------------------------------------
+// BulkLoadLevel
+//
+// The page of one level of a tree being bulk loaded, pinned while it is
+// filled, and the entries collected for it. The entries are only written
+// to the page once it is complete, because each new largest key added to
+// a SortedKVPage would rewrite the whole page.
+//-------------------------------------------------------------------
+template<typename ValType>
+struct BulkLoadLevel
+{
+	enum {
+		MAX_KEYS = SortedKVPage<ValType>::MAX_KEYS,
+		MAX_VALS = HEAPPAGE_DATA_SIZE / sizeof(ValType)
+	};
+
+	PageID pid;
+	SortedKVPage<ValType> *page;
+	int numOfKeys;
+	int numOfVals;
+	int totalKeyLength;
+	char keys[MAX_KEYS][MAX_KEY_LENGTH];
+	int firstVal[MAX_KEYS + 1];		// The values of keys[i] start at vals[firstVal[i]].
+	ValType vals[MAX_VALS];
+
+	// Start filling a new, pinned page.
+	void Reset(PageID newPid, SortedKVPage<ValType> *newPage) {
+		pid = newPid;
+		page = newPage;
+		numOfKeys = 0;
+		numOfVals = 0;
+		totalKeyLength = 0;
+		firstVal[0] = 0;
+	}
+
+	const char *LastKey() {
+		return keys[numOfKeys - 1];
+	}
+
+	// The space the page would use with one more value for key, which is
+	// either a new largest key or the last key.
+	int SpaceWith(const char *key, bool isNewKey) {
+		if (!isNewKey) {
+			return SortedKVPage<ValType>::SpaceNeeded(keys[0], LastKey(), numOfKeys,
+													  totalKeyLength, numOfVals + 1);
+		}
+		return SortedKVPage<ValType>::SpaceNeeded(numOfKeys > 0 ? keys[0] : key, key, numOfKeys + 1,
+												  totalKeyLength + strlen(key), numOfVals + 1);
+	}
+
+	void Add(const char *key, ValType val, bool isNewKey) {
+		if (isNewKey) {
+			strcpy(keys[numOfKeys], key);
+			totalKeyLength += strlen(key);
+			numOfKeys++;
+		}
+		vals[numOfVals++] = val;
+		firstVal[numOfKeys] = numOfVals;
+	}
+
+	// Write the first n keys to the page: the first key, then the last,
+	// then the ones in between, so that only the first two inserts
+	// rewrite the page.
+	Status Write(int n) {
+		for (int j = 0; j < n; j++) {
+			int i = (j == 0) ? 0 : (j == 1) ? n - 1 : j - 1;
+			for (int v = firstVal[i]; v < firstVal[i + 1]; v++) {
+				if (page->Insert(keys[i], vals[v]) != OK) {
 					return FAIL;
 				}
-				delete [] traversed_pages;
-				return OK;
 			}
-			
-			tree_depth = tree_depth-1;
-			while (tree_depth >= 0 && update_index) {
-				index_pid = traversed_pages[tree_depth];
-				tree_depth--;
-				if (MINIBASE_BM->PinPage(index_pid, (Page *&) index_pg) != OK) {
-					std::cerr << "Error pinning page " << index_pid << std::endl;
-					return FAIL;
-				}
-				if (index_pg->HasSpaceForValue(new_index_key)) {
-					if (index_pg->Insert(new_index_key, new_index_value) != OK) {
-						std::cerr << "Error inserting index key." << std::endl;
-						delete [] traversed_pages;
-						return FAIL;
-					}
-					update_index = false;
-					if (MINIBASE_BM->UnpinPage(index_pid, DIRTY) != OK) {
-						std::cerr << "Error unpinning page " << index_pid << std::endl;
-						delete [] traversed_pages;
-						return FAIL;
-					}
-				} else {
-					// split index node
-					PageID new_index_pid;
-					IndexPage* new_index;
-					if (MINIBASE_BM->NewPage(new_index_pid, (Page*&)new_index) != OK) {
-						std::cerr << "Error allocating new page " << new_index_pid << " for index splitting" << std::endl;
-						delete [] traversed_pages;
-						return FAIL;
-					}
-					new_index->Init(new_index_pid, INDEX_PAGE);
-					SplitIndex(new_index, index_pg, new_index_key, new_index_value, new_index_key, new_index_value);
-
-					new_index->SetPrevPage(new_index_value);
-					new_index_value = new_index->PageNo();
-
-					// special case: index node == root node
-					if (index_pg->PageNo() == header->GetRootPageID()) {
-						PageID new_root_pid;
-						IndexPage* new_root;
-						if (MINIBASE_BM->NewPage(new_root_pid, (Page*&) new_root) != OK) {
-							std::cerr << "error allocating new page " << new_root_pid << " for root split" << std::endl;
-							delete [] traversed_pages;
-							return FAIL;
-						}
-						new_root->Init(new_root_pid, INDEX_PAGE);
-						new_root->SetPrevPage(index_pg->PageNo());
-						new_root->Insert(new_index_key, new_index_value);
-						header->SetRootPageID(new_root_pid);
-						//std::cout << "Root split, old root_pid: " << index_pg->PageNo() << ". new root_pid: " << new_root_pid << std::endl;
-						if (MINIBASE_BM->UnpinPage(new_root_pid, DIRTY) != OK) {
-							std::cerr << "Error unpinning page " << new_root_pid << std::endl;
-							delete [] traversed_pages;
-							return FAIL;
-						}
-					}
-
-					if (MINIBASE_BM->UnpinPage(index_pid, DIRTY) != OK) {
-						std::cerr << "Error unpinning page " << index_pid << std::endl;
-						delete [] traversed_pages;
-						return FAIL;
-					}
-					if (MINIBASE_BM->UnpinPage(new_index_pid, DIRTY) != OK) {
-						std::cerr << "Error unpinning page " << new_index_pid << std::endl;
-						delete [] traversed_pages;
-						return FAIL;
-					}
-				}
+		}
+		return OK;
+	}
+
+	// Drop the first n keys, which have been written.
+	void KeepFrom(int n) {
+		int shift = firstVal[n];
+		totalKeyLength = 0;
+		for (int i = n; i < numOfKeys; i++) {
+			strcpy(keys[i - n], keys[i]);
+			totalKeyLength += strlen(keys[i]);
+			firstVal[i - n + 1] = firstVal[i + 1] - shift;
+		}
+		memmove(vals, vals + shift, (numOfVals - shift) * sizeof(ValType));
+		numOfKeys -= n;
+		numOfVals -= shift;
+	}
+};
+
+typedef BulkLoadLevel<RecordID> LeafLevel;
+typedef BulkLoadLevel<PageID> IndexLevel;
+
+//-------------------------------------------------------------------
+// AddIndexEntry
+//
+// Input   : levels,    The index levels loaded so far, lowest first.
+//           level,     The level to add the entry to.
+//           key,       The smallest key under child.
+//           child,     A page of the level below.
+//           leftChild, The page of the level below before child, which
+//                      is the prev page of a new level.
+//           maxBytes,  The space each page may use.
+// Output  : None.
+// Return  : OK if successful, FAIL otherwise.
+// Purpose : Add an index entry while bulk loading. A complete page moves
+//           key up a level, and child becomes the prev page of the next
+//           page on this level.
+//-------------------------------------------------------------------
+static Status AddIndexEntry(std::vector<IndexLevel *> &levels, unsigned int level,
+							const char *key, PageID child, PageID leftChild, int maxBytes)
+{
+	PageID pid;
+	IndexPage *page;
+
+	if (level == levels.size()) {
+		NEWPAGE(pid, page);
+		page->Init(pid, INDEX_PAGE);
+		page->SetPrevPage(leftChild);
+		levels.push_back(new IndexLevel());
+		levels[level]->Reset(pid, page);
+	}
+
+	IndexLevel *index = levels[level];
+	if (index->numOfKeys > 0 && index->SpaceWith(key, true) > maxBytes) {
+		NEWPAGE(pid, page);
+		page->Init(pid, INDEX_PAGE);
+		page->SetPrevPage(child);
+
+		PageID fullPid = index->pid;
+		Status status = index->Write(index->numOfKeys);
+		UNPIN(fullPid, DIRTY);
+		index->Reset(pid, page);
+		if (status != OK) {
+			return FAIL;
+		}
+		return AddIndexEntry(levels, level + 1, key, pid, fullPid, maxBytes);
+	}
+
+	index->Add(key, child, true);
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// ShortestSeparator
+//
+// Input   : leftMax,   The largest key left of a page boundary.
+//           rightMin,  The smallest key right of it.
+// Output  : separator, The shortest prefix of rightMin that is larger
+//                      than leftMax, in a buffer of MAX_KEY_LENGTH bytes.
+// Return  : None.
+// Purpose : Choose the key to put in the parent for the page on the
+//           right, which keeps index pages small. The keys differ at
+//           the first byte they do not share, or leftMax ends there, so
+//           one more byte of rightMin separates them.
+//-------------------------------------------------------------------
+static void ShortestSeparator(const char *leftMax, const char *rightMin, char *separator)
+{
+	int length = 0;
+	while (leftMax[length] != '\0' && leftMax[length] == rightMin[length]) {
+		length++;
+	}
+	memcpy(separator, rightMin, length + 1);
+	separator[length + 1] = '\0';
+}
+
+//-------------------------------------------------------------------
+// StartNextLeaf
+//
+// Input   : leaves,    The leaf level.
+//           n,         The number of its keys that go on its page.
+//           rightMin,  The smallest key of the next leaf.
+//           levels,    The index levels loaded so far.
+//           maxBytes,  The space each page may use.
+// Output  : None.
+// Return  : OK if successful, FAIL otherwise.
+// Purpose : Write the leaf being filled and start the next one, linking
+//           the two, and add the next one to the index.
+//-------------------------------------------------------------------
+static Status StartNextLeaf(LeafLevel *leaves, int n, const char *rightMin,
+							std::vector<IndexLevel *> &levels, int maxBytes)
+{
+	PageID pid;
+	LeafPage *page;
+	NEWPAGE(pid, page);
+	page->Init(pid, LEAF_PAGE);
+	page->SetPrevPage(leaves->pid);
+	leaves->page->SetNextPage(pid);
+
+	char separator[MAX_KEY_LENGTH];
+	ShortestSeparator(leaves->keys[n - 1], rightMin, separator);
+
+	PageID fullPid = leaves->pid;
+	Status status = leaves->Write(n);
+	UNPIN(fullPid, DIRTY);
+	leaves->KeepFrom(n);
+	leaves->pid = pid;
+	leaves->page = page;
+	if (status != OK) {
+		return FAIL;
+	}
+
+	return AddIndexEntry(levels, 0, separator, pid, fullPid, maxBytes);
+}
+
+//-------------------------------------------------------------------
+// BTreeFile::BulkLoad
+//
+// Input   : input - the entries to load, in ascending key order.
+//           fillFactor - how full to make each page, between 0 and 1.
+//                        Lower values leave room for later inserts.
+// Output  : None
+// Return  : OK if successful, FAIL otherwise.
+// Purpose : Build the index from sorted entries, which must be empty.
+//           Leaves are filled from left to right and chained as they
+//           are completed, and each completed page adds an entry to the
+//           level above it, so the index levels grow from the bottom
+//           up. Every page is written once, and there are no splits.
+// Note    : As with Insert, the values of a key are kept on one leaf,
+//           so a page may go over the fill factor for a key with many
+//           values. If the input is out of order, fails, or an entry
+//           cannot be loaded, the entries before it are kept in the
+//           index and FAIL is returned.
+//-------------------------------------------------------------------
+Status BTreeFile::BulkLoad(SortedKVStream &input, double fillFactor) {
+	if (header->GetRootPageID() != INVALID_PAGE) {
+		std::cerr << "BulkLoad needs an empty index." << std::endl;
+		return FAIL;
+	}
+	if (fillFactor <= 0 || fillFactor > 1) {
+		std::cerr << "BulkLoad fill factor " << fillFactor << " is not in (0, 1]." << std::endl;
+		return FAIL;
+	}
+
+	int maxBytes = (int)(fillFactor * HEAPPAGE_DATA_SIZE);
+	LeafLevel *leaves = NULL;
+	std::vector<IndexLevel *> levels;
+	Status status = OK;
+
+	RecordID rid;
+	char *key;
+	Status streamStatus;
+	while ((streamStatus = input.GetNext(rid, key)) == OK) {
+		if (strlen(key) >= MAX_KEY_LENGTH) {
+			std::cerr << "BulkLoad key " << key << " is too long." << std::endl;
+			status = FAIL;
+			break;
+		}
+
+		if (leaves == NULL) {
+			PageID pid;
+			LeafPage *page;
+			if (MINIBASE_BM->NewPage(pid, (Page *&)page) != OK) {
+				std::cerr << "Error allocating a leaf page in BulkLoad." << std::endl;
+				status = FAIL;
+				break;
+			}
+			page->Init(pid, LEAF_PAGE);
+			leaves = new LeafLevel();
+			leaves->Reset(pid, page);
+		}
+
+		int cmp = (leaves->numOfKeys > 0) ? strcmp(key, leaves->LastKey()) : 1;
+		if (cmp < 0) {
+			std::cerr << "BulkLoad key " << key << " is out of order." << std::endl;
+			status = FAIL;
+			break;
+		}
+
+		bool isNewKey = (cmp > 0);
+		if (leaves->numOfKeys > 0 && leaves->SpaceWith(key, isNewKey) > (isNewKey ? maxBytes : HEAPPAGE_DATA_SIZE)) {
+			// A key whose values outgrow the page moves on to the next
+			// one with them.
+			int n = isNewKey ? leaves->numOfKeys : leaves->numOfKeys - 1;
+			if (n == 0) {
+				std::cerr << "BulkLoad key " << key << " has too many values for a page." << std::endl;
+				status = FAIL;
+				break;
 			}
-			delete [] traversed_pages;
-			return OK;
+			if (StartNextLeaf(leaves, n, isNewKey ? key : leaves->keys[n], levels, maxBytes) != OK) {
+				status = FAIL;
+				break;
+			}
+		}
+
+		leaves->Add(key, rid, isNewKey);
+	}
+
+	// Anything but DONE means the stream failed before its end.
+	if (status == OK && streamStatus != DONE) {
+		std::cerr << "BulkLoad input ended with an error." << std::endl;
+		status = FAIL;
+	}
+
+	if (leaves == NULL) {
+		return status;
+	}
+
+	// Write the last page of each level, which becomes the root at the
+	// top. This is done after a failure too, so that DestroyFile can free
+	// every page.
+	PageID rootPid = leaves->pid;
+	if (leaves->Write(leaves->numOfKeys) != OK) {
+		status = FAIL;
+	}
+	UNPIN(leaves->pid, DIRTY);
+	delete leaves;
+
+	for (unsigned int i = 0; i < levels.size(); i++) {
+		rootPid = levels[i]->pid;
+		if (levels[i]->Write(levels[i]->numOfKeys) != OK) {
+			status = FAIL;
 		}
+		UNPIN(levels[i]->pid, DIRTY);
+		delete levels[i];
 	}
+
+	header->SetRootPageID(rootPid);
+	return status;
 }
 
 
@@ -376,12 +672,18 @@ Status BTreeFile::Insert(const char *key, const RecordID rid) {
 //           oldPage - the full page to be split
 //			 newKey - the key to be inserted
 //			 newValue - the new value to be inserted
-// Output  : propagatedKey - the key to be propagated up a level
+// Output  : propagatedKey - the key to be propagated up a level, copied
+//                           to a buffer of MAX_KEY_LENGTH bytes. It may
+//                           be the same buffer as newKey.
 //			 propagatedValue - the value to be propagated up a level
 // Purpose : Splitting an index page
+// Note    : The propagated key is moved up as it is. It was already cut
+//           down to a shortest separator when SplitPage created it, and
+//           a shorter one could not be chosen without looking at the
+//           leaves below.
 //-------------------------------------------------------------------
 void BTreeFile::SplitIndex(IndexPage* newPage, IndexPage* oldPage, const char* newKey, PageID newValue, 
-						   char*& propagatedKey, PageID& propagatedValue) {
+						   char* propagatedKey, PageID& propagatedValue) {
 	char* currentKey;
 	PageID currentValue;
 
@@ -395,23 +697,29 @@ void BTreeFile::SplitIndex(IndexPage* newPage, IndexPage* oldPage, const char* n
 	}
 
 	// keeping both pages balanced with one entry taken out as the new propagated index
+	// Keys are copied out before they are deleted, since deleting the
+	// first or last key of a page rewrites the page.
 	if (oldPage->AvailableSpace() < newPage->AvailableSpace()) {
 		newPage->Insert(newKey, newValue);
-		oldPage->GetMaxKeyValue(propagatedKey, propagatedValue);
+		oldPage->GetMaxKeyValue(currentKey, propagatedValue);
+		strcpy(propagatedKey, currentKey);
 		oldPage->DeleteKey(propagatedKey);
 		while (oldPage->AvailableSpace() < newPage->AvailableSpace()) {
 			// move max key from oldPage to newPage
 			newPage->Insert(propagatedKey, propagatedValue);
-			oldPage->GetMaxKeyValue(propagatedKey, propagatedValue);
+			oldPage->GetMaxKeyValue(currentKey, propagatedValue);
+			strcpy(propagatedKey, currentKey);
 			oldPage->DeleteKey(propagatedKey);
 		}
 	} else {
 		oldPage->Insert(newKey, newValue);
-		newPage->GetMinKeyValue(propagatedKey, propagatedValue);
+		newPage->GetMinKeyValue(currentKey, propagatedValue);
+		strcpy(propagatedKey, currentKey);
 		newPage->DeleteKey(propagatedKey);
 		while (oldPage->AvailableSpace() > newPage->AvailableSpace()) {
 			oldPage->Insert(propagatedKey, propagatedValue);
-			newPage->GetMinKeyValue(propagatedKey, propagatedValue);
+			newPage->GetMinKeyValue(currentKey, propagatedValue);
+			strcpy(propagatedKey, currentKey);
 			newPage->DeleteKey(propagatedKey);
 		}
 	}
@@ -424,10 +732,14 @@ void BTreeFile::SplitIndex(IndexPage* newPage, IndexPage* oldPage, const char* n
 //           oldPage - the full page to be split
 //			 newKey - the key to be inserted
 //			 newValue - the new value to be inserted
-// Output  : None
-// Purpose : Splitting a leaf page
+// Output  : separator - the key to insert into the parent for newPage,
+//                       in a buffer of MAX_KEY_LENGTH bytes.
+// Purpose : Splitting a leaf page. The separator is the shortest prefix
+//           of the smallest key of newPage that is larger than every key
+//           left on oldPage, which keeps index pages small.
 //-------------------------------------------------------------------
-void BTreeFile::SplitPage(LeafPage* newPage, LeafPage* oldPage, const char* newKey, RecordID newValue) {
+void BTreeFile::SplitPage(LeafPage* newPage, LeafPage* oldPage, const char* newKey, RecordID newValue,
+						  char* separator) {
 	char* maxKey;
 	PageKVScan<RecordID> pageScanner;
 	char* currentKey;
@@ -476,6 +788,12 @@ void BTreeFile::SplitPage(LeafPage* newPage, LeafPage* oldPage, const char* newK
 			newPage->DeleteKey(minKey);
 		}
 	}
+
+	char* leftMax;
+	char* rightMin;
+	oldPage->GetMaxKey(leftMax);
+	newPage->GetMinKey(rightMin);
+	ShortestSeparator(leftMax, rightMin, separator);
 }
 
 //-------------------------------------------------------------------
@@ -21,6 +21,34 @@ void BTreeDriver::toString(const int n, char *str, int pad)
 }
 
 
+//-------------------------------------------------------------------
+// BTreeDriver::toLongString
+//
+// Input   : n,   The number to convert.
+// Output  : str, A key of MAX_KEY_LENGTH - 2 characters for n. This
+//                function assumes that str is a character array of size
+//                MAX_KEY_LENGTH.
+// Return  : None
+// Purpose : Makes keys that put as few entries on a page as possible.
+//           Each run of 8 numbers shares a long string of letters picked
+//           from n / 8, followed by n itself. A leaf split inside a run
+//           moves nearly a whole key up as the separator, while one
+//           between two runs moves up only a letter or two. The runs are
+//           scattered over the key space, so that the keys of an index
+//           page have no common prefix to be left out.
+//-------------------------------------------------------------------
+void BTreeDriver::toLongString(const int n, char *str)
+{
+	const int numOfLetters = MAX_KEY_LENGTH - 8;
+	unsigned int run = (unsigned int)(n / 8) * 2654435761u;
+
+	for (int i = 0; i < numOfLetters; i++) {
+		str[i] = 'a' + (run >> (i % 28)) % 26;
+	}
+	sprintf_s(str + numOfLetters, MAX_KEY_LENGTH - numOfLetters, "%06d", n);
+}
+
+
 //-------------------------------------------------------------------
 // BTreeDriver::InsertKey
 //
@@ -330,6 +358,42 @@ bool BTreeDriver::TestNumEntries(BTreeFile *btf, int expected)
 }
 
 
+//-------------------------------------------------------------------
+// BTreeDriver::TreeHeight
+//
+// Input   : btf,  The B-Tree to measure.
+// Output  : None
+// Return  : The number of levels in the tree, counting the leaves, 0 if
+//           the tree is empty or -1 if a page could not be pinned.
+// Purpose : Follows the leftmost pointers from the root to a leaf.
+//-------------------------------------------------------------------
+int BTreeDriver::TreeHeight(BTreeFile *btf)
+{
+	PageID pid = btf->header->GetRootPageID();
+	int height = 0;
+
+	while (pid != INVALID_PAGE) {
+		height++;
+
+		ResizableRecordPage *page;
+		if (MINIBASE_BM->PinPage(pid, (Page *&)page) == FAIL) {
+			std::cerr << "Unable to pin page " << pid << std::endl;
+			return -1;
+		}
+
+		PageID child = (page->GetType() == INDEX_PAGE) ? page->GetPrevPage() : INVALID_PAGE;
+
+		if (MINIBASE_BM->UnpinPage(pid, CLEAN) == FAIL) {
+			std::cerr << "Unable to unpin page " << pid << std::endl;
+			return -1;
+		}
+		pid = child;
+	}
+
+	return height;
+}
+
+
 bool BTreeDriver::SizeForKeyOnLeafPage(ResizableRecordPage *page,
 									   const char *key,
 									   int &result)
@@ -953,3 +1017,88 @@ bool BTreeDriver::TestDeleteCurrent() {
 
 	return res;
 }
+
+bool BTreeDriver::TestDeepTree() {
+	Status status;
+	BTreeFile *btf;
+	bool res = true;
+
+	std::cout << "Starting Test 7..." << std::endl;
+	unsigned int pinnedPages = MINIBASE_BM->GetNumOfBuffers() - MINIBASE_BM->GetNumOfUnpinnedBuffers();
+
+	btf = new BTreeFile(status, "BTreeTest7");
+
+	if (status != OK) {
+		std::cerr << "ERROR: Couldn't create a BTreeFile" << std::endl;
+		minibase_errors.show_errors();
+
+		std::cerr << "Hit [enter] to continue..." << std::endl;
+		std::cin.get();
+		exit(1);
+	}
+
+	std::cout << "BTreeIndex created successfully." << std::endl;
+
+	// The runs of toLongString land at random places in the tree, each
+	// run's keys in ascending order. A leaf holds only four or five of
+	// these keys, so most leaves split inside a run. Their keys share 120
+	// letters, which prefix compression leaves out on the leaf, but the
+	// separator moved up is nearly a whole key. Only splits between runs
+	// give separators of one or two letters. Index pages then hold about
+	// six entries. 20000 keys fill about 4400 leaves under five index
+	// levels, and six levels are reached from about 12000 keys on, so the
+	// height check below has a wide margin.
+	const int numOfKeys = 20000;
+	char skey[MAX_KEY_LENGTH];
+
+	std::cout << "Inserting " << numOfKeys << " long keys..." << std::endl;
+	for (int i = 0; i < numOfKeys && res; i++) {
+		RecordID rid;
+		rid.pageNo = i;
+		rid.slotNo = i + 1;
+		toLongString(i, skey);
+
+		if (btf->Insert(skey, rid) != OK) {
+			std::cerr << "Inserting key " << skey << " failed" << std::endl;
+			res = false;
+		}
+	}
+
+	int height = TreeHeight(btf);
+	std::cout << "Tree height: " << height << std::endl;
+	if (height < 6) {
+		std::cerr << "Error: Expected a tree with more than four index levels" << std::endl;
+		res = false;
+	}
+
+	res = res && TestNumEntries(btf, numOfKeys);
+
+	// Every key is found with the record it was inserted with.
+	for (int i = 0; i < numOfKeys && res; i += 97) {
+		toLongString(i, skey);
+		BTreeFileScan *scan = btf->OpenScan(skey, skey);
+
+		RecordID rid;
+		char *keyPtr;
+		if (scan->GetNext(rid, keyPtr) != OK || strcmp(keyPtr, skey) != 0 || rid.pageNo != i) {
+			std::cerr << "Error: Expected key " << skey << " not present." << std::endl;
+			res = false;
+		}
+		delete scan;
+	}
+
+	if (btf->DestroyFile() != OK) {
+		std::cerr << "Error destroying BTreeFile" << std::endl;
+		res = false;
+	}
+
+	delete btf;
+
+	unsigned int numPinned = MINIBASE_BM->GetNumOfBuffers() - MINIBASE_BM->GetNumOfUnpinnedBuffers();
+
+	if (pinnedPages - numPinned != 0) {
+		std::cerr << pinnedPages - numPinned << " pages still left in buffer pool after clean up." << std::endl;
+		res = false;
+	}
+	return res;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+
+#include "bufmgr.h"
+#include "BenchUtil.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------
+// RandomInt
+//
+// Input   : n, The number of possible results.
+// Output  : None.
+// Return  : A random number in [0, n). rand() alone is too small on
+//           some platforms to cover n.
+//-------------------------------------------------------------------
+int RandomInt(int n)
+{
+	return (int)(((long long)rand() * (RAND_MAX + 1LL) + rand()) % n);
+}
+
+//-------------------------------------------------------------------
+// Shuffle
+//
+// Input   : values, The values to shuffle.
+//           n,      The number of values.
+// Output  : values, The same values in a random order.
+// Return  : None.
+//-------------------------------------------------------------------
+void Shuffle(int *values, int n)
+{
+	for (int i = n - 1; i > 0; i--) {
+		int j = RandomInt(i + 1);
+		int k = values[i];
+		values[i] = values[j];
+		values[j] = k;
+	}
+}
+
+//-------------------------------------------------------------------
+// OpenBenchDB
+//
+// Input   : name,         The base name of the database and log files.
+//           numOfDBPages, The size of the database.
+//           numOfBufs,    The size of the buffer pool.
+// Output  : None.
+// Return  : OK   if successful.
+//           FAIL if the database could not be created.
+// Purpose : Creates a fresh database and buffer pool for one benchmark.
+//-------------------------------------------------------------------
+Status OpenBenchDB(const char *name, int numOfDBPages, int numOfBufs)
+{
+	Status status;
+	string base(name);
+	minibase_globals = new SystemDefs(status, (base + ".DB").c_str(), (base + ".LOG").c_str(),
+									  numOfDBPages, 500, numOfBufs);
+	if (status != OK) {
+		cerr << "*** Could not create the benchmark database" << endl;
+		delete minibase_globals;
+		minibase_globals = NULL;
+		return FAIL;
+	}
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// CloseBenchDB
+//
+// Input   : name, The name given to OpenBenchDB.
+// Output  : None.
+// Return  : None.
+// Purpose : Closes the database and deletes its files.
+//-------------------------------------------------------------------
+void CloseBenchDB(const char *name)
+{
+	string base(name);
+	delete minibase_globals;
+	minibase_globals = NULL;
+	remove((base + ".DB").c_str());
+	remove((base + ".LOG").c_str());
+}
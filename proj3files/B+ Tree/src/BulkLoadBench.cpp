@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <iostream>
+#include <vector>
+
+#include "bufmgr.h"
+#include "BTreeFile.h"
+#include "BenchUtil.h"
+#include "BulkLoadBench.h"
+
+using namespace std;
+
+static const int numOfEntries = 10000000;
+static const int numOfLookups = 100000;
+
+// Inserting sorted keys leaves every page half full, at about 16 bytes per
+// leaf entry. The buffer pool holds the whole tree so that the builds are
+// not timed against the disk.
+static const int numOfDBPages = 600000;
+static const int numOfBufs = 600000;
+
+// The entries 0 to numOfEntries - 1, in key order, with keys formatted
+// as for the other benchmarks.
+class CountingStream : public SortedKVStream
+{
+public:
+	CountingStream() {
+		next = 0;
+	}
+
+	Status GetNext(RecordID &rid, char *&keyPtr) {
+		if (next == numOfEntries) {
+			return DONE;
+		}
+
+		sprintf(key, "%08d", next);
+		keyPtr = key;
+		rid.pageNo = next;
+		rid.slotNo = 0;
+		next++;
+		return OK;
+	}
+
+private:
+	int next;
+	char key[MAX_KEY_LENGTH];
+};
+
+//-------------------------------------------------------------------
+// BulkLoadBench::CountPages
+//
+// Input   : pid,   A page of the tree.
+//           level, The depth of the page, 0 for the root.
+// Output  : None.
+// Return  : OK, or FAIL if a page could not be pinned.
+// Purpose : Count the page on its level, then visit the pages below it.
+//-------------------------------------------------------------------
+Status BulkLoadBench::CountPages(PageID pid, int level)
+{
+	if (level >= MAX_LEVELS) {
+		cerr << "*** The tree is deeper than " << (int)MAX_LEVELS << " levels" << endl;
+		return FAIL;
+	}
+	if (level >= height) {
+		pagesPerLevel[level] = 0;
+		height = level + 1;
+	}
+	pagesPerLevel[level]++;
+
+	Page *page;
+	PIN(pid, page);
+
+	vector<PageID> children;
+	if (((ResizableRecordPage *)page)->GetType() == INDEX_PAGE) {
+		IndexPage *indexPage = (IndexPage *)page;
+		PageKVScan<PageID> scan;
+		char *key;
+		PageID child;
+
+		children.push_back(indexPage->GetPrevPage());
+		indexPage->OpenScan(&scan);
+		while (scan.GetNext(key, child) == OK) {
+			children.push_back(child);
+		}
+	}
+
+	UNPIN(pid, CLEAN);
+
+	for (unsigned int i = 0; i < children.size(); i++) {
+		if (CountPages(children[i], level + 1) != OK) {
+			return FAIL;
+		}
+	}
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// BulkLoadBench::TimeBuild
+//
+// Input   : fillFactor, The fill factor to pass to BulkLoad, or 0 to
+//                       call Insert for each entry instead.
+// Output  : None.
+// Return  : OK, or FAIL if the index could not be built.
+// Purpose : Build an index from a CountingStream, print the time taken
+//           and the number of pages on each level, and check it with
+//           numOfLookups point lookups.
+//-------------------------------------------------------------------
+Status BulkLoadBench::TimeBuild(double fillFactor)
+{
+	Status status;
+	BTreeFile *btf = new BTreeFile(status, "bulkloadbench");
+	if (status != OK) {
+		cerr << "*** Could not create the benchmark index" << endl;
+		return FAIL;
+	}
+
+	CountingStream input;
+	clock_t start = clock();
+	if (fillFactor > 0) {
+		status = btf->BulkLoad(input, fillFactor);
+	}
+	else {
+		RecordID rid;
+		char *key;
+		while (status == OK && input.GetNext(rid, key) == OK) {
+			status = btf->Insert(key, rid);
+		}
+	}
+	double buildTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	if (status != OK) {
+		cerr << "*** Building the index failed" << endl;
+		btf->DestroyFile();
+		delete btf;
+		return FAIL;
+	}
+
+	height = 0;
+	if (CountPages(btf->header->GetRootPageID(), 0) != OK) {
+		btf->DestroyFile();
+		delete btf;
+		return FAIL;
+	}
+
+	int numOfMisses = 0;
+	srand(1);
+	for (int i = 0; i < numOfLookups; i++) {
+		BTreeFileScan *scan;
+		RecordID rid;
+		char key[MAX_KEY_LENGTH];
+		char *foundKey;
+		int k = RandomInt(numOfEntries);
+
+		sprintf(key, "%08d", k);
+		scan = btf->OpenScan(key, key);
+		if (scan == NULL || scan->GetNext(rid, foundKey) != OK || rid.pageNo != k) {
+			numOfMisses++;
+		}
+		delete scan;
+	}
+
+	int numOfIndexPages = 0;
+	for (int i = 0; i < height - 1; i++) {
+		numOfIndexPages += pagesPerLevel[i];
+	}
+
+	char method[32];
+	if (fillFactor > 0) {
+		sprintf(method, "BulkLoad, fill %.2f", fillFactor);
+	}
+	else {
+		sprintf(method, "Insert");
+	}
+	printf("  %-20s  %-8.2f  %-11.0f  %-6d  %-8d  %-11d  %d\n",
+		   method, buildTime, numOfEntries / buildTime, height,
+		   pagesPerLevel[height - 1], numOfIndexPages, numOfMisses);
+
+	btf->DestroyFile();
+	delete btf;
+	return OK;
+}
+
+Status BulkLoadBench::RunBenchmarks()
+{
+	if (OpenBenchDB("BULKLOADBENCH", numOfDBPages, numOfBufs) != OK) {
+		return FAIL;
+	}
+
+	cout << "\nRunning bulk load benchmarks...\n" << endl;
+	cout << "  " << numOfEntries << " entries in key order, checked with "
+		 << numOfLookups << " point lookups\n" << endl;
+	cout << "  build                 seconds   entries/s    height  leaves    index pages  misses" << endl;
+
+	// Insert last, since it takes the longest.
+	const double fillFactors[] = { 1.0, 0.9, 0.7, 0 };
+	for (int i = 0; i < 4; i++) {
+		TimeBuild(fillFactors[i]);
+	}
+
+	cout << "\n...bulk load benchmarks completed.\n" << endl;
+
+	CloseBenchDB("BULKLOADBENCH");
+	return OK;
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <iostream>
+
+#include "bufmgr.h"
+#include "BTreeFile.h"
+#include "BTreeTest.h"
+#include "BenchUtil.h"
+#include "InsertBench.h"
+
+using namespace std;
+
+static const int numOfShortKeys = 1000000;
+static const int numOfLongKeys = 200000;
+
+// The largest tree, of long keys, takes about 52000 pages. The buffer
+// pool holds all of it so that inserts are not timed against the disk.
+static const int numOfDBPages = 100000;
+static const int numOfBufs = 100000;
+
+//-------------------------------------------------------------------
+// MakeShortKey
+//
+// Input   : k, A number.
+// Output  : key, The key for k, zero padded so that keys sort
+//                numerically.
+// Return  : None.
+//-------------------------------------------------------------------
+static void MakeShortKey(int k, char *key)
+{
+	sprintf(key, "%08d", k);
+}
+
+//-------------------------------------------------------------------
+// InsertBench::TimeInserts
+//
+// Input   : name,      The name of the workload to print.
+//           makeKey,   Makes the key for a number.
+//           numOfKeys, The number of keys to insert, for the numbers 0
+//                      to numOfKeys - 1.
+//           shuffle,   Whether to insert the numbers in random order
+//                      rather than ascending.
+// Output  : None.
+// Return  : OK, or FAIL if an insert failed.
+//-------------------------------------------------------------------
+Status InsertBench::TimeInserts(const char *name, void (*makeKey)(int, char *),
+								int numOfKeys, bool shuffle)
+{
+	Status status;
+	BTreeFile *btf = new BTreeFile(status, "insertbench");
+	if (status != OK) {
+		cerr << "*** Could not create the benchmark index" << endl;
+		return FAIL;
+	}
+
+	int *order = new int[numOfKeys];
+	for (int i = 0; i < numOfKeys; i++) {
+		order[i] = i;
+	}
+	if (shuffle) {
+		srand(1);
+		Shuffle(order, numOfKeys);
+	}
+
+	char key[MAX_KEY_LENGTH];
+	clock_t start = clock();
+	for (int i = 0; i < numOfKeys && status == OK; i++) {
+		RecordID rid;
+		makeKey(order[i], key);
+		rid.pageNo = order[i];
+		rid.slotNo = 0;
+		status = btf->Insert(key, rid);
+	}
+	double time = (double)(clock() - start) / CLOCKS_PER_SEC;
+	delete [] order;
+
+	if (status != OK) {
+		cerr << "*** Inserting key " << key << " failed" << endl;
+	}
+	else {
+		printf("  %-22s  %-8d  %-8.2f  %-10.0f  %d\n",
+			   name, numOfKeys, time, numOfKeys / time, BTreeDriver::TreeHeight(btf));
+	}
+
+	btf->DestroyFile();
+	delete btf;
+	return status;
+}
+
+Status InsertBench::RunBenchmarks()
+{
+	if (OpenBenchDB("INSERTBENCH", numOfDBPages, numOfBufs) != OK) {
+		return FAIL;
+	}
+
+	cout << "\nRunning insert benchmarks...\n" << endl;
+	cout << "  keys                    inserts   seconds   inserts/s   height" << endl;
+
+	TimeInserts("8 bytes, random order", MakeShortKey, numOfShortKeys, true);
+	TimeInserts("8 bytes, ascending", MakeShortKey, numOfShortKeys, false);
+	TimeInserts("126 bytes, ascending", BTreeDriver::toLongString, numOfLongKeys, false);
+
+	cout << "\n...insert benchmarks completed.\n" << endl;
+
+	CloseBenchDB("INSERTBENCH");
+	return OK;
+}
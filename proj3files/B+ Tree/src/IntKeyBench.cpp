@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <iostream>
+
+#include "bufmgr.h"
+#include "BTreeFile.h"
+#include "IntBTreeFile.h"
+#include "BenchUtil.h"
+#include "IntKeyBench.h"
+
+using namespace std;
+
+static const int numOfKeys = 1000000;
+static const int numOfLookups = 1000000;
+
+// The string tree takes about 35000 pages, the integer trees fewer. The
+// buffer pool holds all of it so that nothing is timed against the disk.
+static const int numOfDBPages = 100000;
+static const int numOfBufs = 100000;
+
+//-------------------------------------------------------------------
+// MakeKey
+//
+// Input   : k, A number below numOfKeys.
+// Output  : None.
+// Return  : The key for k. 8 byte keys are spread out so that they use
+//           their upper half.
+//-------------------------------------------------------------------
+template<typename KeyType>
+static KeyType MakeKey(int k)
+{
+	return (sizeof(KeyType) > 4) ? (KeyType)k * 1000003 : (KeyType)k;
+}
+
+//-------------------------------------------------------------------
+// IntKeyBench::TimeStringTree
+//
+// Input   : None.
+// Output  : timings, The time taken by the inserts and lookups, and the
+//                    lookups that did not return the expected record.
+// Return  : OK, or FAIL if the index could not be built.
+//-------------------------------------------------------------------
+Status IntKeyBench::TimeStringTree(Timings &timings)
+{
+	Status status;
+	BTreeFile *btf = new BTreeFile(status, "strkeybench");
+	if (status != OK) {
+		cerr << "*** Could not create the string key index" << endl;
+		return FAIL;
+	}
+
+	char key[MAX_KEY_LENGTH];
+	clock_t start = clock();
+	for (int i = 0; i < numOfKeys; i++) {
+		RecordID rid;
+		sprintf(key, "%08d", insertOrder[i]);
+		rid.pageNo = insertOrder[i];
+		rid.slotNo = 0;
+		if (btf->Insert(key, rid) != OK) {
+			cerr << "*** Inserting key " << key << " failed" << endl;
+			btf->DestroyFile();
+			delete btf;
+			return FAIL;
+		}
+	}
+	timings.insertTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	timings.numOfMisses = 0;
+	start = clock();
+	for (int i = 0; i < numOfLookups; i++) {
+		RecordID rid;
+		char *foundKey;
+		sprintf(key, "%08d", lookupKeys[i]);
+		BTreeFileScan *scan = btf->OpenScan(key, key);
+		if (scan == NULL || scan->GetNext(rid, foundKey) != OK || rid.pageNo != lookupKeys[i]) {
+			timings.numOfMisses++;
+		}
+		delete scan;
+	}
+	timings.lookupTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	btf->DestroyFile();
+	delete btf;
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// IntKeyBench::TimeIntTree
+//
+// Input   : None.
+// Output  : timings, The time taken by the inserts and lookups, and the
+//                    lookups that did not return the expected record.
+// Return  : OK, or FAIL if the index could not be built.
+//-------------------------------------------------------------------
+template<typename KeyType>
+Status IntKeyBench::TimeIntTree(Timings &timings)
+{
+	Status status;
+	IntBTreeFile<KeyType> *btf = new IntBTreeFile<KeyType>(status, "intkeybench");
+	if (status != OK) {
+		cerr << "*** Could not create the integer key index" << endl;
+		return FAIL;
+	}
+
+	clock_t start = clock();
+	for (int i = 0; i < numOfKeys; i++) {
+		RecordID rid;
+		rid.pageNo = insertOrder[i];
+		rid.slotNo = 0;
+		if (btf->Insert(MakeKey<KeyType>(insertOrder[i]), rid) != OK) {
+			cerr << "*** Inserting key " << insertOrder[i] << " failed" << endl;
+			btf->DestroyFile();
+			delete btf;
+			return FAIL;
+		}
+	}
+	timings.insertTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	timings.numOfMisses = 0;
+	start = clock();
+	for (int i = 0; i < numOfLookups; i++) {
+		RecordID rid;
+		KeyType key = MakeKey<KeyType>(lookupKeys[i]);
+		KeyType foundKey;
+		typename IntBTreeFile<KeyType>::Scan *scan = btf->OpenScan(&key, &key);
+		if (scan == NULL || scan->GetNext(rid, foundKey) != OK || rid.pageNo != lookupKeys[i]) {
+			timings.numOfMisses++;
+		}
+		delete scan;
+	}
+	timings.lookupTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	btf->DestroyFile();
+	delete btf;
+	return OK;
+}
+
+Status IntKeyBench::RunBenchmarks()
+{
+	if (OpenBenchDB("INTKEYBENCH", numOfDBPages, numOfBufs) != OK) {
+		return FAIL;
+	}
+
+	cout << "\nRunning integer key benchmarks...\n" << endl;
+
+	// Every tree gets the same keys in the same random order, and the
+	// same lookups.
+	insertOrder = new int[numOfKeys];
+	for (int i = 0; i < numOfKeys; i++) {
+		insertOrder[i] = i;
+	}
+	srand(1);
+	Shuffle(insertOrder, numOfKeys);
+	lookupKeys = new int[numOfLookups];
+	for (int i = 0; i < numOfLookups; i++) {
+		lookupKeys[i] = RandomInt(numOfKeys);
+	}
+
+	cout << "  " << numOfKeys << " keys inserted in random order, then "
+		 << numOfLookups << " point lookups\n" << endl;
+	cout << "  index                     inserts/s     lookups/s     misses" << endl;
+
+	const char *names[] = { "BTreeFile, %08d strings", "IntBTreeFile<int>", "IntBTreeFile<long long>" };
+	for (int which = 0; which < 3; which++) {
+		Timings timings;
+		Status status;
+		if (which == 0) {
+			status = TimeStringTree(timings);
+		}
+		else if (which == 1) {
+			status = TimeIntTree<int>(timings);
+		}
+		else {
+			status = TimeIntTree<long long>(timings);
+		}
+
+		if (status == OK) {
+			printf("  %-24s  %-12.0f  %-12.0f  %d\n", names[which],
+				   numOfKeys / timings.insertTime, numOfLookups / timings.lookupTime,
+				   timings.numOfMisses);
+		}
+	}
+
+	cout << "\n...integer key benchmarks completed.\n" << endl;
+
+	delete [] insertOrder;
+	delete [] lookupKeys;
+	CloseBenchDB("INTKEYBENCH");
+	return OK;
+}
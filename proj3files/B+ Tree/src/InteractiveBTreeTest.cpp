@@ -82,7 +82,8 @@ Status InteractiveBTreeTest::RunTests(istream &in)
 	remove(logname);
 
 	Status status;
-	minibase_globals = new SystemDefs(status, dbname, logname, 1000, 500, 200);
+	// Test 7 builds a tree of about 5000 pages.
+	minibase_globals = new SystemDefs(status, dbname, logname, 10000, 500, 200);
 
 	if (status != OK) {
 		cerr << "ERROR: Couldn'initialize the Minibase globals" << std::endl;
@@ -170,6 +171,9 @@ Status InteractiveBTreeTest::RunTests(istream &in)
 					case 6:
 						testSuccess = BTreeDriver::TestDeleteCurrent();
 						break;
+					case 7:
+						testSuccess = BTreeDriver::TestDeepTree();
+						break;
 					default:
 						cout << "Unrecognized test: " << testNum << endl;
 					}
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <iostream>
+#include <vector>
+
+#include "bufmgr.h"
+#include "BTreeFile.h"
+#include "BenchUtil.h"
+#include "PrefixKeyBench.h"
+
+using namespace std;
+
+static const int numOfKeys = 1000000;
+static const int numOfLookups = 1000000;
+static const int numOfTenants = 50;
+
+// The tree takes about 30000 pages. The buffer pool holds all of it so
+// that lookups are not timed against the disk.
+static const int numOfDBPages = 100000;
+static const int numOfBufs = 100000;
+
+//-------------------------------------------------------------------
+// MakeKey
+//
+// Input   : k, A number below numOfKeys.
+// Output  : key, A path-like key for k. Keys of one tenant share a
+//                27 byte prefix, and sort by k within the tenant.
+// Return  : None.
+//-------------------------------------------------------------------
+static void MakeKey(int k, char *key)
+{
+	sprintf(key, "tenant-%04d/eu-west/orders/%08d", k % numOfTenants, k);
+}
+
+//-------------------------------------------------------------------
+// PrefixKeyBench::CollectStats
+//
+// Input   : pid,   A page of the tree.
+//           level, The depth of the page, 0 for the root.
+// Output  : None.
+// Return  : OK, or FAIL if a page could not be pinned.
+// Purpose : Add the page to the statistics of its level, then visit the
+//           pages below it, leftmost first.
+//-------------------------------------------------------------------
+Status PrefixKeyBench::CollectStats(PageID pid, int level)
+{
+	if (level >= MAX_LEVELS) {
+		cerr << "*** The tree is deeper than " << (int)MAX_LEVELS << " levels" << endl;
+		return FAIL;
+	}
+	if (level >= height) {
+		memset(&levels[level], 0, sizeof(LevelStats));
+		height = level + 1;
+	}
+
+	Page *page;
+	PIN(pid, page);
+
+	LevelStats &stats = levels[level];
+	stats.numOfPages++;
+	stats.usedBytes += HEAPPAGE_DATA_SIZE - ((ResizableRecordPage *)page)->AvailableSpaceForAppend();
+
+	vector<PageID> children;
+	char *key;
+
+	if (((ResizableRecordPage *)page)->GetType() == INDEX_PAGE) {
+		IndexPage *indexPage = (IndexPage *)page;
+		PageKVScan<PageID> scan;
+		PageID child;
+
+		children.push_back(indexPage->GetPrevPage());
+		indexPage->OpenScan(&scan);
+		while (scan.GetNext(key, child) == OK) {
+			stats.numOfEntries++;
+			stats.keyBytes += strlen(key);
+			children.push_back(child);
+		}
+	}
+	else {
+		LeafPage *leafPage = (LeafPage *)page;
+		PageKVScan<RecordID> scan;
+		RecordID rid;
+
+		leafPage->OpenScan(&scan);
+		while (scan.GetNext(key, rid) == OK) {
+			stats.numOfEntries++;
+			stats.keyBytes += strlen(key);
+		}
+	}
+
+	UNPIN(pid, CLEAN);
+
+	for (unsigned int i = 0; i < children.size(); i++) {
+		if (CollectStats(children[i], level + 1) != OK) {
+			return FAIL;
+		}
+	}
+	return OK;
+}
+
+Status PrefixKeyBench::RunBenchmarks()
+{
+	if (OpenBenchDB("PREFIXBENCH", numOfDBPages, numOfBufs) != OK) {
+		return FAIL;
+	}
+
+	Status status;
+	BTreeFile *btf = new BTreeFile(status, "prefixbench");
+	if (status != OK) {
+		cerr << "*** Could not create the benchmark index" << endl;
+		CloseBenchDB("PREFIXBENCH");
+		return FAIL;
+	}
+
+	cout << "\nRunning prefix-heavy key benchmarks...\n" << endl;
+
+	// Insert the keys in random order, which leaves pages about two
+	// thirds full, as ordinary inserts would.
+	int *order = new int[numOfKeys];
+	for (int i = 0; i < numOfKeys; i++) {
+		order[i] = i;
+	}
+	srand(1);
+	Shuffle(order, numOfKeys);
+
+	char key[MAX_KEY_LENGTH];
+	clock_t start = clock();
+	for (int i = 0; i < numOfKeys; i++) {
+		RecordID rid;
+		MakeKey(order[i], key);
+		rid.pageNo = order[i];
+		rid.slotNo = 0;
+		if (btf->Insert(key, rid) != OK) {
+			cerr << "*** Inserting key " << key << " failed" << endl;
+			break;
+		}
+	}
+	double insertTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+	delete [] order;
+
+	MakeKey(0, key);
+	cout << "  " << numOfKeys << " keys such as " << key << ", inserted in "
+		 << insertTime << " seconds\n" << endl;
+
+	height = 0;
+	if (CollectStats(btf->header->GetRootPageID(), 0) == OK) {
+		cout << "  tree height: " << height << "\n" << endl;
+		cout << "  level  pages     entries/page  key bytes  bytes/entry  full-key bytes/entry" << endl;
+
+		for (int i = 0; i < height; i++) {
+			LevelStats &stats = levels[i];
+			int valueLength = (i < height - 1) ? sizeof(PageID) : sizeof(RecordID);
+			double entries = stats.numOfEntries > 0 ? stats.numOfEntries : 1;
+
+			// An entry with the key stored whole takes the key, its '\0',
+			// one value and one slot.
+			printf("  %-5d  %-8d  %-12.1f  %-9.1f  %-11.1f  %.1f\n",
+				   i, stats.numOfPages, stats.numOfEntries / (double)stats.numOfPages,
+				   stats.keyBytes / entries, stats.usedBytes / entries,
+				   stats.keyBytes / entries + 1 + valueLength + 4);
+		}
+	}
+
+	int numOfMisses = 0;
+	srand(2);
+	start = clock();
+	for (int i = 0; i < numOfLookups; i++) {
+		BTreeFileScan *scan;
+		RecordID rid;
+		char *foundKey;
+		int k = RandomInt(numOfKeys);
+
+		MakeKey(k, key);
+		scan = btf->OpenScan(key, key);
+		if (scan == NULL || scan->GetNext(rid, foundKey) != OK || rid.pageNo != k) {
+			numOfMisses++;
+		}
+		delete scan;
+	}
+	double lookupTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("\n  %d point lookups: %.2f seconds, %.2f us per lookup, %d misses\n",
+		   numOfLookups, lookupTime, lookupTime * 1000000 / numOfLookups, numOfMisses);
+
+	cout << "\n...prefix-heavy key benchmarks completed.\n" << endl;
+
+	btf->DestroyFile();
+	delete btf;
+	CloseBenchDB("PREFIXBENCH");
+	return OK;
+}
@@ -15,7 +15,10 @@
 Status ResizableRecordPage::AppendToRecord(const char *newData, int dataLength, const RecordID &rid)
 {
 	// Invalid record id.
-	if (rid.pageNo != pid || (rid.slotNo < 0 || rid.slotNo > numOfSlots)) {
+	if (rid.pageNo != pid || (rid.slotNo < 0 || rid.slotNo >= numOfSlots)) {
+		return FAIL;
+	}
+	if (SlotIsEmpty(GetFirstSlotPointer() - rid.slotNo)) {
 		return FAIL;
 	}
 
@@ -37,11 +40,11 @@ Status ResizableRecordPage::AppendToRecord(const char *newData, int dataLength,
 	slot->length += dataLength;
 
 	//	Change the offset of all slots pointing to pages after the one we modified.
+	//	Pages of a heap file may have empty slots, which are skipped.
 	for (int i = 0; i < numOfSlots; i++) {
-		assert(!SlotIsEmpty(GetFirstSlotPointer() - i));
 		Slot *curSlot = GetFirstSlotPointer() - i;
 
-		if (curSlot->offset > slot->offset) {
+		if (!SlotIsEmpty(curSlot) && curSlot->offset > slot->offset) {
 			curSlot->offset += dataLength;
 		}
 	}
@@ -76,6 +79,9 @@ Status ResizableRecordPage::CutFromRecord(int relativeStartOffset,
 	}
 
 	Slot *slot = GetFirstSlotPointer() - rid.slotNo;
+	if (SlotIsEmpty(slot)) {
+		return FAIL;
+	}
 
 
 	// Use the DeleteRecord method to cut the entire record.
@@ -103,15 +109,57 @@ Status ResizableRecordPage::CutFromRecord(int relativeStartOffset,
 
 	slot->length -= length;
 
-	// Update offsets for slots following deleted region.
+	// Update offsets for slots following deleted region, skipping empty slots.
 	for (int k = 0; k < numOfSlots; k++) {
-		assert(!SlotIsEmpty(GetFirstSlotPointer() - k));
 		Slot *curSlot = GetFirstSlotPointer() - k;
 
-		if (curSlot->offset > slot->offset) {
+		if (!SlotIsEmpty(curSlot) && curSlot->offset > slot->offset) {
 			curSlot->offset -= length;
 		}
 	}
 
 	return OK;
-}
\ No newline at end of file
+}
+
+
+//-------------------------------------------------------------------
+// ResizableRecordPage::ResizeRecord
+//
+// Input   : rid,       The record id of the record to replace.
+//           newData,   A pointer to the new contents of the record.
+//           newLength, The length of the new contents, at least 1.
+// Output  : None.
+// Return  : OK    if successful.
+//           FAIL  if rid is invalid or a longer record does not fit
+//                 on this page, in which case the page is unchanged.
+// Purpose : Replaces a record in place, growing it with AppendToRecord
+//           or shrinking it with CutFromRecord, so that the record
+//           keeps its slot and the other records are shifted around it.
+//-------------------------------------------------------------------
+Status ResizableRecordPage::ResizeRecord(const RecordID &rid, const char *newData, int newLength)
+{
+	if (rid.pageNo != pid || rid.slotNo < 0 || rid.slotNo >= numOfSlots || newLength <= 0) {
+		return FAIL;
+	}
+
+	Slot *slot = GetFirstSlotPointer() - rid.slotNo;
+	if (SlotIsEmpty(slot)) {
+		return FAIL;
+	}
+
+	int oldLength = slot->length;
+	if (newLength > oldLength) {
+		if (AppendToRecord(newData + oldLength, newLength - oldLength, rid) != OK) {
+			return FAIL;
+		}
+		memcpy(data + slot->offset, newData, oldLength);
+	}
+	else {
+		if (newLength < oldLength && CutFromRecord(newLength, oldLength - newLength, rid) != OK) {
+			return FAIL;
+		}
+		memcpy(data + slot->offset, newData, newLength);
+	}
+
+	return OK;
+}
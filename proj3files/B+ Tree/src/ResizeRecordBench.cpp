@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <iostream>
+
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "BenchUtil.h"
+#include "ResizeRecordBench.h"
+
+using namespace std;
+
+static const int numOfRecords = 20000;
+static const int numOfUpdates = 200000;
+static const int initialLength = 32;
+static const int maxLength = 1000;		// A record this long shrinks back to initialLength.
+
+static const int numOfDBPages = 20000;
+static const int numOfBufs = numOfDBPages;	// Holds the whole database, so no update waits for the disk.
+
+//-------------------------------------------------------------------
+// ResizeRecordBench::TimeUpdates
+//
+// Input   : useResize, Whether to update with ResizeRecord.
+// Output  : numOfRidChanges, Updates that changed a record's id, each
+//                            of which an index on the file would have
+//                            to follow.
+//           numOfFailures,   Updates that could not be done.
+// Return  : The time taken in seconds.
+// Purpose : Insert numOfRecords short records, then grow randomly
+//           chosen records by 8 to 64 bytes at a time. Without
+//           useResize each update deletes the record and inserts the
+//           new version, which is how a length change is done with the
+//           library's UpdateRecord.
+//-------------------------------------------------------------------
+double ResizeRecordBench::TimeUpdates(bool useResize, int &numOfRidChanges, int &numOfFailures)
+{
+	Status status;
+	HeapFile file("resizebench", status);
+
+	RecordID *rids = new RecordID[numOfRecords];
+	int *lengths = new int[numOfRecords];
+	char rec[maxLength + 64];
+	memset(rec, 'x', sizeof(rec));
+
+	for (int i = 0; i < numOfRecords; i++) {
+		lengths[i] = initialLength;
+		file.InsertRecord(rec, lengths[i], rids[i]);
+	}
+
+	numOfRidChanges = 0;
+	numOfFailures = 0;
+	srand(1);
+
+	clock_t start = clock();
+	for (int u = 0; u < numOfUpdates; u++) {
+		int i = (int)(((long long)rand() * (RAND_MAX + 1LL) + rand()) % numOfRecords);
+		int length = lengths[i] + 8 + rand() % 57;
+		if (length > maxLength) {
+			length = initialLength;
+		}
+
+		if (useResize) {
+			status = file.ResizeRecord(rids[i], rec, length);
+		}
+		else {
+			RecordID newRid;
+			status = file.DeleteRecord(rids[i]);
+			if (status == OK) {
+				status = file.InsertRecord(rec, length, newRid);
+			}
+			if (status == OK && !(newRid == rids[i])) {
+				rids[i] = newRid;
+				numOfRidChanges++;
+			}
+		}
+
+		if (status == OK) {
+			lengths[i] = length;
+		}
+		else {
+			numOfFailures++;
+		}
+	}
+	clock_t end = clock();
+
+	// Every record must still be readable under its id.
+	for (int i = 0; i < numOfRecords; i++) {
+		int length = sizeof(rec);
+		if (file.FetchRecord(rids[i], rec, length) != OK || length != lengths[i]) {
+			cerr << "*** Record " << i << " was not updated correctly" << endl;
+			break;
+		}
+	}
+
+	file.DeleteFile();
+	delete [] rids;
+	delete [] lengths;
+	return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+Status ResizeRecordBench::RunBenchmarks()
+{
+	if (OpenBenchDB("RESIZEBENCH", numOfDBPages, numOfBufs) != OK) {
+		return FAIL;
+	}
+
+	cout << "\nRunning heap file update benchmarks...\n" << endl;
+	cout << "  " << numOfUpdates << " updates of " << numOfRecords << " records growing from "
+		 << initialLength << " to " << maxLength << " bytes\n" << endl;
+	cout << "  update                    seconds   updates/s     rid changes  failed" << endl;
+
+	for (int useResize = 0; useResize <= 1; useResize++) {
+		int numOfRidChanges, numOfFailures;
+		double time = TimeUpdates(useResize != 0, numOfRidChanges, numOfFailures);
+		printf("  %-24s  %-8.2f  %-12.0f  %-11d  %d\n",
+			   useResize ? "HeapFile::ResizeRecord" : "delete and insert",
+			   time, numOfUpdates / time, numOfRidChanges, numOfFailures);
+	}
+
+	cout << "\n...heap file update benchmarks completed.\n" << endl;
+
+	CloseBenchDB("RESIZEBENCH");
+	return OK;
+}
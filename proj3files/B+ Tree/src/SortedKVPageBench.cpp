@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <iostream>
+
+#include "bufmgr.h"
+#include "BTreeFile.h"
+#include "BenchUtil.h"
+#include "SortedKVPageBench.h"
+
+using namespace std;
+
+static const int numOfPageLookups = 2000000;
+
+static const int numOfTreeKeys = 10000000;
+static const int numOfTreeLookups = 1000000;
+
+// About 21 bytes per leaf entry at two thirds full, plus the index
+// levels. The buffer pool holds the whole tree so that lookups are not
+// timed against the disk.
+static const int numOfDBPages = 600000;
+static const int numOfBufs = 600000;
+
+enum { LINEAR_DESCENT, SEARCH_DESCENT, OPEN_SCAN };
+
+//-------------------------------------------------------------------
+// MakeKey
+//
+// Input   : k, A number.
+// Output  : key, The key for k, zero padded so that keys sort
+//                numerically.
+// Return  : None.
+//-------------------------------------------------------------------
+static void MakeKey(int k, char *key)
+{
+	sprintf(key, "%08d", k);
+}
+
+//-------------------------------------------------------------------
+// LinearSearch
+//
+// Input   : page, A sorted page.
+//           key,  The key to look for.
+// Output  : val, The first value of the largest key on the page that
+//                is not greater than key.
+// Return  : OK   if key is on the page.
+//           DONE if key is not, but a smaller key is.
+//           FAIL if every key on the page is greater than key.
+// Purpose : Does what SortedKVPage::Search did before it used binary
+//           search: walk the page from its smallest key until a larger
+//           key is seen.
+//-------------------------------------------------------------------
+template<typename ValType>
+static Status LinearSearch(SortedKVPage<ValType> *page, const char *key, ValType &val)
+{
+	PageKVScan<ValType> scan;
+	char *nextKey;
+	char lastKey[MAX_KEY_LENGTH];
+	ValType nextVal;
+	Status status = FAIL;
+
+	page->OpenScan(&scan);
+	while (scan.GetNext(nextKey, nextVal) == OK) {
+		int cmp = strcmp(nextKey, key);
+		if (cmp > 0) {
+			break;
+		}
+		// The scan may return every key in the same buffer.
+		if (status == FAIL || strcmp(lastKey, nextKey) != 0) {
+			strcpy(lastKey, nextKey);
+			val = nextVal;
+			status = (cmp == 0) ? OK : DONE;
+		}
+	}
+	return status;
+}
+
+//-------------------------------------------------------------------
+// SortedKVPageBench::TimePageLookups
+//
+// Input   : useSearch, Whether to look keys up with SortedKVPage::Search
+//                      rather than LinearSearch.
+// Output  : numOfKeys, The number of keys on the page.
+// Return  : The time taken in seconds.
+// Purpose : Fill a leaf page with random keys, then look up
+//           numOfPageLookups keys, every other one of which is on the
+//           page.
+//-------------------------------------------------------------------
+double SortedKVPageBench::TimePageLookups(bool useSearch, int &numOfKeys)
+{
+	Page page;
+	LeafPage *leaf = (LeafPage *)&page;
+	leaf->Init(0, LEAF_PAGE);
+
+	char key[MAX_KEY_LENGTH];
+	RecordID rid;
+	rid.pageNo = 0;
+	rid.slotNo = 0;
+
+	srand(1);
+	numOfKeys = 0;
+	while (true) {
+		MakeKey(RandomInt(numOfTreeKeys) * 2, key);
+		if (leaf->Insert(key, rid) != OK) {
+			break;
+		}
+		numOfKeys++;
+	}
+
+	char **keys = new char *[numOfPageLookups];
+	for (int i = 0; i < numOfPageLookups; i++) {
+		keys[i] = new char[MAX_KEY_LENGTH];
+		MakeKey(RandomInt(2 * numOfTreeKeys), keys[i]);
+	}
+
+	int numOfFound = 0;
+	clock_t start = clock();
+	for (int i = 0; i < numOfPageLookups; i++) {
+		Status status;
+		if (useSearch) {
+			PageKVScan<RecordID> scan;
+			char *foundKey;
+			status = leaf->Search(keys[i], scan);
+			if (status != FAIL) {
+				scan.GetNext(foundKey, rid);
+			}
+		}
+		else {
+			status = LinearSearch(leaf, keys[i], rid);
+		}
+
+		if (status == OK) {
+			numOfFound++;
+		}
+	}
+	clock_t end = clock();
+
+	if (numOfFound == 0) {
+		cerr << "*** No key was found on the page" << endl;
+	}
+
+	for (int i = 0; i < numOfPageLookups; i++) {
+		delete [] keys[i];
+	}
+	delete [] keys;
+	return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+//-------------------------------------------------------------------
+// SortedKVPageBench::TimeTreeLookups
+//
+// Input   : btf, A tree holding the first numOfTreeKeys even keys.
+//           how, LINEAR_DESCENT or SEARCH_DESCENT to descend from the
+//                root one page at a time with LinearSearch or
+//                SortedKVPage::Search, OPEN_SCAN to open an exact match
+//                scan per key.
+// Output  : numOfMisses, Lookups that did not return the expected
+//                        record, which should only be the odd keys.
+// Return  : The time taken in seconds.
+//-------------------------------------------------------------------
+double SortedKVPageBench::TimeTreeLookups(BTreeFile *btf, int how, int &numOfMisses)
+{
+	int *keys = new int[numOfTreeLookups];
+	srand(2);
+	for (int i = 0; i < numOfTreeLookups; i++) {
+		keys[i] = RandomInt(2 * numOfTreeKeys);
+	}
+
+	numOfMisses = 0;
+	clock_t start = clock();
+	for (int i = 0; i < numOfTreeLookups; i++) {
+		char key[MAX_KEY_LENGTH];
+		RecordID rid;
+		Status status = FAIL;
+		MakeKey(keys[i], key);
+
+		if (how == OPEN_SCAN) {
+			BTreeFileScan *scan = btf->OpenScan(key, key);
+			char *foundKey;
+			if (scan != NULL) {
+				status = scan->GetNext(rid, foundKey);
+				delete scan;
+			}
+		}
+		else {
+			PageID pid = btf->header->GetRootPageID();
+			Page *page;
+			MINIBASE_BM->PinPage(pid, page);
+
+			while (((ResizableRecordPage *)page)->GetType() == INDEX_PAGE) {
+				IndexPage *indexPage = (IndexPage *)page;
+				PageID child;
+				Status found;
+				if (how == SEARCH_DESCENT) {
+					PageKVScan<PageID> scan;
+					char *foundKey;
+					found = indexPage->Search(key, scan);
+					if (found != FAIL) {
+						scan.GetNext(foundKey, child);
+					}
+				}
+				else {
+					found = LinearSearch(indexPage, key, child);
+				}
+				if (found == FAIL) {
+					child = indexPage->GetPrevPage();
+				}
+
+				MINIBASE_BM->UnpinPage(pid, CLEAN);
+				pid = child;
+				MINIBASE_BM->PinPage(pid, page);
+			}
+
+			LeafPage *leaf = (LeafPage *)page;
+			if (how == SEARCH_DESCENT) {
+				PageKVScan<RecordID> scan;
+				char *foundKey;
+				status = leaf->Search(key, scan);
+				if (status == OK) {
+					scan.GetNext(foundKey, rid);
+				}
+			}
+			else {
+				status = LinearSearch(leaf, key, rid);
+			}
+			MINIBASE_BM->UnpinPage(pid, CLEAN);
+		}
+
+		if (status != OK || rid.pageNo != keys[i]) {
+			numOfMisses++;
+		}
+	}
+	clock_t end = clock();
+
+	delete [] keys;
+	return (double)(end - start) / CLOCKS_PER_SEC;
+}
+
+Status SortedKVPageBench::RunBenchmarks()
+{
+	cout << "\nRunning sorted page lookup benchmarks...\n" << endl;
+	cout << "  " << numOfPageLookups << " lookups in one leaf page\n" << endl;
+	cout << "  search                    keys    seconds   lookups/s" << endl;
+
+	for (int useSearch = 0; useSearch <= 1; useSearch++) {
+		int numOfKeys;
+		double time = TimePageLookups(useSearch != 0, numOfKeys);
+		printf("  %-24s  %-6d  %-8.2f  %.0f\n",
+			   useSearch ? "SortedKVPage::Search" : "linear walk",
+			   numOfKeys, time, numOfPageLookups / time);
+	}
+
+	if (OpenBenchDB("KVPAGEBENCH", numOfDBPages, numOfBufs) != OK) {
+		return FAIL;
+	}
+
+	Status status;
+	BTreeFile *btf = new BTreeFile(status, "kvpagebench");
+	if (status != OK) {
+		cerr << "*** Could not create the benchmark index" << endl;
+		CloseBenchDB("KVPAGEBENCH");
+		return FAIL;
+	}
+
+	// Insert the even keys in random order, so that half of the lookups
+	// find their key and the pages are as full as a tree built by
+	// ordinary inserts would be.
+	int *order = new int[numOfTreeKeys];
+	for (int i = 0; i < numOfTreeKeys; i++) {
+		order[i] = i * 2;
+	}
+	srand(3);
+	Shuffle(order, numOfTreeKeys);
+
+	clock_t start = clock();
+	for (int i = 0; i < numOfTreeKeys; i++) {
+		char key[MAX_KEY_LENGTH];
+		RecordID rid;
+		MakeKey(order[i], key);
+		rid.pageNo = order[i];
+		rid.slotNo = 0;
+		if (btf->Insert(key, rid) != OK) {
+			cerr << "*** Inserting key " << key << " failed" << endl;
+			break;
+		}
+	}
+	clock_t end = clock();
+	delete [] order;
+
+	cout << "\n  " << numOfTreeLookups << " point lookups, half of them for keys that are not there, in a tree of "
+		 << numOfTreeKeys << " keys, built in "
+		 << (double)(end - start) / CLOCKS_PER_SEC << " seconds\n" << endl;
+	cout << "  lookup                    seconds   lookups/s     misses" << endl;
+
+	const char *names[] = { "linear walk descent", "SortedKVPage::Search", "BTreeFile::OpenScan" };
+	for (int how = LINEAR_DESCENT; how <= OPEN_SCAN; how++) {
+		int numOfMisses;
+		double time = TimeTreeLookups(btf, how, numOfMisses);
+		printf("  %-24s  %-8.2f  %-12.0f  %d\n",
+			   names[how], time, numOfTreeLookups / time, numOfMisses);
+	}
+
+	cout << "\n...sorted page lookup benchmarks completed.\n" << endl;
+
+	btf->DestroyFile();
+	delete btf;
+	CloseBenchDB("KVPAGEBENCH");
+	return OK;
+}
@@ -0,0 +1,321 @@
+#include <string.h>
+
+#include "bufmgr.h"
+#include "heapfile.h"
+#include "dirpage.h"
+#include "ResizableRecordPage.h"
+
+// A record that outgrows its page is moved to another page of the file, and
+// what is left in its slot is a stub pointing at the moved copy. The moved
+// copy starts with a header pointing back at the stub, so a stub is only
+// taken as one if the record it points at points back at it; a record that
+// merely looks like a stub is never followed.
+//
+// HeapFile::GetRecord and Scan come from the library and know nothing of
+// stubs: they return a stub as it is, and a moved copy with its header. A
+// file whose records are updated with ResizeRecord is read with FetchRecord
+// and emptied with RemoveRecord.
+
+#define FORWARD_STUB_MAGIC		0x46574453		// "FWDS"
+#define MOVED_RECORD_MAGIC		0x4D4F5644		// "MOVD"
+
+struct ForwardStub {
+	int magic;
+	RecordID target;	// Where the record has moved to.
+};
+
+struct MovedHeader {
+	int magic;
+	RecordID home;		// The slot holding the stub, which is the record's id.
+};
+
+
+//-------------------------------------------------------------------
+// IsForwardStub
+//
+// Input   : rid,    The record id of a record.
+//           rec,    The record.
+//           len,    Its length.
+// Output  : target, Where the record has moved to, if it is a stub.
+// Return  : true if the record is a stub whose target points back at it.
+//-------------------------------------------------------------------
+static bool IsForwardStub(const RecordID &rid, const char *rec, int len, RecordID &target)
+{
+	if (len != sizeof(ForwardStub)) {
+		return false;
+	}
+
+	ForwardStub stub;
+	memcpy(&stub, rec, sizeof(stub));
+	if (stub.magic != FORWARD_STUB_MAGIC) {
+		return false;
+	}
+
+	Page *page;
+	if (MINIBASE_BM->PinPage(stub.target.pageNo, page) != OK) {
+		return false;
+	}
+
+	char *moved;
+	int movedLen;
+	bool isStub = false;
+	if (((HeapPage *)page)->ReturnRecord(stub.target, moved, movedLen) == OK &&
+		movedLen >= (int)sizeof(MovedHeader)) {
+		MovedHeader header;
+		memcpy(&header, moved, sizeof(header));
+		isStub = header.magic == MOVED_RECORD_MAGIC && header.home == rid;
+	}
+	MINIBASE_BM->UnpinPage(stub.target.pageNo);
+
+	target = stub.target;
+	return isStub;
+}
+
+
+//-------------------------------------------------------------------
+// HeapFile::UpdatePageInfo
+//
+// Input   : pid,  A data page of this file.
+//           page, The page, pinned.
+// Output  : None.
+// Return  : OK    if successful.
+//           FAIL  if the page is not in the directory.
+// Purpose : Records the free space of a page changed in place, so that
+//           InsertRecord sees how much room it has.
+//-------------------------------------------------------------------
+Status HeapFile::UpdatePageInfo(PageID pid, HeapPage *page)
+{
+	PageID dirPid = GetFirstDirPage();
+	while (dirPid != INVALID_PAGE) {
+		Page *dirPage;
+		if (MINIBASE_BM->PinPage(dirPid, dirPage) != OK) {
+			return FAIL;
+		}
+
+		PageInfo *info = ((DirPage *)dirPage)->FindPageInfo(pid);
+		if (info != NULL) {
+			info->spaceAvailable = page->AvailableSpace();
+			MINIBASE_BM->UnpinPage(dirPid, true);
+			return OK;
+		}
+
+		PageID nextPid = ((DirPage *)dirPage)->GetNextPage();
+		MINIBASE_BM->UnpinPage(dirPid);
+		dirPid = nextPid;
+	}
+
+	return FAIL;
+}
+
+
+//-------------------------------------------------------------------
+// HeapFile::ResizeRecord
+//
+// Input   : rid,    The record id of the record to update.
+//           recPtr, The new contents of the record.
+//           recLen, The length of the new contents, which may differ
+//                   from the current one.
+// Output  : None.
+// Return  : OK    if successful.
+//           FAIL  if there is no such record or no room for it.
+// Purpose : Updates a record without changing its record id, unlike a
+//           delete followed by an insert. The record is resized in its
+//           slot if its page has room. Otherwise it moves to a page with
+//           room and a stub is left in the slot. A moved record is
+//           resized where it is if it still fits there, and moves back
+//           into its slot when it shrinks enough to fit.
+//-------------------------------------------------------------------
+Status HeapFile::ResizeRecord(const RecordID &rid, const char *recPtr, int recLen)
+{
+	if (recLen <= 0) {
+		return FAIL;
+	}
+
+	Page *page;
+	if (MINIBASE_BM->PinPage(rid.pageNo, page) != OK) {
+		return FAIL;
+	}
+	ResizableRecordPage *home = (ResizableRecordPage *)page;
+
+	char *cur;
+	int curLen;
+	if (home->ReturnRecord(rid, cur, curLen) != OK) {
+		MINIBASE_BM->UnpinPage(rid.pageNo);
+		return FAIL;
+	}
+
+	RecordID movedRid;
+	bool forwarded = IsForwardStub(rid, cur, curLen, movedRid);
+
+	// The record fits in its own slot.
+	if (home->ResizeRecord(rid, recPtr, recLen) == OK) {
+		Status status = UpdatePageInfo(rid.pageNo, home);
+		MINIBASE_BM->UnpinPage(rid.pageNo, true);
+		if (forwarded && DeleteRecord(movedRid) != OK) {
+			status = FAIL;
+		}
+		return status;
+	}
+
+	// The slot has to be able to hold a stub before the record can move.
+	if (!forwarded && curLen < (int)sizeof(ForwardStub) &&
+		home->AvailableSpaceForAppend() < (int)sizeof(ForwardStub) - curLen) {
+		MINIBASE_BM->UnpinPage(rid.pageNo);
+		return FAIL;
+	}
+	MINIBASE_BM->UnpinPage(rid.pageNo);
+
+	int movedLen = sizeof(MovedHeader) + recLen;
+	char *moved = new char[movedLen];
+	MovedHeader header;
+	header.magic = MOVED_RECORD_MAGIC;
+	header.home = rid;
+	memcpy(moved, &header, sizeof(header));
+	memcpy(moved + sizeof(header), recPtr, recLen);
+
+	// A record that has moved already is resized where it is, if it fits.
+	if (forwarded) {
+		if (MINIBASE_BM->PinPage(movedRid.pageNo, page) != OK) {
+			delete [] moved;
+			return FAIL;
+		}
+		ResizableRecordPage *movedPage = (ResizableRecordPage *)page;
+		if (movedPage->ResizeRecord(movedRid, moved, movedLen) == OK) {
+			Status status = UpdatePageInfo(movedRid.pageNo, movedPage);
+			MINIBASE_BM->UnpinPage(movedRid.pageNo, true);
+			delete [] moved;
+			return status;
+		}
+		MINIBASE_BM->UnpinPage(movedRid.pageNo);
+	}
+
+	// Move the record to a page with room, then point the stub at it. The
+	// old copy is only deleted once the new one is in place.
+	RecordID newRid;
+	Status status = InsertRecord(moved, movedLen, newRid);
+	delete [] moved;
+	if (status != OK) {
+		return FAIL;
+	}
+
+	ForwardStub stub;
+	stub.magic = FORWARD_STUB_MAGIC;
+	stub.target = newRid;
+
+	// Until the stub points at the new copy nothing else does, so the copy
+	// is deleted again if the stub cannot be written.
+	if (forwarded) {
+		// The stub keeps its length, which the library's UpdateRecord allows.
+		if (UpdateRecord(rid, (char *)&stub, sizeof(stub)) != OK) {
+			DeleteRecord(newRid);
+			return FAIL;
+		}
+		return DeleteRecord(movedRid);
+	}
+
+	if (MINIBASE_BM->PinPage(rid.pageNo, page) != OK) {
+		DeleteRecord(newRid);
+		return FAIL;
+	}
+	home = (ResizableRecordPage *)page;
+	bool stubbed = home->ResizeRecord(rid, (char *)&stub, sizeof(stub)) == OK;
+	status = stubbed ? UpdatePageInfo(rid.pageNo, home) : FAIL;
+	MINIBASE_BM->UnpinPage(rid.pageNo, stubbed);
+	if (!stubbed) {
+		DeleteRecord(newRid);
+	}
+	return status;
+}
+
+
+//-------------------------------------------------------------------
+// HeapFile::FetchRecord
+//
+// Input   : rid,    The record id of a record.
+//           recLen, The size of the buffer at recPtr.
+// Output  : recPtr, Receives a copy of the record.
+//           recLen, The length of the record.
+// Return  : OK    if successful.
+//           FAIL  if there is no such record, or it is longer than
+//                 the buffer.
+// Purpose : Same as GetRecord, but follows the stub of a record that
+//           ResizeRecord has moved.
+//-------------------------------------------------------------------
+Status HeapFile::FetchRecord(const RecordID &rid, char *recPtr, int &recLen)
+{
+	Page *page;
+	if (MINIBASE_BM->PinPage(rid.pageNo, page) != OK) {
+		return FAIL;
+	}
+
+	char *rec;
+	int len;
+	if (((HeapPage *)page)->ReturnRecord(rid, rec, len) != OK) {
+		MINIBASE_BM->UnpinPage(rid.pageNo);
+		return FAIL;
+	}
+
+	RecordID movedRid;
+	if (!IsForwardStub(rid, rec, len, movedRid)) {
+		Status status = FAIL;
+		if (len <= recLen) {
+			memcpy(recPtr, rec, len);
+			recLen = len;
+			status = OK;
+		}
+		MINIBASE_BM->UnpinPage(rid.pageNo);
+		return status;
+	}
+	MINIBASE_BM->UnpinPage(rid.pageNo);
+
+	if (MINIBASE_BM->PinPage(movedRid.pageNo, page) != OK) {
+		return FAIL;
+	}
+	Status status = ((HeapPage *)page)->ReturnRecord(movedRid, rec, len);
+	if (status == OK && len - (int)sizeof(MovedHeader) > recLen) {
+		status = FAIL;
+	}
+	if (status == OK) {
+		recLen = len - sizeof(MovedHeader);
+		memcpy(recPtr, rec + sizeof(MovedHeader), recLen);
+	}
+	MINIBASE_BM->UnpinPage(movedRid.pageNo);
+	return status;
+}
+
+
+//-------------------------------------------------------------------
+// HeapFile::RemoveRecord
+//
+// Input   : rid, The record id of a record.
+// Output  : None.
+// Return  : OK    if successful.
+//           FAIL  if there is no such record.
+// Purpose : Same as DeleteRecord, but also deletes the moved copy of a
+//           record that ResizeRecord has moved.
+//-------------------------------------------------------------------
+Status HeapFile::RemoveRecord(const RecordID &rid)
+{
+	Page *page;
+	if (MINIBASE_BM->PinPage(rid.pageNo, page) != OK) {
+		return FAIL;
+	}
+
+	char *rec;
+	int len;
+	if (((HeapPage *)page)->ReturnRecord(rid, rec, len) != OK) {
+		MINIBASE_BM->UnpinPage(rid.pageNo);
+		return FAIL;
+	}
+	RecordID movedRid;
+	bool forwarded = IsForwardStub(rid, rec, len, movedRid);
+	MINIBASE_BM->UnpinPage(rid.pageNo);
+
+	if (DeleteRecord(rid) != OK) {
+		return FAIL;
+	}
+	if (forwarded) {
+		return DeleteRecord(movedRid);
+	}
+	return OK;
+}
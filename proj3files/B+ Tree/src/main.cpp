@@ -3,6 +3,12 @@
 
 #include "SortedKVPage.h"
 #include "InteractiveBTreeTest.h"
+#include "ResizeRecordBench.h"
+#include "SortedKVPageBench.h"
+#include "PrefixKeyBench.h"
+#include "IntKeyBench.h"
+#include "BulkLoadBench.h"
+#include "InsertBench.h"
 
 int MINIBASE_RESTART_FLAG = 0;
 
@@ -20,6 +26,7 @@ void printHelp()
 	cout << "\tTest 4: Test a large workload." << endl;
 	cout << "\tTest 5: Test that everything gets unpinned from the buffer pool." << endl;
 	cout << "\tTest 6: Test that delete current works." << endl;
+	cout << "\tTest 7: Test a tree more than four index levels deep." << endl;
 	cout << "print"<<endl;
 	cout << "quit (not required)"<<endl;
 }
@@ -47,6 +54,24 @@ int main(int argc, char *argv[])
 {
 	int ret = btreeTestManual();
 
+	//ResizeRecordBench rrb;
+	//rrb.RunBenchmarks();
+
+	//SortedKVPageBench skvb;
+	//skvb.RunBenchmarks();
+
+	//PrefixKeyBench pkb;
+	//pkb.RunBenchmarks();
+
+	//IntKeyBench ikb;
+	//ikb.RunBenchmarks();
+
+	//BulkLoadBench blb;
+	//blb.RunBenchmarks();
+
+	//InsertBench ib;
+	//ib.RunBenchmarks();
+
 	std::cout << "Hit [enter] to continue..." << endl;
 	std::cin.get();
 
@@ -0,0 +1,23 @@
+#ifndef _REPLACER_BENCH_H_
+#define _REPLACER_BENCH_H_
+
+#include <iostream>
+using namespace std;
+
+#include "minirel.h"
+#include "replacer.h"
+
+// Compares replacement policies on a workload that mixes B+ tree point lookups
+// with a full scan of a heap file much larger than the buffer pool.
+class ReplacerBench
+{
+public:
+	bool RunAll();
+
+private:
+	// Replay the workload through a pool of numOfFrames frames managed by
+	// the given replacer, and print the hit ratios BufMgr would report.
+	void RunWorkload(const char *policy, Replacer *replacer, int numOfFrames);
+};
+
+#endif
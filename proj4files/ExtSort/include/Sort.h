@@ -1,10 +1,16 @@
 #ifndef __SORT__
 #define __SORT__
 
+#include <vector>
+
 #include "minirel.h"
 
 #define    PAGESIZE    MINIBASE_PAGESIZE
 
+class HeapFile;
+class TempFileSpace;
+class TempFileScan;
+
 class Sort
 {
 public:
@@ -30,23 +36,36 @@ public:
 		 Status     &s
 		);
 
-	~Sort() {}
+	~Sort();
+
+	// Number of temporary runs written by the given pass. A pass that
+	// writes the output file directly has none.
+	int GetNumOfRuns(int pass);
+
+	// Number of records in the given temporary run, or -1 if the pass did
+	// not write that run.
+	int GetNumOfRunRecords(int pass, int run);
 
 private:
 	//Used during pass 0
 	Status TransferToHeapFile(char *unsortedMemory, int run, int numElements, bool out);
 
-	Status PassZero(int &numTempFiles);
+	Status PassZero(int &numTempFiles, int &firstRun);
 
-	Status PassOneAndBeyond(int numFilesIn, int pass, int &numFilesOut);
+	Status PassOneAndBeyond(int numFilesIn, int firstRunIn, int pass, int &numFilesOut, int &firstRunOut);
 
-	Status MergeManyToOne(unsigned int numPages, Scan **scans, HeapFile *newOut);
+	Status MergeManyToOne(unsigned int numPages, TempFileScan **scans, int outRun, HeapFile *newOut);
 
 	Status OneMergePass(int numStartFiles, int numPass, int &numEndFiles);
 
-	static char *CreateTempFilename(char *filename, int pass, int run);
-
 private:
+	// Temporary runs live in an anonymous file space rather than in the
+	// directory of the database, and are all released when the sort ends.
+	TempFileSpace *_tempSpace;
+
+	// Number of records in each temporary run, by pass.
+	std::vector< std::vector<int> > _runRecords;
+
 	int _recLength;
 	int _numBufPages;
 	char *_inFile;
@@ -0,0 +1,25 @@
+#ifndef _SORT_BENCH_H_
+#define _SORT_BENCH_H_
+
+#include <iostream>
+using namespace std;
+
+#include "minirel.h"
+
+class Sort;
+
+// Measures what keeping the temporary runs of Sort out of the directory of
+// the database saves, on the TestMulMerge workload scaled to a million records.
+class SortBench
+{
+public:
+	bool RunAll();
+
+private:
+	// Create, reopen and delete a named heap file for every temporary run
+	// the sort wrote, the directory work each run cost when runs were named
+	// "<outFile>.sort.temp.<pass>.<run>". Returns the time taken in seconds.
+	double ReplayNamedRuns(Sort &sort, const char *outFile);
+};
+
+#endif
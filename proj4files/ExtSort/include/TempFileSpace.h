@@ -0,0 +1,95 @@
+#ifndef _TEMP_FILE_SPACE_H_
+#define _TEMP_FILE_SPACE_H_
+
+#include <vector>
+
+#include "minirel.h"
+#include "db.h"
+
+class TempFileScan;
+
+// TempFileSpace is a namespace of anonymous, fixed-length record files for
+// the temporary runs of a sort.
+//
+// A temporary file is identified by a small integer rather than a name, so it
+// never has an entry in the directory of the database: creating one is an
+// in-memory operation, and ReserveFiles hands out the ids of a whole merge pass
+// in one call. The pages of the files are taken from the database in extents
+// of EXTENT_SIZE pages, pages of deleted files are reused before a new extent
+// is allocated, and ReleaseAll gives every extent back to the database. Both
+// go through MINIBASE_BM, so no frame outlives the page it caches.
+//
+// Records are packed PAGESIZE / recLength to a page with no page header; the
+// list of pages of each file is kept in memory.
+class TempFileSpace
+{
+	friend class TempFileScan;
+
+public:
+	TempFileSpace(int recLength);
+	~TempFileSpace();
+
+	// Reserve numOfFiles empty files with consecutive ids starting at firstId.
+	Status ReserveFiles(int numOfFiles, int &firstId);
+
+	// Append numOfRecs records, stored contiguously at recPtr, to a file.
+	Status Append(int id, const char *recPtr, int numOfRecs);
+
+	// Return the pages of a file to the space. The id is not reused.
+	Status DeleteFile(int id);
+
+	// Delete every file and deallocate every extent.
+	Status ReleaseAll();
+
+	int GetNumOfRecords(int id);
+
+	TempFileScan *OpenScan(int id, Status &status);
+
+private:
+	enum { EXTENT_SIZE = 64 };
+
+	struct TempFile
+	{
+		std::vector<PageID> pages;
+		int numOfRecords;
+	};
+
+	struct Extent
+	{
+		PageID start;
+		int size;
+	};
+
+	int recLength;
+	int recsPerPage;
+
+	std::vector<TempFile> files;
+	std::vector<Extent> extents;
+	std::vector<PageID> freePages;	// Pages of deleted files.
+	PageID nextPage;				// Next unused page of the last extent.
+	int numOfPagesLeft;				// Unused pages left in the last extent.
+
+	bool IsValid(int id);
+	Status NewPage(PageID &pid);
+};
+
+// Returns the records of a temporary file in the order they were appended.
+// The page holding the next record stays pinned until the scan moves past it.
+class TempFileScan
+{
+public:
+	TempFileScan(TempFileSpace *space, int id);
+	~TempFileScan();
+
+	// Copy the next record to recPtr. Returns DONE after the last record.
+	Status GetNext(char *recPtr);
+
+private:
+	TempFileSpace *space;
+	int id;
+	int pageNo;			// Index of the current page in the file.
+	int recNo;			// Index of the next record in the file.
+	char *page;			// The current page, NULL if it is not pinned.
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef _ARRAY_LRU_H
+#define _ARRAY_LRU_H
+
+#include "db.h"
+#include "replacer.h"
+
+// Least recently used replacement. The candidates form a doubly linked list
+// threaded through arrays indexed by frame number, so adding, removing and
+// picking a frame are all O(1) and do not allocate after construction. The
+// LRU class in lru.h is the one the prebuilt BufMgr is compiled against,
+// and stays as it is.
+class ArrayLRU : public Replacer
+{
+private:
+	int *prev;		// Previous (less recently used) frame, or INVALID_FRAME.
+	int *next;		// Next (more recently used) frame, or INVALID_FRAME.
+	bool *inList;	// Whether the frame is currently a candidate.
+	int capacity;	// Number of frames in the buffer pool.
+
+	int first;		// Least recently used frame, or INVALID_FRAME.
+	int last;		// Most recently used frame, or INVALID_FRAME.
+	int numFrames;	// Number of frames in the list.
+
+	bool IsPresent(int f);
+	bool IsEmpty();
+	void Unlink(int f);
+
+public:
+	ArrayLRU(int numOfFrames);
+	~ArrayLRU();
+	virtual int PickVictim();
+	virtual void AddFrame(int f);
+	virtual void RemoveFrame(int f);
+
+};
+
+#endif
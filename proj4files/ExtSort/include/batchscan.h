@@ -0,0 +1,50 @@
+#ifndef _BATCHSCAN_H_
+#define _BATCHSCAN_H_
+
+#include "minirel.h"
+#include "heappage.h"
+
+class HeapFile;
+
+// A record returned by BatchScan: its id and where it lies on the pinned page.
+struct ScanRecord
+{
+	RecordID rid;
+	char *recPtr;
+	int length;
+};
+
+// BatchScan returns the records of a heap file a page at a time.
+//
+// Each call to GetNextBatch pins the next data page once and describes every
+// record on it, without copying any of them. The records stay valid until the
+// next call or until the scan is deleted, which is when the page is unpinned.
+// The directory is read a directory page at a time, so a data page costs one
+// pin. Records come in slot order within a page.
+class BatchScan
+{
+public:
+
+	BatchScan(HeapFile *hf, Status &status);
+	~BatchScan();
+
+	// Describe the records of the next page that has any. Returns DONE
+	// when there are no more pages.
+	Status GetNextBatch(ScanRecord *&records, int &numOfRecords);
+
+private:
+
+	// Read the data pages of the next directory page into pids.
+	Status NextDirPage();
+
+	PageID nextDirPid;		// Directory page to read next, INVALID_PAGE at the end.
+	PageID *pids;			// Data pages of the current directory page.
+	int numOfPids;
+	int nextEntry;			// Next data page to return from pids.
+	int pidsCapacity;
+
+	PageID pinnedPid;		// Data page of the current batch, INVALID_PAGE if none.
+	ScanRecord records[HEAPPAGE_DATA_SIZE / 4 + 1];
+};
+
+#endif
@@ -10,10 +10,12 @@
 #define PERMENANT 1
 
 class HeapPage;
+class DirPage;
 
 class HeapFile
 {
 	friend class Scan;
+	friend class BatchScan;
 
 private :
 
@@ -30,6 +32,9 @@ private :
 		return dirPid;
 	}
 
+	// Append a directory page after the pinned last one, which is unpinned.
+	Status AppendDirPage(PageID &lastPid, DirPage *&lastPage);
+
 
 public:
 
@@ -38,10 +43,12 @@ public:
 
 	int GetNumOfRecords();
 	Status InsertRecord(char *recPtr, int recLen, RecordID &outRid);
+	Status InsertBatch(const char *recs, const int *lens, int n, RecordID *outRids);
 	Status DeleteRecord(const RecordID &rid);
 	Status UpdateRecord(const RecordID &rid, char *recPtr, int recLen);
 	Status GetRecord(const RecordID &rid, char *recPtr, int &recLen);
 	class Scan *OpenScan(Status &status);
+	class BatchScan *OpenBatchScan(Status &status);
 
 	Status DeleteFile();
 };
@@ -0,0 +1,54 @@
+#ifndef _TWOQ_H
+#define _TWOQ_H
+
+#include "db.h"
+#include "replacer.h"
+
+// Scan resistant replacement policy, after the simplified 2Q algorithm of
+// Johnson and Shasha.
+//
+// A page that has been unpinned only once since it was read sits in the A1
+// queue, which is FIFO. A page that is unpinned again while it is still
+// resident moves to the Am queue, which is LRU. Victims come from A1 as long
+// as A1 holds more than a quarter of the frames, so a long sequential scan
+// only ever recycles A1 and leaves the re-referenced working set in Am alone.
+//
+// Both queues are doubly linked lists threaded through arrays indexed by frame
+// number, so every operation is O(1) and nothing is allocated after
+// construction.
+class TwoQ : public Replacer
+{
+private:
+	enum Queue { NONE, A1, AM };
+
+	struct List
+	{
+		int head;	// Least recently added frame, or INVALID_FRAME.
+		int tail;	// Most recently added frame, or INVALID_FRAME.
+		int size;
+	};
+
+	int numFrames;
+	int *prev;		// Previous frame in the frame's queue.
+	int *next;		// Next frame in the frame's queue.
+	Queue *queue;	// Queue the frame is in, NONE while it is pinned.
+	bool *seen;		// Whether the page in the frame has been unpinned before.
+
+	List a1;
+	List am;
+	int a1Threshold;
+
+	void Append(List &list, Queue q, int f);
+	void Unlink(List &list, int f);
+	int PopHead(List &list);
+
+public:
+	TwoQ(int numOfFrames);
+	virtual ~TwoQ();
+
+	virtual int PickVictim();
+	virtual void AddFrame(int f);
+	virtual void RemoveFrame(int f);
+};
+
+#endif // _TWOQ_H
@@ -0,0 +1,165 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+using namespace std;
+
+#include "frame.h"
+#include "lru.h"
+#include "arraylru.h"
+#include "mru.h"
+#include "twoq.h"
+
+#include "ReplacerBench.h"
+
+// Layout of the simulated database. Page 0 is the root of the index, followed
+// by its internal pages and its leaves; the heap file being scanned comes last.
+static const int numInternalPages = 20;
+static const int numLeafPages = 2000;
+static const int numHotLeafPages = 200;
+static const int numHeapPages = 50000;
+
+static const PageID rootPid = 0;
+static const PageID firstInternalPid = 1;
+static const PageID firstLeafPid = firstInternalPid + numInternalPages;
+static const PageID firstHeapPid = firstLeafPid + numLeafPages;
+static const int numPages = firstHeapPid + numHeapPages;
+
+static const int numLookups = 50000;
+static const int numOfFrames = 300;
+
+// A minimal buffer pool that drives a Replacer exactly the way BufMgr does:
+// a pinned frame is removed from the candidates, a frame whose pin count drops
+// to zero is added back, and a miss replaces the replacer's victim.
+class SimulatedPool
+{
+public:
+	SimulatedPool(Replacer *r, int numOfFrames)
+		: replacer(r), frameOf(numPages, INVALID_FRAME), pageIn(numOfFrames, INVALID_PAGE),
+		  pinCount(numOfFrames, 0), numPins(0), numMisses(0)
+	{
+		for (int f = 0; f < numOfFrames; f++)
+			replacer->AddFrame(f);
+	}
+
+	bool PinPage(PageID pid)
+	{
+		numPins++;
+		int f = frameOf[pid];
+		if (f != INVALID_FRAME)
+		{
+			if (pinCount[f]++ == 0)
+				replacer->RemoveFrame(f);
+			return true;
+		}
+
+		numMisses++;
+		f = replacer->PickVictim();
+		if (f == INVALID_FRAME)
+			return false;
+		if (pageIn[f] != INVALID_PAGE)
+			frameOf[pageIn[f]] = INVALID_FRAME;
+		pageIn[f] = pid;
+		frameOf[pid] = f;
+		pinCount[f] = 1;
+		return true;
+	}
+
+	void UnpinPage(PageID pid)
+	{
+		int f = frameOf[pid];
+		if (--pinCount[f] == 0)
+			replacer->AddFrame(f);
+	}
+
+	void GetStat(long &pinNo, long &missNo)
+	{
+		pinNo = numPins;
+		missNo = numMisses;
+	}
+
+	void ResetStat()
+	{
+		numPins = numMisses = 0;
+	}
+
+private:
+	Replacer *replacer;
+	vector<int> frameOf;
+	vector<PageID> pageIn;
+	vector<int> pinCount;
+	long numPins;
+	long numMisses;
+};
+
+bool ReplacerBench::RunAll()
+{
+	cout << "Replacement policies: " << numLookups << " index lookups interleaved with a scan of "
+		<< numHeapPages << " heap pages, " << numOfFrames << " frames" << endl;
+	cout << "Policy     index hit ratio   overall hit ratio" << endl;
+
+	LRU lru;
+	RunWorkload("LRU", &lru, numOfFrames);
+
+	// Should match the row above: only the cost per call differs.
+	ArrayLRU arrayLru(numOfFrames);
+	RunWorkload("ArrayLRU", &arrayLru, numOfFrames);
+
+	MRU mru;
+	RunWorkload("MRU", &mru, numOfFrames);
+
+	TwoQ twoQ(numOfFrames);
+	RunWorkload("2Q", &twoQ, numOfFrames);
+
+	return true;
+}
+
+void ReplacerBench::RunWorkload(const char *policy, Replacer *replacer, int numOfFrames)
+{
+	SimulatedPool pool(replacer, numOfFrames);
+	srand(1);
+
+	// Warm the pool with lookups alone so that every policy starts the
+	// measured run with the index working set resident.
+	long indexPins = 0, indexMisses = 0;
+	for (int phase = 0; phase < 2; phase++)
+	{
+		pool.ResetStat();
+		indexPins = indexMisses = 0;
+
+		for (int i = 0; i < numLookups; i++)
+		{
+			// Most lookups land on a small set of hot leaves.
+			int leaf = (rand() % 10 < 8) ? rand() % numHotLeafPages : rand() % numLeafPages;
+			PageID leafPid = firstLeafPid + leaf;
+			PageID internalPid = firstInternalPid + leaf * numInternalPages / numLeafPages;
+
+			long pinsBefore, missesBefore, pinsAfter, missesAfter;
+			pool.GetStat(pinsBefore, missesBefore);
+
+			// Descend the way BTreeFile does: pin the child before unpinning the parent.
+			pool.PinPage(rootPid);
+			pool.PinPage(internalPid);
+			pool.UnpinPage(rootPid);
+			pool.PinPage(leafPid);
+			pool.UnpinPage(internalPid);
+			pool.UnpinPage(leafPid);
+
+			pool.GetStat(pinsAfter, missesAfter);
+			indexPins += pinsAfter - pinsBefore;
+			indexMisses += missesAfter - missesBefore;
+
+			// The concurrent scan reads one heap page per lookup.
+			if (phase == 1)
+			{
+				PageID heapPid = firstHeapPid + i % numHeapPages;
+				pool.PinPage(heapPid);
+				pool.UnpinPage(heapPid);
+			}
+		}
+	}
+
+	long pinNo, missNo;
+	pool.GetStat(pinNo, missNo);
+	printf("%-10s %-17.3f %.3f\n", policy,
+		1.0 - (double)indexMisses / indexPins, 1.0 - (double)missNo / pinNo);
+}
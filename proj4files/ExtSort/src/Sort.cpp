@@ -5,7 +5,8 @@
 #include <memory.h>
 
 #include "heapfile.h"
-#include "scan.h"
+#include "batchscan.h"
+#include "TempFileSpace.h"
 
 #include "Sort.h"
 
@@ -18,26 +19,6 @@ int attributeLength;
 TupleOrder sortOrderG;
 
 
-//-------------------------------------------------------------------
-// Sort::CreateTempFilename
-//
-// Input   : file_name,	The output file name of the sorting task.
-//			 pass,		The number of passes (assuming the sort phase is pass 0).
-//			 run,		The run number within the pass.
-// Output  : None.
-// Return  : The temporary file name
-// Example : File 7 in pass 3 for output file FOO will be named FOO.sort.temp.3.7.
-// Note    : It is your responsibility to destroy the return filename string.
-//-------------------------------------------------------------------
-char *Sort::CreateTempFilename(char *filename, int pass, int run)
-{
-	char *name = new char[strlen(filename) + 20];
-	sprintf(name,"%s.sort.temp.%d.%d", filename, pass, run);
-	return name;
-}
-
-
-
 //-------------------------------------------------------------------
 // Compare function for qsort
 // returns 0 if a and b are equal
@@ -91,41 +72,44 @@ int compare(const void *a, const void *b)
 
 //-------------------------------------------------------------------
 // Private function to transfer the given sorted memory into a heap file
+// when out is set, or into temporary file run otherwise.
 //-------------------------------------------------------------------
 Status Sort::TransferToHeapFile(char *unsortedMemory, int run, int numElements, bool out) {
 	qsort(unsortedMemory, numElements, _recLength, compare);
-	//Insert the contiguous memory into a new heap file.
-	char *tempFile = CreateTempFilename(_outFile, 0, run);
-	if (out) {
-		delete [] tempFile;
-		tempFile = _outFile;
+	if (!out) {
+		//The records are already contiguous, append them in one go.
+		if (_tempSpace->Append(run, unsortedMemory, numElements) != OK) {
+			std::cerr << "Could not append to Temp File in PassZero\n";
+			return FAIL;
+		}
+		_runRecords[0].push_back(numElements);
+		return OK;
 	}
+	//Insert the contiguous memory into the output heap file.
 	Status result;
-	HeapFile *temp = new HeapFile(tempFile, result);
+	HeapFile *temp = new HeapFile(_outFile, result);
 	if (result != OK) {
-		std::cerr << "Temp Heap File cannot be created in PassZero\n";
-		if (!out)
-		delete [] tempFile;
+		std::cerr << "Output Heap File cannot be created in PassZero\n";
 		delete temp;
 		return FAIL;
 	}
-	RecordID rid;
+	//All the records have the same length, append them in one batch.
+	int *lens = new int[numElements];
 	for (int i = 0; i < numElements; i++) {
-		if (temp->InsertRecord(&unsortedMemory[i * _recLength], _recLength, rid) == FAIL) {
-			std::cerr << "Could not insert into Temp Heap File in PassZero\n";
-			if (!out)
-			delete [] tempFile;
-			delete temp;
-			return FAIL;
-		}
+		lens[i] = _recLength;
+	}
+	result = temp->InsertBatch(unsortedMemory, lens, numElements, NULL);
+	delete [] lens;
+	if (result != OK) {
+		std::cerr << "Could not insert into Output Heap File in PassZero\n";
+		delete temp;
+		return FAIL;
 	}
-	if (!out)
-	delete [] tempFile; //our burden to delete it
-	delete temp; //temp file is done being written to.
+	delete temp; //output file is done being written to.
 	return OK;
 }
 
-Status Sort::PassZero(int &numTempFiles) 
+Status Sort::PassZero(int &numTempFiles, int &firstRun) 
 {
 	// Open the unsorted heapfile
 	Status result = OK;
@@ -136,8 +120,8 @@ Status Sort::PassZero(int &numTempFiles)
 		return FAIL;
 	}
 
-	// Open a scan to get all the records
-	Scan *filescan = file->OpenScan(result);
+	// Open a scan to get all the records, a page at a time
+	BatchScan *filescan = file->OpenBatchScan(result);
 	if (result != OK) {
 		std::cerr << "Scan cannot be opened\n";
 		delete file;
@@ -154,49 +138,71 @@ Status Sort::PassZero(int &numTempFiles)
 	int startIndex = 0;
 	int numElements = 0;
 
-	// continually insert all records into runMemory until full.
-	RecordID rid; //just a placeholder.
-	char *recPtr = new char[_recLength];
-
-	while (filescan->GetNext(rid, recPtr, _recLength) != DONE){
-		//std::cout << "rid: " << rid << std::endl;
-		//std::cout << "recLen: " << recLen << std::endl;
-		//check whether runMemory can fit the next record
-		//when its ==, the memory just fits!
-		if ((startIndex + _recLength) > numMemory) {
-			if (TransferToHeapFile(runMemory, run, numElements, false) != OK) {
-				delete file;
-				delete filescan;
-				delete [] runMemory;
-				delete [] recPtr;
-				return FAIL;
+	// Reserve the temp files for all the runs at once. A single run is
+	// written straight to the output file and needs none.
+	int numRecords = file->GetNumOfRecords();
+	int recsPerRun = numMemory / _recLength;
+	int numRuns = (numRecords + recsPerRun - 1) / recsPerRun;
+	firstRun = 0;
+	if (numRuns > 1 && _tempSpace->ReserveFiles(numRuns, firstRun) != OK) {
+		std::cerr << "Cannot reserve the temp files of PassZero\n";
+		delete file;
+		delete filescan;
+		delete [] runMemory;
+		return FAIL;
+	}
+
+	// continually insert all records into runMemory until full. The
+	// records are copied straight from the pinned heap pages.
+	ScanRecord *records;
+	int numOfRecords;
+
+	while ((result = filescan->GetNextBatch(records, numOfRecords)) == OK) {
+		for (int i = 0; i < numOfRecords; i++) {
+			//check whether runMemory can fit the next record
+			//when its ==, the memory just fits!
+			if ((startIndex + _recLength) > numMemory) {
+				if (TransferToHeapFile(runMemory, firstRun + run, numElements, false) != OK) {
+					delete file;
+					delete filescan;
+					delete [] runMemory;
+					return FAIL;
+				}
+
+				//reset all the variables, increase run.
+				startIndex = 0;
+				numElements = 0;
+				run++;
 			}
 
-			//reset all the variables, increase run.
-			startIndex = 0;
-			numElements = 0;
-			run++;
+			//copy record into memory
+			memcpy(&runMemory[startIndex], records[i].recPtr, _recLength);
+			startIndex += _recLength;
+			numElements++;
 		}
+	}
 
-		//copy record into memory
-		memcpy(&runMemory[startIndex], recPtr, _recLength);
-		startIndex += _recLength;
-		numElements++;
+	// Anything but DONE is a read error, not the end of the file.
+	if (result != DONE) {
+		std::cerr << "Cannot read the Heap File in PassZero\n";
+		delete file;
+		delete filescan;
+		delete [] runMemory;
+		return FAIL;
 	}
 
 	// The last run is not empty (aka the heap file to be sorted was not empty)
 	if (startIndex != 0) {
 		Status result;
 		if (run == 0) {
-			result = TransferToHeapFile(runMemory, run, numElements, true);
+			result = TransferToHeapFile(runMemory, firstRun + run, numElements, true);
 		} else {
-			result = TransferToHeapFile(runMemory, run, numElements, false);
+			result = TransferToHeapFile(runMemory, firstRun + run, numElements, false);
 		}
 		if (result != OK) {
 			delete file;
 			delete filescan;
 			delete [] runMemory;
-			delete [] recPtr;
 			return FAIL;
 		}
 		//don't increase run number here. No more runs after this
@@ -206,26 +212,28 @@ Status Sort::PassZero(int &numTempFiles)
 	delete file;
 	delete filescan;
 	delete [] runMemory;
-	delete [] recPtr;
 
 	numTempFiles = run+1; //run kept track of how many temp files we created.
 
 	return OK;
 }
 
-Status Sort::MergeManyToOne(unsigned int numPages, Scan **scans, HeapFile *newOut) {
+Status Sort::MergeManyToOne(unsigned int numPages, TempFileScan **scans, int outRun, HeapFile *newOut) {
 	unsigned int emptyPages = 0;
-	RecordID rid;
+	RecordID ridMin; //just a placeholder.
 	char** currents = new char*[numPages];
-	for (int i = 0; i < numPages; i++) {
+	for (unsigned int i = 0; i < numPages; i++) {
 		char *recPtr = new char[_recLength];
-		scans[i]->GetNext(rid, recPtr, _recLength);
+		if (scans[i]->GetNext(recPtr) != OK) {
+			delete [] recPtr;
+			recPtr = NULL;
+			emptyPages++;
+		}
 		currents[i] = recPtr;
 	}
 	
-	RecordID ridMin; //just a placeholder.
 	char *recPtrMin = NULL;
-	//std::cout << currents[0] << ", " << currents[1] << ", " << currents[2] << "\n";
+	Status result = OK;
 	while (emptyPages < numPages) {
 		int min_i = 0;
 		for (unsigned int i = 0; i < numPages; i++) {
@@ -244,98 +252,90 @@ Status Sort::MergeManyToOne(unsigned int numPages, Scan **scans, HeapFile *newOu
 			}
 		}
 		// now has min
-		
-		if (newOut->InsertRecord(recPtrMin, _recLength, ridMin) != OK) {
+
+		if (newOut != NULL) {
+			result = newOut->InsertRecord(recPtrMin, _recLength, ridMin);
+		} else {
+			result = _tempSpace->Append(outRun, recPtrMin, 1);
+		}
+		if (result != OK) {
 			std::cerr << "Inserting record failed in pass 1 and beyond" << std::endl;
-			//delete [] recPtrMin;
-			return FAIL;
+			break;
 		}
-		char *recNewPtr = new char[_recLength];
-		if (scans[min_i]->GetNext(rid, recNewPtr, _recLength) != DONE) {
-			currents[min_i] = recNewPtr;
-		} else {
-			delete [] recNewPtr;
+		// reuse the buffer of the record just written for the next one.
+		if (scans[min_i]->GetNext(recPtrMin) != OK) {
+			delete [] recPtrMin;
 			currents[min_i] = NULL;
 			emptyPages++;
 		}
-		delete [] recPtrMin;
 		recPtrMin = NULL;
 	}
-	return OK;
+
+	for (unsigned int i = 0; i < numPages; i++) {
+		delete [] currents[i];
+	}
+	delete [] currents;
+	return result;
 }
 
-Status Sort::PassOneAndBeyond(int numFilesIn, int pass, int &numFilesOut) {
+Status Sort::PassOneAndBeyond(int numFilesIn, int firstRunIn, int pass, int &numFilesOut, int &firstRunOut) {
 	Status result;
 	int n = _numBufPages - 1;
 	int numRuns = ceil(numFilesIn*1.0/n);
+
+	// Reserve the temp files for the whole pass at once. The last pass
+	// writes the output file instead.
+	firstRunOut = 0;
+	if (numRuns > 1 && _tempSpace->ReserveFiles(numRuns, firstRunOut) != OK) {
+		std::cerr << "Cannot reserve the temp files of pass " << pass << "\n";
+		return FAIL;
+	}
+	_runRecords.resize(pass + 1);
+
 	for (int run = 0; run < numRuns; run++) {
 		int numPages = n;
 		if (run == numRuns-1) {
 			// last file
 			numPages = numFilesIn - n*run;
 		}
-		//std::cout << "n: " << n << std::endl <<
-			//"numFilesIn: " << numFilesIn << std::endl <<
-			//"numRuns: " << numRuns << std::endl <<
-			//"run: " << run << std::endl <<
-			//"numPages: " << numPages << std::endl;
-		// opening n files and scans
-		Scan **scans = new Scan*[numPages];
-		HeapFile **files = new HeapFile*[numPages];
+		// opening n scans
+		TempFileScan **scans = new TempFileScan*[numPages];
 		for (int i = 0; i < numPages; i++) {
-			char* tempFileName = CreateTempFilename(_outFile, pass-1, run*n+i);
-			HeapFile *file = new HeapFile(tempFileName, result);
+			scans[i] = _tempSpace->OpenScan(firstRunIn + run*n + i, result);
 			if (result != OK) {
+				for (int j = 0; j < i; j++) {
+					delete scans[j];
+				}
 				delete [] scans;
-				delete [] tempFileName;
 				return FAIL;
 			}
-			Scan* scan = file->OpenScan(result);
+		}
+		HeapFile *newOut = NULL;
+		if (numRuns == 1) {
+			newOut = new HeapFile(_outFile, result);
 			if (result != OK) {
+				for (int i = 0; i < numPages; i++) {
+					delete scans[i];
+				}
 				delete [] scans;
-				delete [] tempFileName;
-				delete file;
+				delete newOut;
 				return FAIL;
 			}
-			scans[i] = scan;
-			files[i] = file;
-			delete [] tempFileName;
-		}
-		char* newFileName = CreateTempFilename(_outFile, pass, run);
-		if (numRuns == 1) {
-			delete [] newFileName;
-			newFileName = _outFile;
-		}
-		HeapFile *newOut = new HeapFile(newFileName, result);
-		if (result != OK) {
-			for (int i = 0; i < numPages; i++) {
-				delete scans[i];
-				delete files[i];
-			}
-			delete [] scans;
-			delete [] files;
-			delete [] newFileName;
-			return FAIL;
-		}
-		if (MergeManyToOne(numPages, scans, newOut) != OK) {
-			for (int i = 0; i < numPages; i++) {
-				delete scans[i];
-				delete files[i];
-			}
-			delete [] scans;
-			delete [] files;
-			delete [] newFileName;
-			delete newOut;
-			return FAIL;
 		}
+		result = MergeManyToOne(numPages, scans, firstRunOut + run, newOut);
 		for (int i = 0; i < numPages; i++) {
 			delete scans[i];
-			delete files[i];
+			// the input run is merged, let the next runs reuse its pages.
+			_tempSpace->DeleteFile(firstRunIn + run*n + i);
 		}
 		delete [] scans;
-		delete [] files;
-		//delete [] newFileName;
 		delete newOut;
+		if (result != OK) {
+			return FAIL;
+		}
+		if (numRuns != 1) {
+			_runRecords[pass].push_back(_tempSpace->GetNumOfRecords(firstRunOut + run));
+		}
 	}
 	numFilesOut = numRuns;
 
@@ -366,6 +366,18 @@ Sort::Sort(
 		_recLength += fieldSizes[i];
 	}
 
+	// A run must hold at least one record, and a merge needs at least two
+	// input buffers and one output buffer.
+	if (_recLength <= 0 || _recLength > PAGESIZE || numBufPages < 3) {
+		std::cerr << "Cannot sort records of " << _recLength << " bytes with "
+			<< numBufPages << " buffer pages\n";
+		_tempSpace = NULL;
+		s = FAIL;
+		return;
+	}
+	_tempSpace = new TempFileSpace(_recLength);
+	_runRecords.resize(1);
+
 	/*Initialize global variables for the compare function*/
 	attributeTypeToCompare = fieldTypes[_sortKeyIndex];
 	attributeOffset = 0;
@@ -378,7 +390,8 @@ Sort::Sort(
 
 	//Do Pass Zero - includes opening the file, reading in records, sorting them into runs.
 	int numTempFiles;
-	Status passZeroStatus = PassZero(numTempFiles);
+	int firstRun;
+	Status passZeroStatus = PassZero(numTempFiles, firstRun);
 	//std::cout << "num files after pass 0:" << numTempFiles << std::endl;
 	if (passZeroStatus == FAIL) {
 		s = FAIL;
@@ -386,18 +399,54 @@ Sort::Sort(
 	}
 	if (numTempFiles == 0) {
 		// create an empty heap file.
-		new HeapFile(_outFile, s);
+		HeapFile empty(_outFile, s);
 		return;
 	}
 	int pass = 1;
 	while (numTempFiles != 1) {
-		if (PassOneAndBeyond(numTempFiles, pass, numTempFiles) != OK) {
+		if (PassOneAndBeyond(numTempFiles, firstRun, pass, numTempFiles, firstRun) != OK) {
 			s = FAIL;
 			return;
 		}
 		pass++;
 	}
-	s = OK;
+
+	// Give all the temp pages back to the database in one go.
+	s = _tempSpace->ReleaseAll();
 }
 
+Sort::~Sort()
+{
+	delete _tempSpace;
+}
 
+//-------------------------------------------------------------------
+// Sort::GetNumOfRuns
+//
+// Input   : pass - the pass number, pass 0 being the sort phase.
+// Output  : None.
+// Return  : The number of temporary runs the pass wrote, 0 if the pass
+//           wrote the output file or did not happen.
+//-------------------------------------------------------------------
+int Sort::GetNumOfRuns(int pass)
+{
+	if (pass < 0 || pass >= (int)_runRecords.size())
+		return 0;
+	return (int)_runRecords[pass].size();
+}
+
+//-------------------------------------------------------------------
+// Sort::GetNumOfRunRecords
+//
+// Input   : pass - the pass number, pass 0 being the sort phase.
+//           run  - the run number within the pass.
+// Output  : None.
+// Return  : The number of records in the run, or -1 if the pass did
+//           not write that temporary run.
+//-------------------------------------------------------------------
+int Sort::GetNumOfRunRecords(int pass, int run)
+{
+	if (run < 0 || run >= GetNumOfRuns(pass))
+		return -1;
+	return _runRecords[pass][run];
+}
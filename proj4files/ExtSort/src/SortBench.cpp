@@ -0,0 +1,138 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+using namespace std;
+
+#include "db.h"
+#include "bufmgr.h"
+#include "heapfile.h"
+
+#include "Sort.h"
+#include "SortBench.h"
+
+// Same record layout and buffer budget as SortTestDriver::TestMulMerge.
+static const int numRecords = 1000000;
+static const int numBufPages = 4;
+static const short recLength = 256;
+
+// Large enough for the input, the output and one pass of runs.
+static const int numDBPages = 1200000;
+
+static double Seconds(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+bool SortBench::RunAll()
+{
+	// Sort in a scratch database and buffer pool so that the directory
+	// holds nothing but the files of the benchmark.
+	MINIBASE_BM->FlushAllPages();
+	DB *savedDB = MINIBASE_DB;
+	BufMgr *savedBM = MINIBASE_BM;
+
+	Status s;
+	const char *dbName = "SORTBENCH.DB";
+	remove(dbName);
+	MINIBASE_DB = new DB(dbName, numDBPages, s);
+	if (s != OK)
+	{
+		cerr << "Cannot create " << dbName << endl;
+		delete MINIBASE_DB;
+		MINIBASE_DB = savedDB;
+		return false;
+	}
+	MINIBASE_BM = new BufMgr(NUMBUF);
+
+	struct Record {
+		char	key [32];
+		char	pad [224];
+	} rec;
+
+	AttrType 	attrType[] = { attrString, attrString };
+	short		attrSize[] = { 32, 224 };
+
+	memset(&rec, 0, sizeof(rec));
+	srand(1);
+
+	RecordID rid;
+	HeapFile f("SortBench.in", s);
+	for (int i = 0; i < numRecords && s == OK; i++)
+	{
+		for (int j = 0; j < 12; j++)
+			rec.key[j] = 'a' + rand() % 26;
+		s = f.InsertRecord((char *)&rec, recLength, rid);
+	}
+
+	bool succeed = (s == OK);
+	if (succeed)
+	{
+		clock_t start = clock();
+		Sort sort("SortBench.in", "SortBench.out", 2, attrType, attrSize, 0, Ascending, numBufPages, s);
+		double sortSeconds = Seconds(start);
+
+		f.DeleteFile();
+		succeed = (s == OK);
+		if (succeed)
+		{
+			int numPasses = 0;
+			int numRuns = 0;
+			for (int pass = 0; pass == 0 || sort.GetNumOfRuns(pass - 1) > 0; pass++)
+			{
+				numRuns += sort.GetNumOfRuns(pass);
+				numPasses++;
+			}
+
+			cout << "Sort of " << numRecords << " records of " << recLength << " bytes with "
+				<< numBufPages << " buffer pages: " << numPasses << " passes, "
+				<< numRuns << " temporary runs" << endl;
+			printf("Sort with anonymous temporary runs          %.2f s\n", sortSeconds);
+			printf("Directory work of the same runs when named  %.2f s\n", ReplayNamedRuns(sort, "SortBench.out"));
+		}
+
+		HeapFile out("SortBench.out", s);
+		out.DeleteFile();
+	}
+
+	if (!succeed)
+		cerr << "SortBench failed" << endl;
+
+	MINIBASE_BM->FlushAllPages();
+	delete MINIBASE_BM;
+	delete MINIBASE_DB;
+	MINIBASE_BM = savedBM;
+	MINIBASE_DB = savedDB;
+	remove(dbName);
+
+	return succeed;
+}
+
+double SortBench::ReplayNamedRuns(Sort &sort, const char *outFile)
+{
+	char *name = new char[strlen(outFile) + 20];
+	Status s;
+
+	clock_t start = clock();
+	for (int pass = 0; sort.GetNumOfRuns(pass) > 0; pass++)
+	{
+		// The pass creates a file per run...
+		for (int run = 0; run < sort.GetNumOfRuns(pass); run++)
+		{
+			sprintf(name, "%s.sort.temp.%d.%d", outFile, pass, run);
+			HeapFile temp(name, s);
+		}
+
+		// ...which the next pass opens by name and deletes once merged.
+		for (int run = 0; run < sort.GetNumOfRuns(pass); run++)
+		{
+			sprintf(name, "%s.sort.temp.%d.%d", outFile, pass, run);
+			HeapFile temp(name, s);
+			temp.DeleteFile();
+		}
+	}
+	double seconds = Seconds(start);
+
+	delete [] name;
+	return seconds;
+}
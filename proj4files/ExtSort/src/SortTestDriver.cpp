@@ -93,9 +93,7 @@ bool SortTestDriver::TestSortOnly()
 	}
 
 	// Check intermediate results
-	HeapFile notExist("SortOnly.out.sort.temp.1.0", s);
-
-	if (s == OK && notExist.GetNumOfRecords() > 0) {
+	if (sort.GetNumOfRuns(1) > 0) {
 		cout << "Test SortOnly Warning: unexpected merge pass encountered." << endl;
 	}
 
@@ -180,39 +178,35 @@ bool SortTestDriver::TestOneMerge()
 
 	// Check intermediate results
 	int totalNumRec = 0;
-	HeapFile pass0file0("OneMerge.out.sort.temp.0.0", s);
+	int pass0run0 = sort.GetNumOfRunRecords(0, 0);
 
-	if (s != OK || pass0file0.GetNumOfRecords() == 0) {
-		cout << "Test OneMerge Warning: expected temp file not exist." << endl;
+	if (pass0run0 <= 0) {
+		cout << "Test OneMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file0.GetNumOfRecords();
+		totalNumRec += pass0run0;
 	}
 
-	HeapFile pass0file1("OneMerge.out.sort.temp.0.1", s);
+	int pass0run1 = sort.GetNumOfRunRecords(0, 1);
 
-	if (s != OK || pass0file1.GetNumOfRecords() == 0) {
-		cout << "Test OneMerge Warning: expected temp file not exist." << endl;
+	if (pass0run1 <= 0) {
+		cout << "Test OneMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file1.GetNumOfRecords();
+		totalNumRec += pass0run1;
 	}
 
-	HeapFile pass0file2("OneMerge.out.sort.temp.0.2", s);
+	int pass0run2 = sort.GetNumOfRunRecords(0, 2);
 
-	if (s != OK || pass0file2.GetNumOfRecords() == 0) {
-		cout << "Test OneMerge Warning: expected temp file not exist." << endl;
+	if (pass0run2 <= 0) {
+		cout << "Test OneMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file2.GetNumOfRecords();
+		totalNumRec += pass0run2;
 	}
 
-	HeapFile pass0file3("OneMerge.out.sort.temp.0.3", s);
-
-	if (s == OK && pass0file3.GetNumOfRecords() > 0) {
-		cout << "Test OneMerge Warning: unexpected temp file encountered." << endl;
+	if (sort.GetNumOfRunRecords(0, 3) > 0) {
+		cout << "Test OneMerge Warning: unexpected temp run encountered." << endl;
 	}
 
-	HeapFile notExist("OneMerge.out.sort.temp.2.0", s);
-
-	if (s == OK && notExist.GetNumOfRecords() > 0) {
+	if (sort.GetNumOfRuns(2) > 0) {
 		cout << "Test OneMerge Warning: unexpected merge pass encountered." << endl;
 	}
 
@@ -302,58 +296,56 @@ bool SortTestDriver::TestMulMerge()
 
 	// Check intermediate results
 	int totalNumRec = 0;
-	HeapFile pass0file0("MulMerge.out.sort.temp.0.0", s);
+	int pass0run0 = sort.GetNumOfRunRecords(0, 0);
 
-	if (s != OK || pass0file0.GetNumOfRecords() == 0) {
-		cout << "Test MulMerge Warning: expected temp file not exist." << endl;
+	if (pass0run0 <= 0) {
+		cout << "Test MulMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file0.GetNumOfRecords();
+		totalNumRec += pass0run0;
 	}
 
-	HeapFile pass0file1("MulMerge.out.sort.temp.0.1", s);
+	int pass0run1 = sort.GetNumOfRunRecords(0, 1);
 
-	if (s != OK || pass0file1.GetNumOfRecords() == 0) {
-		cout << "Test MulMerge Warning: expected temp file not exist." << endl;
+	if (pass0run1 <= 0) {
+		cout << "Test MulMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file1.GetNumOfRecords();
+		totalNumRec += pass0run1;
 	}
 
-	HeapFile pass0file2("MulMerge.out.sort.temp.0.2", s);
+	int pass0run2 = sort.GetNumOfRunRecords(0, 2);
 
-	if (s != OK || pass0file2.GetNumOfRecords() == 0) {
-		cout << "Test MulMerge Warning: expected temp file not exist." << endl;
+	if (pass0run2 <= 0) {
+		cout << "Test MulMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file2.GetNumOfRecords();
+		totalNumRec += pass0run2;
 	}
 
-	HeapFile pass0file3("MulMerge.out.sort.temp.0.3", s);
+	int pass0run3 = sort.GetNumOfRunRecords(0, 3);
 
-	if (s != OK || pass0file3.GetNumOfRecords() == 0) {
-		cout << "Test MulMerge Warning: expected temp file not exist." << endl;
+	if (pass0run3 <= 0) {
+		cout << "Test MulMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file3.GetNumOfRecords();
+		totalNumRec += pass0run3;
 	}
 
-	HeapFile pass0file4("MulMerge.out.sort.temp.0.4", s);
+	int pass0run4 = sort.GetNumOfRunRecords(0, 4);
 
-	if (s != OK || pass0file4.GetNumOfRecords() == 0) {
-		cout << "Test MulMerge Warning: expected temp file not exist." << endl;
+	if (pass0run4 <= 0) {
+		cout << "Test MulMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file4.GetNumOfRecords();
+		totalNumRec += pass0run4;
 	}
 
-	HeapFile pass0file5("MulMerge.out.sort.temp.0.5", s);
+	int pass0run5 = sort.GetNumOfRunRecords(0, 5);
 
-	if (s != OK || pass0file5.GetNumOfRecords() == 0) {
-		cout << "Test MulMerge Warning: expected temp file not exist." << endl;
+	if (pass0run5 <= 0) {
+		cout << "Test MulMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass0file5.GetNumOfRecords();
+		totalNumRec += pass0run5;
 	}
 
-	HeapFile pass0file6("MulMerge.out.sort.temp.0.6", s);
-
-	if (s == OK && pass0file6.GetNumOfRecords() > 0) {
-		cout << "Test MulMerge Warning: unexpected temp file encountered." << endl;
+	if (sort.GetNumOfRunRecords(0, 6) > 0) {
+		cout << "Test MulMerge Warning: unexpected temp run encountered." << endl;
 	}
 
 	if (totalNumRec != numRecords) {
@@ -361,35 +353,31 @@ bool SortTestDriver::TestMulMerge()
 	}
 
 	totalNumRec = 0;
-	HeapFile pass1file0("MulMerge.out.sort.temp.1.0", s);
+	int pass1run0 = sort.GetNumOfRunRecords(1, 0);
 
-	if (s != OK || pass1file0.GetNumOfRecords() == 0) {
-		cout << "Test MulMerge Warning: expected temp file not exist." << endl;
+	if (pass1run0 <= 0) {
+		cout << "Test MulMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass1file0.GetNumOfRecords();
+		totalNumRec += pass1run0;
 	}
 
-	HeapFile pass1file1("MulMerge.out.sort.temp.1.1", s);
+	int pass1run1 = sort.GetNumOfRunRecords(1, 1);
 
-	if (s != OK || pass1file1.GetNumOfRecords() == 0) {
-		cout << "Test MulMerge Warning: expected temp file not exist." << endl;
+	if (pass1run1 <= 0) {
+		cout << "Test MulMerge Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass1file1.GetNumOfRecords();
+		totalNumRec += pass1run1;
 	}
 
-	HeapFile pass1file2("MulMerge.out.sort.temp.1.2", s);
-
-	if (s == OK && pass1file2.GetNumOfRecords() > 0) {
-		cout << "Test MulMerge Warning: unexpected temp file encountered." << endl;
+	if (sort.GetNumOfRunRecords(1, 2) > 0) {
+		cout << "Test MulMerge Warning: unexpected temp run encountered." << endl;
 	}
 
 	if (totalNumRec != numRecords) {
 		cout << "Test MulMerge Warning: incorect total number of records at the end of some pass." << endl;
 	}
 
-	HeapFile notExist("MulMerge.out.sort.temp.3.0", s);
-
-	if (s == OK && notExist.GetNumOfRecords() > 0) {
+	if (sort.GetNumOfRuns(3) > 0) {
 		cout << "Test MulMerge Warning: unexpected merge pass encountered." << endl;
 	}
 
@@ -482,35 +470,31 @@ bool SortTestDriver::TestRandInt()
 
 	// Check intermediate results
 	int totalNumRec = 0;
-	HeapFile pass2file0("RandInt.out.sort.temp.2.0", s);
+	int pass2run0 = sort.GetNumOfRunRecords(2, 0);
 
-	if (s != OK || pass2file0.GetNumOfRecords() == 0) {
-		cout << "Test RandInt Warning: expected temp file not exist." << endl;
+	if (pass2run0 <= 0) {
+		cout << "Test RandInt Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass2file0.GetNumOfRecords();
+		totalNumRec += pass2run0;
 	}
 
-	HeapFile pass2file1("RandInt.out.sort.temp.2.1", s);
+	int pass2run1 = sort.GetNumOfRunRecords(2, 1);
 
-	if (s != OK || pass2file1.GetNumOfRecords() == 0) {
-		cout << "Test RandInt Warning: expected temp file not exist." << endl;
+	if (pass2run1 <= 0) {
+		cout << "Test RandInt Warning: expected temp run not exist." << endl;
 	} else {
-		totalNumRec += pass2file1.GetNumOfRecords();
+		totalNumRec += pass2run1;
 	}
 
-	HeapFile pass2file2("RandInt.out.sort.temp.2.2", s);
-
-	if (s == OK && pass2file2.GetNumOfRecords() > 0) {
-		cout << "Test RandInt Warning: unexpected temp file encountered." << endl;
+	if (sort.GetNumOfRunRecords(2, 2) > 0) {
+		cout << "Test RandInt Warning: unexpected temp run encountered." << endl;
 	}
 
 	if (totalNumRec != numRecords) {
 		cout << "Test RandInt Warning: incorect total number of records at the end of some pass." << endl;
 	}
 
-	HeapFile notExist("RandInt.out.sort.temp.4.0", s);
-
-	if (s == OK && notExist.GetNumOfRecords() > 0) {
+	if (sort.GetNumOfRuns(4) > 0) {
 		cout << "Test RandInt Warning: unexpected merge pass encountered." << endl;
 	}
 
@@ -0,0 +1,311 @@
+#include <string.h>
+
+#include "bufmgr.h"
+
+#include "TempFileSpace.h"
+
+#define    PAGESIZE    MINIBASE_PAGESIZE
+
+//-------------------------------------------------------------------
+// TempFileSpace::TempFileSpace
+//
+// Input   : recLength - the length of every record in the space.
+// Output  : None.
+// Purpose : Create an empty space. No page is allocated until the
+//           first record is appended.
+//-------------------------------------------------------------------
+TempFileSpace::TempFileSpace(int recLength)
+{
+	this->recLength = recLength;
+	recsPerPage = PAGESIZE / recLength;
+	nextPage = INVALID_PAGE;
+	numOfPagesLeft = 0;
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::~TempFileSpace
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Give every extent still held back to the database.
+//-------------------------------------------------------------------
+TempFileSpace::~TempFileSpace()
+{
+	ReleaseAll();
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::IsValid
+//
+// Input   : id - a file id.
+// Output  : None.
+// Return  : True if id has been reserved since the last ReleaseAll.
+//-------------------------------------------------------------------
+bool TempFileSpace::IsValid(int id)
+{
+	return id >= 0 && id < (int)files.size();
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::ReserveFiles
+//
+// Input   : numOfFiles - the number of files to reserve.
+// Output  : firstId    - the id of the first file; the others follow it.
+// Purpose : Create numOfFiles empty files. Nothing is written to the
+//           database.
+// Return  : OK, or FAIL if numOfFiles is negative.
+//-------------------------------------------------------------------
+Status TempFileSpace::ReserveFiles(int numOfFiles, int &firstId)
+{
+	firstId = (int)files.size();
+	if (numOfFiles < 0)
+		return FAIL;
+
+	TempFile empty;
+	empty.numOfRecords = 0;
+	files.resize(files.size() + numOfFiles, empty);
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::NewPage
+//
+// Input   : None.
+// Output  : pid - a page no file is using.
+// Purpose : Reuse a page of a deleted file if there is one, otherwise
+//           take the next page of the current extent, allocating a new
+//           extent when the current one is used up. If the database
+//           has no run of EXTENT_SIZE free pages left, a single page is
+//           allocated instead. Extents are allocated through MINIBASE_BM,
+//           which pins their first page; it is unpinned at once.
+// Return  : OK, or FAIL if the database is full.
+//-------------------------------------------------------------------
+Status TempFileSpace::NewPage(PageID &pid)
+{
+	if (!freePages.empty())
+	{
+		pid = freePages.back();
+		freePages.pop_back();
+		return OK;
+	}
+
+	if (numOfPagesLeft == 0)
+	{
+		Extent extent;
+		Page *page;
+		extent.size = EXTENT_SIZE;
+		if (MINIBASE_BM->NewPage(extent.start, page, extent.size) != OK)
+		{
+			extent.size = 1;
+			if (MINIBASE_BM->NewPage(extent.start, page, extent.size) != OK)
+			{
+				std::cerr << "Cannot allocate a page for a temporary file" << std::endl;
+				return FAIL;
+			}
+		}
+		MINIBASE_BM->UnpinPage(extent.start);
+		extents.push_back(extent);
+		nextPage = extent.start;
+		numOfPagesLeft = extent.size;
+	}
+
+	pid = nextPage++;
+	numOfPagesLeft--;
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::Append
+//
+// Input   : id        - the file to append to.
+//           recPtr    - numOfRecs records stored one after another.
+//           numOfRecs - the number of records to append.
+// Output  : None.
+// Purpose : Copy the records to the end of the file, pinning each page
+//           of the file they land on once.
+// Return  : OK, or FAIL if id is not a file or no page is left.
+//-------------------------------------------------------------------
+Status TempFileSpace::Append(int id, const char *recPtr, int numOfRecs)
+{
+	if (!IsValid(id))
+	{
+		std::cerr << "Temporary file " << id << " does not exist" << std::endl;
+		return FAIL;
+	}
+
+	TempFile &file = files[id];
+	while (numOfRecs > 0)
+	{
+		int slot = file.numOfRecords % recsPerPage;
+		PageID pid;
+		Page *page;
+
+		if (slot == 0)
+		{
+			if (NewPage(pid) != OK)
+				return FAIL;
+			if (MINIBASE_BM->PinPage(pid, page, true) != OK)
+			{
+				freePages.push_back(pid);
+				return FAIL;
+			}
+			file.pages.push_back(pid);
+		}
+		else
+		{
+			pid = file.pages.back();
+			if (MINIBASE_BM->PinPage(pid, page) != OK)
+				return FAIL;
+		}
+
+		int n = recsPerPage - slot;
+		if (n > numOfRecs)
+			n = numOfRecs;
+		memcpy((char *)page + slot * recLength, recPtr, n * recLength);
+		MINIBASE_BM->UnpinPage(pid, true);
+
+		recPtr += n * recLength;
+		numOfRecs -= n;
+		file.numOfRecords += n;
+	}
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::DeleteFile
+//
+// Input   : id - the file to delete.
+// Output  : None.
+// Purpose : Empty the file and keep its pages for the files written
+//           next. The pages stay allocated in the database until
+//           ReleaseAll.
+// Return  : OK, or FAIL if id is not a file.
+//-------------------------------------------------------------------
+Status TempFileSpace::DeleteFile(int id)
+{
+	if (!IsValid(id))
+		return FAIL;
+
+	TempFile &file = files[id];
+	freePages.insert(freePages.end(), file.pages.begin(), file.pages.end());
+	std::vector<PageID>().swap(file.pages);
+	file.numOfRecords = 0;
+	return OK;
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::ReleaseAll
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Delete every file and deallocate every extent. Each page is
+//           freed through MINIBASE_BM, so that its frame is dropped
+//           rather than its dirty contents being written back later onto
+//           a page the database has handed out again. No scan may be
+//           open.
+// Return  : OK, or FAIL if a page could not be freed.
+//-------------------------------------------------------------------
+Status TempFileSpace::ReleaseAll()
+{
+	Status status = OK;
+	for (unsigned int i = 0; i < extents.size(); i++)
+	{
+		for (int p = 0; p < extents[i].size; p++)
+		{
+			if (MINIBASE_BM->FreePage(extents[i].start + p) != OK)
+				status = FAIL;
+		}
+	}
+
+	std::vector<TempFile>().swap(files);
+	std::vector<Extent>().swap(extents);
+	std::vector<PageID>().swap(freePages);
+	nextPage = INVALID_PAGE;
+	numOfPagesLeft = 0;
+	return status;
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::GetNumOfRecords
+//
+// Input   : id - a file id.
+// Output  : None.
+// Return  : The number of records in the file, or -1 if id is not a
+//           file.
+//-------------------------------------------------------------------
+int TempFileSpace::GetNumOfRecords(int id)
+{
+	if (!IsValid(id))
+		return -1;
+	return files[id].numOfRecords;
+}
+
+//-------------------------------------------------------------------
+// TempFileSpace::OpenScan
+//
+// Input   : id - the file to scan.
+// Output  : status - OK, or FAIL if id is not a file.
+// Return  : A new scan positioned before the first record, or NULL.
+//-------------------------------------------------------------------
+TempFileScan *TempFileSpace::OpenScan(int id, Status &status)
+{
+	if (!IsValid(id))
+	{
+		status = FAIL;
+		return NULL;
+	}
+	status = OK;
+	return new TempFileScan(this, id);
+}
+
+TempFileScan::TempFileScan(TempFileSpace *space, int id)
+{
+	this->space = space;
+	this->id = id;
+	pageNo = 0;
+	recNo = 0;
+	page = NULL;
+}
+
+TempFileScan::~TempFileScan()
+{
+	if (page != NULL)
+		MINIBASE_BM->UnpinPage(space->files[id].pages[pageNo]);
+}
+
+//-------------------------------------------------------------------
+// TempFileScan::GetNext
+//
+// Input   : None.
+// Output  : recPtr - receives the next record.
+// Purpose : Pin the page of the next record if it is not pinned yet,
+//           copy the record out and unpin the page after its last
+//           record.
+// Return  : OK, DONE if there are no more records, or FAIL.
+//-------------------------------------------------------------------
+Status TempFileScan::GetNext(char *recPtr)
+{
+	TempFileSpace::TempFile &file = space->files[id];
+	if (recNo >= file.numOfRecords)
+		return DONE;
+
+	int slot = recNo % space->recsPerPage;
+	if (page == NULL)
+	{
+		pageNo = recNo / space->recsPerPage;
+		Page *p;
+		if (MINIBASE_BM->PinPage(file.pages[pageNo], p) != OK)
+			return FAIL;
+		page = (char *)p;
+	}
+
+	memcpy(recPtr, page + slot * space->recLength, space->recLength);
+	recNo++;
+
+	if (slot + 1 == space->recsPerPage || recNo == file.numOfRecords)
+	{
+		MINIBASE_BM->UnpinPage(file.pages[pageNo]);
+		page = NULL;
+	}
+	return OK;
+}
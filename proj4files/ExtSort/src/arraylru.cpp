@@ -0,0 +1,138 @@
+#include "arraylru.h"
+#include "frame.h"
+
+//-------------------------------------------------------------------
+// ArrayLRU::ArrayLRU
+//
+// Input   : numOfFrames - the number of frames in the buffer pool.
+// Output  : None.
+// Purpose : Create an empty list with links for every frame of the pool,
+//           so that no call allocates afterwards.
+//-------------------------------------------------------------------
+ArrayLRU::ArrayLRU(int numOfFrames)
+{
+	capacity = numOfFrames;
+	prev = new int[capacity];
+	next = new int[capacity];
+	inList = new bool[capacity];
+	for (int i = 0; i < capacity; i++)
+	{
+		prev[i] = next[i] = INVALID_FRAME;
+		inList[i] = false;
+	}
+
+	first = last = INVALID_FRAME;
+	numFrames = 0;
+}
+
+ArrayLRU::~ArrayLRU()
+{
+	delete [] prev;
+	delete [] next;
+	delete [] inList;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::IsPresent
+//
+// Input   : f - a frame number.
+// Output  : None.
+// Return  : true if f is a replacement candidate.
+//-------------------------------------------------------------------
+bool ArrayLRU::IsPresent(int f)
+{
+	return f >= 0 && f < capacity && inList[f];
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::IsEmpty
+//
+// Input   : None.
+// Output  : None.
+// Return  : true if there is no replacement candidate.
+//-------------------------------------------------------------------
+bool ArrayLRU::IsEmpty()
+{
+	return numFrames == 0;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::Unlink
+//
+// Input   : f - a frame in the list.
+// Output  : None.
+// Purpose : Take f out of the list.
+//-------------------------------------------------------------------
+void ArrayLRU::Unlink(int f)
+{
+	if (prev[f] != INVALID_FRAME)
+		next[prev[f]] = next[f];
+	else
+		first = next[f];
+
+	if (next[f] != INVALID_FRAME)
+		prev[next[f]] = prev[f];
+	else
+		last = prev[f];
+
+	prev[f] = next[f] = INVALID_FRAME;
+	inList[f] = false;
+	numFrames--;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::PickVictim
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Remove the least recently used frame from the list.
+// Return  : That frame, or INVALID_FRAME if there is no candidate.
+//-------------------------------------------------------------------
+int ArrayLRU::PickVictim()
+{
+	if (IsEmpty())
+		return INVALID_FRAME;
+
+	int f = first;
+	Unlink(f);
+	return f;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::AddFrame
+//
+// Input   : f - a frame whose pin count dropped to zero.
+// Output  : None.
+// Purpose : Make f the most recently used candidate.
+//-------------------------------------------------------------------
+void ArrayLRU::AddFrame(int f)
+{
+	if (f < 0 || f >= capacity)
+		return;
+
+	if (inList[f])
+		Unlink(f);
+
+	prev[f] = last;
+	next[f] = INVALID_FRAME;
+	if (last != INVALID_FRAME)
+		next[last] = f;
+	else
+		first = f;
+	last = f;
+	inList[f] = true;
+	numFrames++;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::RemoveFrame
+//
+// Input   : f - a frame that has been pinned.
+// Output  : None.
+// Purpose : Remove f from the candidates, if it is one.
+//-------------------------------------------------------------------
+void ArrayLRU::RemoveFrame(int f)
+{
+	if (IsPresent(f))
+		Unlink(f);
+}
@@ -5,6 +5,8 @@ using namespace std;
 #include "minirel.h"
 
 #include "SortTestDriver.h"
+#include "ReplacerBench.h"
+#include "SortBench.h"
 
 int MINIBASE_RESTART_FLAG = 0;
 
@@ -34,6 +36,15 @@ int main(int argc, char *argv[])
 
 	std.TestAll();
 
+	// Compares the LRU, MRU and 2Q replacers on a simulated pool.
+	//ReplacerBench rb;
+	//rb.RunAll();
+
+	// Sorts a million records in a scratch database of about 1.2 GB and
+	// takes several minutes.
+	//SortBench sb;
+	//sb.RunAll();
+
 	delete minibase_globals;
 
 	std::cout << "Hit [enter] to continue..." << endl;
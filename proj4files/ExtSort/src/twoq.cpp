@@ -0,0 +1,179 @@
+#include "twoq.h"
+#include "frame.h"
+
+//-------------------------------------------------------------------
+// TwoQ::TwoQ
+//
+// Input   : numOfFrames - the number of frames in the buffer pool.
+// Output  : None.
+// Purpose : Allocate the queue links for every frame. Both queues start
+//           empty; frames become candidates when they are added.
+//-------------------------------------------------------------------
+TwoQ::TwoQ(int numOfFrames)
+{
+	numFrames = numOfFrames;
+	prev = new int[numFrames];
+	next = new int[numFrames];
+	queue = new Queue[numFrames];
+	seen = new bool[numFrames];
+
+	for (int i = 0; i < numFrames; i++)
+	{
+		prev[i] = INVALID_FRAME;
+		next[i] = INVALID_FRAME;
+		queue[i] = NONE;
+		seen[i] = false;
+	}
+
+	a1.head = a1.tail = INVALID_FRAME;
+	a1.size = 0;
+	am.head = am.tail = INVALID_FRAME;
+	am.size = 0;
+
+	// The Kin parameter of the 2Q paper: a quarter of the pool is reserved
+	// for pages that have been referenced only once.
+	a1Threshold = numFrames / 4;
+	if (a1Threshold < 1)
+		a1Threshold = 1;
+}
+
+TwoQ::~TwoQ()
+{
+	delete [] prev;
+	delete [] next;
+	delete [] queue;
+	delete [] seen;
+}
+
+//-------------------------------------------------------------------
+// TwoQ::Append
+//
+// Input   : list - the queue to append to.
+//           q    - the tag of that queue.
+//           f    - a frame that is in no queue.
+// Output  : None.
+// Purpose : Put f at the tail of the queue.
+//-------------------------------------------------------------------
+void TwoQ::Append(List &list, Queue q, int f)
+{
+	prev[f] = list.tail;
+	next[f] = INVALID_FRAME;
+	if (list.tail != INVALID_FRAME)
+		next[list.tail] = f;
+	else
+		list.head = f;
+	list.tail = f;
+	list.size++;
+	queue[f] = q;
+}
+
+//-------------------------------------------------------------------
+// TwoQ::Unlink
+//
+// Input   : list - the queue f is in.
+//           f    - the frame to take out.
+// Output  : None.
+// Purpose : Remove f from the middle, head or tail of the queue.
+//-------------------------------------------------------------------
+void TwoQ::Unlink(List &list, int f)
+{
+	if (prev[f] != INVALID_FRAME)
+		next[prev[f]] = next[f];
+	else
+		list.head = next[f];
+
+	if (next[f] != INVALID_FRAME)
+		prev[next[f]] = prev[f];
+	else
+		list.tail = prev[f];
+
+	prev[f] = next[f] = INVALID_FRAME;
+	list.size--;
+	queue[f] = NONE;
+}
+
+//-------------------------------------------------------------------
+// TwoQ::PopHead
+//
+// Input   : list - a non-empty queue.
+// Output  : None.
+// Return  : The frame that was at the head of the queue.
+//-------------------------------------------------------------------
+int TwoQ::PopHead(List &list)
+{
+	int f = list.head;
+	Unlink(list, f);
+	return f;
+}
+
+//-------------------------------------------------------------------
+// TwoQ::PickVictim
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Choose the frame to be replaced and forget the history of the
+//           page in it, since the frame is about to hold a new page.
+// Return  : The victim frame, or INVALID_FRAME if every frame is pinned.
+//-------------------------------------------------------------------
+int TwoQ::PickVictim()
+{
+	int f;
+	if (a1.size > a1Threshold || (a1.size > 0 && am.size == 0))
+		f = PopHead(a1);
+	else if (am.size > 0)
+		f = PopHead(am);
+	else
+		return INVALID_FRAME;
+
+	seen[f] = false;
+	return f;
+}
+
+//-------------------------------------------------------------------
+// TwoQ::AddFrame
+//
+// Input   : f - a frame whose pin count dropped to zero.
+// Output  : None.
+// Purpose : Make f a replacement candidate. The first time the page in f
+//           is released it goes to A1; every later release moves it to
+//           the most recently used end of Am.
+//-------------------------------------------------------------------
+void TwoQ::AddFrame(int f)
+{
+	if (f < 0 || f >= numFrames)
+		return;
+
+	if (queue[f] == A1)
+		Unlink(a1, f);
+	else if (queue[f] == AM)
+		Unlink(am, f);
+
+	if (seen[f])
+	{
+		Append(am, AM, f);
+	}
+	else
+	{
+		seen[f] = true;
+		Append(a1, A1, f);
+	}
+}
+
+//-------------------------------------------------------------------
+// TwoQ::RemoveFrame
+//
+// Input   : f - a frame that has been pinned.
+// Output  : None.
+// Purpose : Take f out of the candidates. The frame keeps its history,
+//           so it goes to Am when it is released again.
+//-------------------------------------------------------------------
+void TwoQ::RemoveFrame(int f)
+{
+	if (f < 0 || f >= numFrames)
+		return;
+
+	if (queue[f] == A1)
+		Unlink(a1, f);
+	else if (queue[f] == AM)
+		Unlink(am, f);
+}
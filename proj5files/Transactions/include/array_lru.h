@@ -0,0 +1,38 @@
+#ifndef _ARRAY_LRU_H
+#define _ARRAY_LRU_H
+
+#include "db.h"
+
+// Least recently used replacement for the buffer managers built in this
+// project. The candidates form a doubly linked list threaded through arrays
+// indexed by frame number, so adding, removing and picking a frame are all
+// O(1) and do not allocate. The LRU class in lru.h is the one the prebuilt
+// BufMgr is compiled against, and stays as it is.
+class ArrayLRU
+{
+private:
+	int *prev;		// Previous (less recently used) frame, or INVALID_FRAME.
+	int *next;		// Next (more recently used) frame, or INVALID_FRAME.
+	bool *inList;	// Whether the frame is currently a candidate.
+	int capacity;	// Number of frames in the buffer pool.
+
+	int first;		// Least recently used frame, or INVALID_FRAME.
+	int last;		// Most recently used frame, or INVALID_FRAME.
+	int numFrames;	// Number of frames in the list.
+
+	void Unlink(int f);
+
+public:
+	ArrayLRU(int n);
+	~ArrayLRU();
+	int PickVictim();
+	void AddFrame(int f);
+	void AddFreeFrame(int f);
+	void RemoveFrame(int f);
+	void PrintQueue();
+	int GetNumFrames();
+	int GetLeastRecent(int *frameNos, int maxFrames);
+	bool IsPresent(int f);
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef _ASYNC_IO_H
+#define _ASYNC_IO_H
+
+using namespace System;
+using namespace System::Threading;
+
+#include "db.h"
+#include "uring_queue.h"
+
+// How an AsyncIO carries out its requests.
+enum IOBackend
+{
+	IO_AUTO,			// io_uring if the kernel allows it, the thread pool otherwise.
+	IO_URING,			// Submit through an io_uring; needs MINIBASE_IO_URING and liburing.
+	IO_THREAD_POOL		// Worker threads doing blocking positional reads and writes.
+};
+
+// A finished request, as returned by AsyncIO::WaitForCompletions.
+struct IOCompletion
+{
+	int tag;			// The tag the request was submitted with.
+	Status status;		// OK if the whole page was transferred.
+};
+
+// A request slot. Free slots are chained through next.
+struct IORequest
+{
+	PageID pid;
+	Page *page;
+	bool write;
+	int tag;
+	Status status;
+	int next;
+};
+
+// Asynchronous page reads and writes against an open DB.
+//
+// Up to queueDepth requests may be outstanding at once. Submit a request
+// with SubmitRead or SubmitWrite, then collect finished requests with
+// WaitForCompletions; requests finish in any order, so each one carries a
+// tag chosen by the caller. The page memory must stay valid until the
+// request's completion has been returned.
+//
+// The transfers are positional and never move the DB's file offset, so
+// DB::ReadPage and DB::WritePage may still be used alongside, without any
+// latch, as long as they are not given a page with an outstanding request.
+// On Windows, where the C runtime has no positional I/O, the thread pool
+// opens a handle of its own on the file and gives every transfer its
+// offset through an OVERLAPPED, so the workers' transfers are in flight
+// together there too.
+public ref class AsyncIO
+{
+	DB *db;
+	int fd;
+	IOBackend backend;
+	int queueDepth;
+	IORequest *requests;	// queueDepth slots.
+	int freeSlot;			// First free slot, -1 if all are in use.
+	int numOutstanding;		// Slots in use.
+
+	// io_uring backend.
+	UringQueue *ring;
+
+	// Thread pool backend. The queues hold slot numbers and are protected by
+	// latch, which workers and waiters also use to signal each other.
+	Object^ latch;
+	array<Thread^>^ workers;
+	void *fileHandle;		// Windows: overlapped handle on the database file.
+	bool running;
+	int *pending;
+	int pendingHead;
+	int numPending;
+	int *finished;
+	int finishedHead;
+	int numFinished;
+
+	Status OpenRing();
+	void CloseRing();
+	Status StartWorkers(int numOfWorkers);
+	void StopWorkers();
+	void WorkerLoop();
+	Status Submit(PageID pid, Page *page, bool write, int tag);
+	void ReleaseSlot(int slot, IOCompletion &done);
+
+public:
+
+	//--------------------------------------------------------------------
+	// Constructor for AsyncIO
+	//
+	// Input   : db         - the database to read and write
+	//           backend    - IO_URING, IO_THREAD_POOL, or IO_AUTO to
+	//                        pick io_uring when it is available
+	//           queueDepth - the most requests outstanding at once
+	// Output  : status - OK, or FAIL if the backend could not be set up
+	//--------------------------------------------------------------------
+	AsyncIO(DB *db, IOBackend backend, int queueDepth, Status &status);
+
+	//--------------------------------------------------------------------
+	// Destructor for AsyncIO
+	//
+	// Input   : None
+	// Output  : None
+	// PostCond: Outstanding requests have finished and their completions
+	//           are dropped.
+	//--------------------------------------------------------------------
+	~AsyncIO();
+
+	//--------------------------------------------------------------------
+	// AsyncIO::SubmitRead
+	//
+	// Input    : pid  - the page to read
+	//            page - where to put its contents
+	//            tag  - returned with the request's completion
+	// Output   : None
+	// Purpose  : Start reading the page. With io_uring the request is
+	//            only handed to the kernel by Flush or WaitForCompletions,
+	//            so that a batch of requests costs a single system call.
+	// Return   : OK if the request was accepted. FAIL if the page is out
+	//            of range or queueDepth requests are already outstanding.
+	//--------------------------------------------------------------------
+	Status SubmitRead(PageID pid, Page *page, int tag);
+
+	//--------------------------------------------------------------------
+	// AsyncIO::SubmitWrite
+	//
+	// Input    : pid  - the page to write
+	//            page - its new contents
+	//            tag  - returned with the request's completion
+	// Output   : None
+	// Purpose  : Start writing the page. See SubmitRead.
+	// Return   : OK if the request was accepted. FAIL otherwise.
+	//--------------------------------------------------------------------
+	Status SubmitWrite(PageID pid, Page *page, int tag);
+
+	//--------------------------------------------------------------------
+	// AsyncIO::Flush
+	//
+	// Input    : None
+	// Output   : None
+	// Purpose  : Hand every accepted request to the backend.
+	// Return   : OK, or FAIL if the kernel refused the requests.
+	//--------------------------------------------------------------------
+	Status Flush();
+
+	//--------------------------------------------------------------------
+	// AsyncIO::WaitForCompletions
+	//
+	// Input    : minDone - wait until at least this many requests have
+	//                      finished; 0 only collects what is ready
+	//            maxDone - room in done
+	// Output   : done    - the finished requests
+	// Purpose  : Flush, then collect finished requests and free their
+	//            slots.
+	// Return   : The number of entries stored in done.
+	//--------------------------------------------------------------------
+	int WaitForCompletions(int minDone, IOCompletion *done, int maxDone);
+
+	int GetNumOutstanding();
+
+	IOBackend GetBackend();
+};
+
+#endif // _ASYNC_IO_H
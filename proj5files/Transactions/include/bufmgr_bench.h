@@ -0,0 +1,65 @@
+#ifndef _BUFMGR_BENCH_H
+#define _BUFMGR_BENCH_H
+
+#include "threadsafe_bufmgr.h"
+
+// One benchmark thread: pins and unpins random pages of a fixed set,
+// marking dirtyPercent percent of them dirty.
+public ref class PinUnpinWorker
+{
+	ThreadSafeBufMgr^ BM;
+	PageID *pids;
+	int numOfPids;
+	int numOfOps;
+	int dirtyPercent;
+	unsigned int seed;
+
+public:
+	PinUnpinWorker(ThreadSafeBufMgr^ BM, PageID *pids, int numOfPids, int numOfOps, int dirtyPercent, int id)
+	{
+		this->BM = BM;
+		this->pids = pids;
+		this->numOfPids = numOfPids;
+		this->numOfOps = numOfOps;
+		this->dirtyPercent = dirtyPercent;
+		this->seed = id * 7919 + 1;
+	}
+
+	void run();
+};
+
+// Measures pin/unpin throughput of ThreadSafeBufMgr for 1 to 16 threads,
+// with a single shard and with one shard per 64 frames.
+void benchPinUnpin();
+
+// Runs a write-heavy workload that does not fit in the pool, with and
+// without the background flusher, and reports the foreground write stalls.
+void benchFlusher();
+
+// Scans a file four times larger than the pool from a cold pool, with and
+// without read-ahead, in file order and in a shuffled leaf-chain order.
+void benchReadAhead();
+
+// Compares MB/s of one page per DB call with DB::ReadPages/WritePages
+// runs of up to 64 pages, on a database of one million pages.
+void benchVectoredIO();
+
+// Measures random-read IOPS through AsyncIO at queue depths 1 to 64, with
+// the io_uring backend when it is available and with the thread pool.
+void benchAsyncIO();
+
+// Runs an insert and scan workload larger than the pool with and without
+// direct I/O, and reports throughput, the process's resident set and how
+// much the operating system's file cache grew.
+void benchDirectIO();
+
+// Compares full scans and B+ tree style range scans of a read-only file
+// through the pool with the same scans through ThreadSafeBufMgr's
+// read-only mapped mode.
+void benchMappedScan();
+
+// Compares DB::AllocatePage with SpaceMap::AllocatePage on a database of
+// MINIBASE_DB_SIZE pages that is 10%, 50% and 95% full.
+void benchSpaceMap();
+
+#endif // _BUFMGR_BENCH_H
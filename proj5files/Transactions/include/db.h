@@ -56,6 +56,26 @@ public:
 	// Write the contents of the specified page.
 	Status WritePage(PageID pageno, Page *pageptr);
 
+	// Read a run of count contiguous pages, starting at pageno, into the
+	// given pages with as few system calls as possible. The pages need
+	// not be contiguous in memory.
+	Status ReadPages(PageID pageno, int count, Page **pageptrs);
+
+	// Write a run of count contiguous pages, starting at pageno, from the
+	// given pages with as few system calls as possible.
+	Status WritePages(PageID pageno, int count, Page **pageptrs);
+
+	// Open a second descriptor on the database file that bypasses the
+	// operating system's page cache (O_DIRECT, or FILE_FLAG_NO_BUFFERING
+	// on Windows), and close it again.
+	Status OpenDirect(int &directFd);
+	Status CloseDirect(int directFd);
+
+	// Same as ReadPages/WritePages, through a descriptor from OpenDirect.
+	// Every page must be MINIBASE_PAGESIZE aligned in memory.
+	Status ReadPagesDirect(int directFd, PageID pageno, int count, Page **pageptrs);
+	Status WritePagesDirect(int directFd, PageID pageno, int count, Page **pageptrs);
+
 	// Allocate a Set of pages where the run size is taken to be 1 by default.
 	// Gives back the page number of the first page of the allocated run.
 	Status AllocatePage(PageID &start_page_num, int run_size = 1);
@@ -81,6 +101,10 @@ public:
 	int GetNumOfPages() const;
 	int GetPageSize() const;
 
+	// The descriptor of the open database file, for positional and
+	// asynchronous I/O that bypasses ReadPage and WritePage.
+	int GetFileDescriptor() const;
+
 	// Print out the space map of the database.
 	// The space map is a bitmap showing which
 	// pages of the db are currently allocated.
@@ -0,0 +1,47 @@
+#ifndef _PAGETABLE_H
+#define _PAGETABLE_H
+
+#include "minirel.h"
+#include "page.h"
+#include "frame.h"
+
+// PageTable maps the PageID of a resident page to the frame holding it.
+//
+// It offers the same interface as HashTable, but uses open addressing with
+// linear probing over two preallocated arrays instead of a fixed number of
+// chained buckets.  The capacity is the smallest power of two that keeps the
+// load factor at or below one half with maxEntries pages in the table, so a
+// lookup touches a couple of adjacent entries no matter how many frames the
+// pool has, and Insert/Delete never allocate.  maxEntries is a hard bound,
+// checked by Insert: a pool that keeps an evicted page mapped next to the
+// new one while it is written back must ask for two entries per frame.
+class PageTable
+{
+private:
+
+	PageID *pids;		// PageID stored in each entry, INVALID_PAGE if the entry is free.
+	int *frameNos;		// Frame number stored in each entry.
+	int capacity;		// Number of entries, always a power of two.
+	int maxEntries;		// Most pages the table may hold, at most capacity / 2.
+	int numOfEntries;	// Pages in the table.
+	int mask;			// capacity - 1.
+	int shift;			// 32 - log2(capacity), used by Hash.
+
+	// Home entry of the given page.
+	int Hash(PageID pid);
+
+	// Entry holding the given page, or -1 if the page is not in the table.
+	int FindEntry(PageID pid);
+
+public:
+
+	PageTable(int maxEntries);
+	~PageTable();
+
+	void Insert(PageID pid, int frameNo);
+	Status Delete(PageID pid);
+	int LookUp(PageID pid);
+	void EmptyIt();
+};
+
+#endif
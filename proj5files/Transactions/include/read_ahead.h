@@ -0,0 +1,76 @@
+#ifndef _READ_AHEAD_H
+#define _READ_AHEAD_H
+
+#include "threadsafe_bufmgr.h"
+
+// A scan declares its access pattern by reading its pages through a
+// ReadAheadScan: it hands over the pages it will visit, in order, and gets
+// them back pinned one at a time while the next pages are prefetched.
+//
+// A heap file scan passes the data pages listed by its directory pages, and a
+// B+ tree range scan passes the leaves listed by the index page above them. A
+// run of contiguous pages can be given as its first page and length.
+public ref class ReadAheadScan
+{
+	ThreadSafeBufMgr^ BM;
+	const PageID *pids;		// Pages to visit, or NULL for a contiguous run.
+	PageID first;			// First page of a contiguous run.
+	int count;				// Number of pages to visit.
+	int window;				// Number of pages kept loading ahead of the scan.
+
+	int next;				// Index of the next page to pin.
+	int prefetched;			// Pages before this index have been passed to Prefetch.
+	PageID current;			// Page pinned by the last GetNext, or INVALID_PAGE.
+
+	PageID PageAt(int i);
+	void ReadAhead();
+
+public:
+
+	//--------------------------------------------------------------------
+	// Constructor for ReadAheadScan
+	//
+	// Input   : BM     - the buffer manager to pin pages in
+	//           pids   - the pages to visit, in order. The array must
+	//                    outlive the scan.
+	//           count  - number of pages to visit
+	//           window - number of pages to keep loading ahead
+	// Output  : None
+	//--------------------------------------------------------------------
+	ReadAheadScan(ThreadSafeBufMgr^ BM, const PageID *pids, int count, int window);
+
+	//--------------------------------------------------------------------
+	// Constructor for ReadAheadScan
+	//
+	// Input   : BM     - the buffer manager to pin pages in
+	//           first  - the first page of a contiguous run
+	//           count  - number of pages in the run
+	//           window - number of pages to keep loading ahead
+	// Output  : None
+	//--------------------------------------------------------------------
+	ReadAheadScan(ThreadSafeBufMgr^ BM, PageID first, int count, int window);
+
+	//--------------------------------------------------------------------
+	// Destructor for ReadAheadScan
+	//
+	// Input   : None
+	// Output  : None
+	// PostCond: The page returned by the last GetNext is unpinned.
+	//--------------------------------------------------------------------
+	~ReadAheadScan();
+
+	//--------------------------------------------------------------------
+	// ReadAheadScan::GetNext
+	//
+	// Input    : None
+	// Output   : pid  - the next page of the scan
+	//            page - the page, pinned
+	// Purpose  : Unpin the page returned by the previous call and pin the
+	//            next one, topping up the pages being prefetched.
+	// Return   : OK if a page was pinned, DONE at the end of the scan,
+	//            FAIL if the page could not be pinned.
+	//--------------------------------------------------------------------
+	Status GetNext(PageID &pid, Page *&page);
+};
+
+#endif // _READ_AHEAD_H
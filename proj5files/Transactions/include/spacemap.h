@@ -0,0 +1,53 @@
+#ifndef _SPACEMAP_H
+#define _SPACEMAP_H
+
+#include "db.h"
+
+// Longest run size that gets its own free-run hint.
+const int MAX_HINTED_RUN = 64;
+
+// SpaceMap allocates and frees runs of pages of a DB, like
+// DB::AllocatePage and DB::DeallocatePage, but keeps the whole space map
+// in memory as 64-bit words. A word with all bits set is skipped in one
+// step, and free runs inside a word are found with count-trailing-zeros
+// rather than bit by bit.
+//
+// The search is next fit: it carries on from where the last allocation
+// ended instead of rescanning the allocated front of the database. Each
+// freed run also leaves a hint for its size, so a request that fits a
+// recently freed hole takes it without a search.
+//
+// The space map pages are updated through MINIBASE_BM, the same way DB
+// updates them, so the database stays consistent. Pages allocated or freed
+// through DB directly are not seen until Reload is called.
+//
+// DB::AllocatePage itself lives in the prebuilt library and cannot be
+// pointed at a SpaceMap; ThreadSafeBufMgr::UseSpaceMap routes the pool's
+// NewPage and FreePage through one instead.
+class SpaceMap
+{
+private:
+	DB *db;
+	int numOfPages;			// Pages in the database.
+	int numOfMapPages;		// Space map pages, starting at page 1.
+	int numOfWords;			// Words covering numOfPages bits.
+	unsigned long long *words;	// Bit i set if page i is allocated. Bits past numOfPages are set.
+	int numOfFree;			// Free pages.
+	int cursor;				// Word where the next-fit search starts.
+	int hints[MAX_HINTED_RUN + 1];	// hints[k]: word where a free run of k pages was left, or -1.
+
+	int FindRun(int runSize, int fromWord, int toWord);
+	void SetBits(PageID start, int runSize, bool allocated);
+	Status WriteBack(PageID start, int runSize);
+
+public:
+	SpaceMap(DB *db, Status &status);
+	~SpaceMap();
+
+	Status Reload();
+	Status AllocatePage(PageID &start, int runSize = 1);
+	Status DeallocatePage(PageID start, int runSize = 1);
+	int GetNumOfFreePages();
+};
+
+#endif
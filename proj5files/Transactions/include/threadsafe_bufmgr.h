@@ -1,12 +1,366 @@
 #ifndef _TSBUF_H
 #define _TSBUF_H
 
+#using <System.dll>
+using namespace System;
+using namespace System::Threading;
+using namespace System::Collections::Generic;
+#ifdef _WIN32
+using namespace System::IO;
+using namespace System::IO::MemoryMappedFiles;
+#endif
+
+#include "db.h"
+#include "page.h"
+#include "array_lru.h"
+#include "pagetable.h"
+#include "async_io.h"
+#include "spacemap.h"
+
+// Bookkeeping for one frame of a shard. The frame's page is the entry with
+// the same index in the shard's page array.
+struct ShardFrame
+{
+	PageID pid;		// Page held by the frame, INVALID_PAGE if the frame is free.
+	int pinCount;
+	bool dirty;
+	bool flushed;	// Written back by the flusher since the page was last dirtied.
+	bool inIO;		// Being read or written with the shard unlatched; PinPage waits until it is done.
+	PageID victimPid;	// Dirty page still to be written out of the frame before pid is read, or INVALID_PAGE.
+};
+
+// A frame of some shard, as collected for a batch of reads or writes.
+struct FrameRef
+{
+	PageID pid;
+	int shard;
+	int frame;
+};
+
+// One partition of the buffer pool. Every page hashes to exactly one shard,
+// and a shard's frames, page table, replacer and counters are only touched
+// while holding that shard's latch.
+struct BufShard
+{
+	int numOfBuf;
+	ShardFrame *frames;
+	Page *pages;
+	PageTable *pageTable;
+	ArrayLRU *replacer;
+
+	int numDirty;		// Number of dirty frames.
+
+	long totalCall;		// Number of pin requests.
+	long totalMiss;		// Number of pin requests that had to read the page.
+	long numDirtyWrite;	// Number of dirty victims written back by PinPage.
+	long numStallAvoided;	// Number of victims that were clean because the flusher wrote them.
+	long numFlushed;	// Number of pages written by the flusher.
+	long numPrefetched;	// Number of pages read by the prefetcher.
+};
+
+// A buffer manager that can be shared by concurrent transactions.
+//
+// The frames and the page table are split into shards by hashing the PageID,
+// and each shard has its own latch and LRU replacer. Threads pinning pages in
+// different shards never wait for each other. A miss reads its page, and
+// writes back a dirty victim, with the shard unlatched, so that it does not
+// hold up the other threads of the shard; only the reads and writes of the
+// database file itself are serialized, since DB is not thread safe.
+//
+// An optional background flusher writes dirty unpinned pages back ahead of
+// the replacer, so that PinPage rarely has to write a dirty victim itself.
+// Scans that know which pages they will read next pass them to Prefetch,
+// and a background prefetcher reads them while the scan works on the
+// current page.
+//
+// For a database that is never written, MapDatabase maps the whole file
+// read only. PinPage then returns a pointer into the mapping, without
+// copying the page into a frame, and pins are only counted.
 public ref class ThreadSafeBufMgr
 {
-	Status PinPage(PageID pid, Page *&page, bool IsEmpty);
+	int numOfBuf;
+	int numOfShards;
+	BufShard *shards;
+	array<Object^>^ shardLatches;
+	Object^ dbLatch;
+	Page *pageSlab;			// Memory of every frame, MINIBASE_PAGESIZE aligned.
+	int directFd;			// Descriptor from DB::OpenDirect, -1 when not using direct I/O.
+
+	Thread^ flusher;
+	volatile bool flusherRunning;
+	int flushRate;			// Pages per second the flusher may write.
+	int highWatermark;		// Percentage of dirty frames that starts a bulk flush.
+	int lowWatermark;		// Percentage of dirty frames that ends a bulk flush.
+	int *flushCandidates;	// Scratch space for FlushShard, one entry per frame of the largest shard.
+	int *flushFrames;		// FlushShard's batch in PageID order, same size.
+
+	Thread^ prefetcher;
+	bool prefetcherRunning;		// Protected by prefetchQueue's monitor.
+	Queue<PageID>^ prefetchQueue;
+	AsyncIO^ asyncIO;		// Used by the prefetcher when set, see UseAsyncIO.
+	SpaceMap *spaceMap;		// Used by NewPage and FreePage when set, see UseSpaceMap.
+
+	char *mapBase;			// The read-only mapping of the database, NULL when not mapped.
+	int numOfMappedPages;
+	int numOfMappedPins;	// Pins of mapped pages not yet unpinned.
+#ifdef _WIN32
+	MemoryMappedFile^ mappedFile;
+	MemoryMappedViewAccessor^ mappedView;
+#endif
+
+	void Init(int bufSize, int numOfShards, bool directIO);
+	int ShardOf(PageID pid);
+	Status ReadPage(PageID pid, Page *page);
+	Status WritePage(PageID pid, Page *page);
+	Status ReadPages(PageID first, int count, Page **pages);
+	Status WritePages(PageID first, int count, Page **pages);
+	void FlushLoop();
+	int FlushShard(int s, int lookAhead, int maxPages);
+	void ReserveFrame(BufShard &shard, int f, PageID pid);
+	Status WriteBackVictim(int s, int f);
+	int WaitForFrame(int s, PageID pid);
+	void StartPrefetcher();
+	void StopPrefetcher();
+	void PrefetchLoop();
+	void LoadPages(const PageID *pids, int count);
+	void FinishLoad(const FrameRef &ref, Status status);
+
+public:
+
+	//--------------------------------------------------------------------
+	// Constructor for ThreadSafeBufMgr
+	//
+	// Input   : bufSize     - number of pages in this buffer manager
+	//           numOfShards - number of partitions of the pool. Each
+	//                         shard gets bufSize / numOfShards frames.
+	// Output  : None
+	// PostCond: All frames are empty.
+	//--------------------------------------------------------------------
+	ThreadSafeBufMgr(int bufSize, int numOfShards);
+
+	//--------------------------------------------------------------------
+	// Constructor for ThreadSafeBufMgr
+	//
+	// Input   : bufSize     - number of pages in this buffer manager
+	//           numOfShards - number of partitions of the pool
+	//           directIO    - if true, pages are read and written with
+	//                         O_DIRECT, so they are cached once, in the
+	//                         pool, rather than again in the operating
+	//                         system's page cache.
+	// Output  : None
+	// PostCond: All frames are empty.
+	//--------------------------------------------------------------------
+	ThreadSafeBufMgr(int bufSize, int numOfShards, bool directIO);
+
+	//--------------------------------------------------------------------
+	// Destructor for ThreadSafeBufMgr
+	//
+	// Input   : None
+	// Output  : None
+	// PostCond: All dirty pages are written to disk.
+	//--------------------------------------------------------------------
+	~ThreadSafeBufMgr();
+
+	//--------------------------------------------------------------------
+	// Finalizer for ThreadSafeBufMgr
+	//
+	// Input   : None
+	// Output  : None
+	// PostCond: The native memory of the pool is freed. Dirty pages are
+	//           not written; dispose of the pool to have them written.
+	//--------------------------------------------------------------------
+	!ThreadSafeBufMgr();
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::PinPage
+	//
+	// Input    : pid     - page id of a particular page
+	//            isEmpty - if true indicate that the page to be pinned is
+	//                      an empty page, and need not be read.
+	// Output   : page - a pointer to a page in the buffer pool. (NULL
+	//            if fail)
+	// Purpose  : Pin the page with page id = pid to the buffer. Only the
+	//            shard the page hashes to is latched.
+	// Condition: Either the page is already in the buffer, or there is at
+	//            least one unpinned frame in the page's shard.
+	// Return   : OK if operation is successful.  FAIL otherwise.
+	//--------------------------------------------------------------------
+	Status PinPage(PageID pid, Page *&page, bool isEmpty);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::UnpinPage
+	//
+	// Input    : pid     - page id of a particular page
+	//            dirty   - indicate whether the page is dirty.
+	// Output   : None
+	// Purpose  : Unpin the page with page id = pid in the buffer.
+	// Condition: The page is already in the buffer and is pinned.
+	// Return   : OK if operation is successful.  FAIL otherwise.
+	//--------------------------------------------------------------------
 	Status UnpinPage(PageID pid, bool dirty);
-	Status NewPage(PageID &firstPid, Page *&firstPage,int howMany);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::NewPage
+	//
+	// Input    : howMany - how many pages to allocate.
+	// Output   : firstPid  - the page id of the first page allocated.
+	//            firstPage - a pointer to the page in memory.
+	// Purpose  : Allocate howMany pages, and pin the first page into the
+	//            buffer.
+	// Return   : OK if operation is successful.  FAIL otherwise.
+	//--------------------------------------------------------------------
+	Status NewPage(PageID &firstPid, Page *&firstPage, int howMany);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::FreePage
+	//
+	// Input    : pid     - page id of a particular page
+	// Output   : None
+	// Purpose  : Drop the page from the buffer and deallocate it.
+	// Condition: The page is pinned no more than once, or is not in the
+	//            buffer.
+	// Return   : OK if operation is successful.  FAIL otherwise.
+	//--------------------------------------------------------------------
 	Status FreePage(PageID pid);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::FlushAllPages
+	//
+	// Input    : None
+	// Output   : None
+	// Purpose  : Write every dirty page in the pool to disk, one vectored
+	//            write per run of consecutive pages. Pages stay resident.
+	//            No shard is latched during the writes; a page stays
+	//            pinned until its write is done, so FreePage of it fails
+	//            meanwhile.
+	// Return   : OK if operation is successful.  FAIL otherwise.
+	//--------------------------------------------------------------------
+	Status FlushAllPages();
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::GetNumOfUnpinnedFrames
+	//
+	// Input    : None
+	// Output   : None
+	// Return   : The number of unpinned frames across all shards.
+	//--------------------------------------------------------------------
+	unsigned int GetNumOfUnpinnedFrames();
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::StartFlusher
+	//
+	// Input    : pagesPerSecond - the most pages the flusher writes per
+	//                             second.
+	//            highWatermark  - percentage of dirty frames at which the
+	//                             flusher starts cleaning the whole pool.
+	//            lowWatermark   - percentage of dirty frames at which it
+	//                             goes back to cleaning only the frames
+	//                             next in line for replacement.
+	// Output   : None
+	// Purpose  : Start the background flusher thread.
+	// Return   : OK if the flusher was started. FAIL if it is already
+	//            running or the settings are out of range.
+	//--------------------------------------------------------------------
+	Status StartFlusher(int pagesPerSecond, int highWatermark, int lowWatermark);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::StopFlusher
+	//
+	// Input    : None
+	// Output   : None
+	// Purpose  : Stop the flusher thread and wait for it to exit.
+	//--------------------------------------------------------------------
+	void StopFlusher();
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::Prefetch
+	//
+	// Input    : first - page id of the first page of a run of pages
+	//            count - number of pages in the run
+	// Output   : None
+	// Purpose  : Start reading the pages into the pool in the background,
+	//            without pinning them. A scan calls this for the pages it
+	//            will pin next, e.g. the next K data pages listed in a
+	//            directory page, so that they are resident by the time
+	//            it gets to them.
+	// Return   : OK if the request was queued. FAIL otherwise.
+	//--------------------------------------------------------------------
+	Status Prefetch(PageID first, int count);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::Prefetch
+	//
+	// Input    : pids  - page ids, in the order they will be pinned
+	//            count - number of page ids
+	// Output   : None
+	// Purpose  : Same as above, for pages that are not contiguous.
+	// Return   : OK if the request was queued. FAIL otherwise.
+	//--------------------------------------------------------------------
+	Status Prefetch(const PageID *pids, int count);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::UseAsyncIO
+	//
+	// Input    : io - an AsyncIO over MINIBASE_DB, or nullptr
+	// Output   : None
+	// Purpose  : Have the prefetcher submit all reads of a batch to io at
+	//            once, so that they overlap, rather than issuing one
+	//            vectored read per run of consecutive pages.
+	//--------------------------------------------------------------------
+	void UseAsyncIO(AsyncIO^ io);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::UseSpaceMap
+	//
+	// Input    : sm - a SpaceMap over MINIBASE_DB, or NULL
+	// Output   : None
+	// Purpose  : Have NewPage and FreePage allocate and free pages through
+	//            sm instead of DB::AllocatePage and DB::DeallocatePage.
+	//            sm only sees its own changes, so while it is in use every
+	//            allocation of the database must go through this pool.
+	//--------------------------------------------------------------------
+	void UseSpaceMap(SpaceMap *sm);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::MapDatabase
+	//
+	// Input    : None
+	// Output   : None
+	// Purpose  : Switch an empty pool to read-only mapped mode. PinPage
+	//            returns pages straight from a mapping of the database
+	//            file; pinning an empty page, unpinning a page as dirty,
+	//            NewPage and FreePage fail, and Prefetch becomes a hint
+	//            to the kernel. Writing to a mapped page is an access
+	//            violation.
+	// Return   : OK if the file is mapped. FAIL otherwise.
+	//--------------------------------------------------------------------
+	Status MapDatabase();
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::UnmapDatabase
+	//
+	// Input    : None
+	// Output   : None
+	// Purpose  : Leave mapped mode. No mapped page may still be in use.
+	//--------------------------------------------------------------------
+	void UnmapDatabase();
+
+	void GetStat(long &pinNo, long &missNo);
+
+	//--------------------------------------------------------------------
+	// ThreadSafeBufMgr::GetFlushStat
+	//
+	// Input    : None
+	// Output   : flushedNo     - pages written by the flusher
+	//            stallAvoidNo  - misses whose victim was clean because the
+	//                            flusher had written it
+	//            dirtyWriteNo  - misses that had to write a dirty victim
+	//--------------------------------------------------------------------
+	void GetFlushStat(long &flushedNo, long &stallAvoidNo, long &dirtyWriteNo);
+
+	long GetNumOfPrefetchedPages();
+
+	void ResetStat();
 };
 
 #endif //_TSBUF_H
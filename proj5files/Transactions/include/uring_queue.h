@@ -0,0 +1,44 @@
+#ifndef _URING_QUEUE_H
+#define _URING_QUEUE_H
+
+struct io_uring;
+
+// UringQueue is the io_uring backend of AsyncIO: a ring with one
+// submission entry per request slot, reading and writing whole pages of an
+// open file at their positions.
+//
+// liburing's inline functions cannot be compiled as managed code, so the
+// ring lives in this native class, in a translation unit of its own that
+// is built without /clr, and AsyncIO only sees the opaque pointer. For the
+// same reason this header does not include minirel.h, whose enums are
+// managed. Without MINIBASE_IO_URING the ring can never be opened.
+class UringQueue
+{
+private:
+
+	struct io_uring *ring;
+	int fd;
+	int pageSize;
+	int numUnsubmitted;	// Transfers prepared but not yet handed to the kernel.
+
+public:
+
+	// Set up a ring of the given depth over fd. ok is false when the tree
+	// is built without liburing, or the kernel forbids io_uring.
+	UringQueue(int fd, int pageSize, int depth, bool &ok);
+	~UringQueue();
+
+	// Queue a transfer of page pageNo, tagged with slot. Returns false if
+	// no submission entry is free even after submitting the queued ones.
+	bool Prepare(bool write, int pageNo, void *page, int slot);
+
+	// Hand every queued transfer to the kernel. Returns false on error.
+	bool Submit();
+
+	// Collect one finished transfer, waiting for it if wait is true.
+	// Returns 1 with its slot and whether the whole page was transferred,
+	// 0 if none is ready, or -1 on an error of the ring.
+	int Reap(bool wait, int &slot, bool &transferred);
+};
+
+#endif
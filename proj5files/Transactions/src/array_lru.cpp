@@ -0,0 +1,206 @@
+#include <iostream>
+
+#include "array_lru.h"
+#include "frame.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------
+// ArrayLRU::ArrayLRU
+//
+// Input   : n - the number of frames in the buffer pool.
+// Output  : None.
+// Purpose : Create an empty list with links for every frame of the pool,
+//           so that no call allocates afterwards.
+//-------------------------------------------------------------------
+ArrayLRU::ArrayLRU(int n)
+{
+	capacity = n;
+	prev = new int[capacity];
+	next = new int[capacity];
+	inList = new bool[capacity];
+	for (int i = 0; i < capacity; i++)
+	{
+		prev[i] = next[i] = INVALID_FRAME;
+		inList[i] = false;
+	}
+
+	first = last = INVALID_FRAME;
+	numFrames = 0;
+}
+
+ArrayLRU::~ArrayLRU()
+{
+	delete [] prev;
+	delete [] next;
+	delete [] inList;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::IsPresent
+//
+// Input   : f - a frame number.
+// Output  : None.
+// Return  : true if f is a replacement candidate.
+//-------------------------------------------------------------------
+bool ArrayLRU::IsPresent(int f)
+{
+	return f >= 0 && f < capacity && inList[f];
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::Unlink
+//
+// Input   : f - a frame in the list.
+// Output  : None.
+// Purpose : Take f out of the list.
+//-------------------------------------------------------------------
+void ArrayLRU::Unlink(int f)
+{
+	if (prev[f] != INVALID_FRAME)
+		next[prev[f]] = next[f];
+	else
+		first = next[f];
+
+	if (next[f] != INVALID_FRAME)
+		prev[next[f]] = prev[f];
+	else
+		last = prev[f];
+
+	prev[f] = next[f] = INVALID_FRAME;
+	inList[f] = false;
+	numFrames--;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::PickVictim
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Remove the least recently used frame from the list.
+// Return  : That frame, or INVALID_FRAME if there is no candidate.
+//-------------------------------------------------------------------
+int ArrayLRU::PickVictim()
+{
+	if (numFrames == 0)
+		return INVALID_FRAME;
+
+	int f = first;
+	Unlink(f);
+	return f;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::AddFrame
+//
+// Input   : f - a frame whose pin count dropped to zero.
+// Output  : None.
+// Purpose : Make f the most recently used candidate.
+//-------------------------------------------------------------------
+void ArrayLRU::AddFrame(int f)
+{
+	if (f < 0 || f >= capacity)
+		return;
+
+	if (inList[f])
+		Unlink(f);
+
+	prev[f] = last;
+	next[f] = INVALID_FRAME;
+	if (last != INVALID_FRAME)
+		next[last] = f;
+	else
+		first = f;
+	last = f;
+	inList[f] = true;
+	numFrames++;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::AddFreeFrame
+//
+// Input   : f - a frame that no longer holds a page.
+// Output  : None.
+// Purpose : Make f the least recently used candidate, so that it is the
+//           next victim rather than a frame that still holds a page.
+//-------------------------------------------------------------------
+void ArrayLRU::AddFreeFrame(int f)
+{
+	if (f < 0 || f >= capacity)
+		return;
+
+	if (inList[f])
+		Unlink(f);
+
+	prev[f] = INVALID_FRAME;
+	next[f] = first;
+	if (first != INVALID_FRAME)
+		prev[first] = f;
+	else
+		last = f;
+	first = f;
+	inList[f] = true;
+	numFrames++;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::RemoveFrame
+//
+// Input   : f - a frame that has been pinned.
+// Output  : None.
+// Purpose : Remove f from the candidates, if it is one.
+//-------------------------------------------------------------------
+void ArrayLRU::RemoveFrame(int f)
+{
+	if (IsPresent(f))
+		Unlink(f);
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::PrintQueue
+//
+// Input   : None.
+// Output  : None.
+// Purpose : Print the candidates from least to most recently used.
+//-------------------------------------------------------------------
+void ArrayLRU::PrintQueue()
+{
+	cout << "ArrayLRU queue:";
+	for (int f = first; f != INVALID_FRAME; f = next[f])
+	{
+		cout << " " << f;
+	}
+	cout << endl;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::GetNumFrames
+//
+// Input   : None.
+// Output  : None.
+// Return  : The number of replacement candidates.
+//-------------------------------------------------------------------
+int ArrayLRU::GetNumFrames()
+{
+	return numFrames;
+}
+
+//-------------------------------------------------------------------
+// ArrayLRU::GetLeastRecent
+//
+// Input   : maxFrames - the most frames to return.
+// Output  : frameNos  - the least recently used candidates, in the order
+//                       PickVictim would return them.
+// Purpose : Let the caller look at the next victims without taking them
+//           out of the list.
+// Return  : The number of frames written to frameNos.
+//-------------------------------------------------------------------
+int ArrayLRU::GetLeastRecent(int *frameNos, int maxFrames)
+{
+	int n = 0;
+	for (int f = first; f != INVALID_FRAME && n < maxFrames; f = next[f])
+	{
+		frameNos[n++] = f;
+	}
+	return n;
+}
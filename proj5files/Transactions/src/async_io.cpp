@@ -0,0 +1,500 @@
+#ifdef _WIN32
+// Before async_io.h, whose using directives clash with the Win32 headers.
+#include <string.h>
+#include <windows.h>
+#else
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+#include "async_io.h"
+
+// Most worker threads of the thread pool backend.
+static const int maxNumOfWorkers = 16;
+
+//--------------------------------------------------------------------
+// DB::GetFileDescriptor
+//
+// Input    : None
+// Output   : None
+// Return   : The descriptor of the open database file.
+//--------------------------------------------------------------------
+int DB::GetFileDescriptor() const
+{
+	return fd;
+}
+
+//--------------------------------------------------------------------
+// TransferPage
+//
+// Input    : fd    - the database file
+//            write - true to write the page, false to read it
+//            pid   - the page
+//            page  - the page's memory
+// Output   : None
+// Purpose  : Move one page between the file and memory with pread or
+//            pwrite, resuming after partial transfers.
+// Return   : true on success, false on an I/O error or end of file.
+//--------------------------------------------------------------------
+#ifdef _WIN32
+static bool TransferPage(HANDLE file, HANDLE event, bool write, PageID pid, Page *page)
+{
+	// The offset travels with the request, so workers sharing the handle
+	// do not disturb each other.
+	ULONGLONG offset = (ULONGLONG)pid * MINIBASE_PAGESIZE;
+	OVERLAPPED overlapped;
+	memset(&overlapped, 0, sizeof(overlapped));
+	overlapped.Offset = (DWORD)offset;
+	overlapped.OffsetHigh = (DWORD)(offset >> 32);
+	overlapped.hEvent = event;
+
+	BOOL started = write ? WriteFile(file, page, MINIBASE_PAGESIZE, NULL, &overlapped)
+		: ReadFile(file, page, MINIBASE_PAGESIZE, NULL, &overlapped);
+	DWORD bytes = 0;
+	return (started || GetLastError() == ERROR_IO_PENDING)
+		&& GetOverlappedResult(file, &overlapped, &bytes, TRUE)
+		&& bytes == (DWORD)MINIBASE_PAGESIZE;
+}
+#else
+static bool TransferPage(int fd, bool write, PageID pid, Page *page)
+{
+	char *buf = (char *)page;
+	off_t offset = (off_t)pid * MINIBASE_PAGESIZE;
+	size_t done = 0;
+
+	while (done < (size_t)MINIBASE_PAGESIZE)
+	{
+		ssize_t bytes = write ? pwrite(fd, buf + done, MINIBASE_PAGESIZE - done, offset + done)
+			: pread(fd, buf + done, MINIBASE_PAGESIZE - done, offset + done);
+		if (bytes < 0 && errno == EINTR)
+			continue;
+		if (bytes <= 0)
+			return false;
+		done += bytes;
+	}
+	return true;
+}
+#endif
+
+//--------------------------------------------------------------------
+// Constructor for AsyncIO
+//
+// Input   : db         - the database to read and write
+//           backend    - the backend asked for
+//           queueDepth - the most requests outstanding at once
+// Output  : status - OK, or FAIL if the backend could not be set up
+// PostCond: Every request slot is free.
+//--------------------------------------------------------------------
+AsyncIO::AsyncIO(DB *db, IOBackend backend, int queueDepth, Status &status)
+{
+	this->db = db;
+	this->fd = db->GetFileDescriptor();
+	this->queueDepth = queueDepth;
+	this->backend = backend;
+	ring = NULL;
+	workers = nullptr;
+	fileHandle = NULL;
+	running = false;
+	pending = NULL;
+	finished = NULL;
+	latch = gcnew Object();
+
+	if (queueDepth < 1)
+	{
+		cerr << "AsyncIO: queue depth must be positive" << endl;
+		requests = NULL;
+		status = FAIL;
+		return;
+	}
+
+	requests = new IORequest[queueDepth];
+	for (int i = 0; i < queueDepth; i++)
+		requests[i].next = i + 1;
+	requests[queueDepth - 1].next = -1;
+	freeSlot = 0;
+	numOutstanding = 0;
+
+	if (backend == IO_URING || backend == IO_AUTO)
+	{
+		status = OpenRing();
+		if (status == OK)
+		{
+			this->backend = IO_URING;
+			return;
+		}
+		if (backend == IO_URING)
+		{
+			cerr << "AsyncIO: io_uring is not available" << endl;
+			return;
+		}
+	}
+
+	this->backend = IO_THREAD_POOL;
+	status = StartWorkers(queueDepth < maxNumOfWorkers ? queueDepth : maxNumOfWorkers);
+}
+
+//--------------------------------------------------------------------
+// Destructor for AsyncIO
+//
+// Input   : None
+// Output  : None
+// PostCond: Outstanding requests have finished, the ring is closed and
+//           the workers have exited.
+//--------------------------------------------------------------------
+AsyncIO::~AsyncIO()
+{
+	if (requests != NULL)
+	{
+		IOCompletion done[16];
+		while (GetNumOutstanding() > 0)
+			WaitForCompletions(1, done, 16);
+	}
+
+	CloseRing();
+	StopWorkers();
+	delete [] requests;
+	requests = NULL;
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::OpenRing
+//
+// Input    : None
+// Output   : None
+// Purpose  : Set up an io_uring with one submission entry per request
+//            slot. Fails when the tree is built without liburing, or
+//            when the kernel is too old or forbids io_uring.
+// Return   : OK if the ring is ready. FAIL otherwise.
+//--------------------------------------------------------------------
+Status AsyncIO::OpenRing()
+{
+	bool ok;
+	ring = new UringQueue(fd, MINIBASE_PAGESIZE, queueDepth, ok);
+	if (!ok)
+	{
+		delete ring;
+		ring = NULL;
+		return FAIL;
+	}
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::CloseRing
+//
+// Input    : None
+// Output   : None
+// Purpose  : Tear down the io_uring, if there is one.
+//--------------------------------------------------------------------
+void AsyncIO::CloseRing()
+{
+	delete ring;
+	ring = NULL;
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::StartWorkers
+//
+// Input    : numOfWorkers - number of threads to start
+// Output   : None
+// Purpose  : Start the thread pool backend.
+// Return   : OK, or FAIL if the file could not be opened for the
+//            workers.
+//--------------------------------------------------------------------
+Status AsyncIO::StartWorkers(int numOfWorkers)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(db->GetName(), GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		cerr << "AsyncIO: could not open " << db->GetName() << endl;
+		return FAIL;
+	}
+	fileHandle = file;
+#endif
+
+	pending = new int[queueDepth];
+	pendingHead = 0;
+	numPending = 0;
+	finished = new int[queueDepth];
+	finishedHead = 0;
+	numFinished = 0;
+
+	running = true;
+	workers = gcnew array<Thread^>(numOfWorkers);
+	for (int i = 0; i < numOfWorkers; i++)
+	{
+		workers[i] = gcnew Thread(gcnew ThreadStart(this, &AsyncIO::WorkerLoop));
+		workers[i]->IsBackground = true;
+		workers[i]->Start();
+	}
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::StopWorkers
+//
+// Input    : None
+// Output   : None
+// Purpose  : Stop the worker threads, if any, and wait for them to exit.
+//--------------------------------------------------------------------
+void AsyncIO::StopWorkers()
+{
+	if (workers == nullptr)
+		return;
+
+	Monitor::Enter(latch);
+	running = false;
+	Monitor::PulseAll(latch);
+	Monitor::Exit(latch);
+
+	for (int i = 0; i < workers->Length; i++)
+		workers[i]->Join();
+	workers = nullptr;
+
+	delete [] pending;
+	delete [] finished;
+	pending = NULL;
+	finished = NULL;
+
+#ifdef _WIN32
+	CloseHandle((HANDLE)fileHandle);
+	fileHandle = NULL;
+#endif
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::WorkerLoop
+//
+// Input    : None
+// Output   : None
+// Purpose  : Body of a worker thread: take the oldest pending request,
+//            carry it out with the latch released, and queue it as
+//            finished. Runs until StopWorkers. The workers' transfers
+//            overlap each other, up to one per worker.
+//--------------------------------------------------------------------
+void AsyncIO::WorkerLoop()
+{
+#ifdef _WIN32
+	// Signalled when this worker's transfer completes.
+	HANDLE event = CreateEvent(NULL, TRUE, FALSE, NULL);
+#endif
+
+	Monitor::Enter(latch);
+	while (true)
+	{
+		while (numPending == 0 && running)
+			Monitor::Wait(latch);
+		if (!running)
+			break;
+
+		int slot = pending[pendingHead];
+		pendingHead = (pendingHead + 1) % queueDepth;
+		numPending--;
+		IORequest &request = requests[slot];
+		Monitor::Exit(latch);
+
+#ifdef _WIN32
+		bool ok = (event != NULL)
+			&& TransferPage((HANDLE)fileHandle, event, request.write, request.pid, request.page);
+#else
+		bool ok = TransferPage(fd, request.write, request.pid, request.page);
+#endif
+
+		Monitor::Enter(latch);
+		request.status = ok ? OK : FAIL;
+		finished[(finishedHead + numFinished) % queueDepth] = slot;
+		numFinished++;
+		Monitor::PulseAll(latch);
+	}
+	Monitor::Exit(latch);
+
+#ifdef _WIN32
+	if (event != NULL)
+		CloseHandle(event);
+#endif
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::Submit
+//
+// Input    : pid   - the page
+//            page  - the page's memory
+//            write - true for a write, false for a read
+//            tag   - returned with the completion
+// Output   : None
+// Purpose  : Take a free slot for the request and pass it to the
+//            backend.
+// Return   : OK if the request was accepted. FAIL otherwise.
+//--------------------------------------------------------------------
+Status AsyncIO::Submit(PageID pid, Page *page, bool write, int tag)
+{
+	if (pid < 0 || pid >= db->GetNumOfPages() || page == NULL)
+	{
+		cerr << "AsyncIO: bad page " << pid << endl;
+		return FAIL;
+	}
+
+	Monitor::Enter(latch);
+	if (freeSlot < 0)
+	{
+		Monitor::Exit(latch);
+		return FAIL;
+	}
+
+	int slot = freeSlot;
+	IORequest &request = requests[slot];
+	freeSlot = request.next;
+	numOutstanding++;
+	request.pid = pid;
+	request.page = page;
+	request.write = write;
+	request.tag = tag;
+	request.status = FAIL;
+
+	if (backend == IO_URING)
+	{
+		// There is one submission entry per slot, so an entry should be
+		// free once the earlier requests have been handed to the kernel;
+		// if the submit failed, give the slot back.
+		if (!ring->Prepare(write, pid, page, slot))
+		{
+			request.next = freeSlot;
+			freeSlot = slot;
+			numOutstanding--;
+			Monitor::Exit(latch);
+			cerr << "AsyncIO: no free submission entry for page " << pid << endl;
+			return FAIL;
+		}
+		Monitor::Exit(latch);
+		return OK;
+	}
+
+	pending[(pendingHead + numPending) % queueDepth] = slot;
+	numPending++;
+	Monitor::Pulse(latch);
+	Monitor::Exit(latch);
+	return OK;
+}
+
+Status AsyncIO::SubmitRead(PageID pid, Page *page, int tag)
+{
+	return Submit(pid, page, false, tag);
+}
+
+Status AsyncIO::SubmitWrite(PageID pid, Page *page, int tag)
+{
+	return Submit(pid, page, true, tag);
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::Flush
+//
+// Input    : None
+// Output   : None
+// Purpose  : Hand the requests queued in the ring to the kernel. The
+//            thread pool picks requests up as they are submitted, so
+//            there is nothing to do for it.
+// Return   : OK, or FAIL if io_uring_submit failed.
+//--------------------------------------------------------------------
+Status AsyncIO::Flush()
+{
+	if (backend == IO_URING)
+	{
+		Monitor::Enter(latch);
+		bool ok = ring->Submit();
+		Monitor::Exit(latch);
+		if (!ok)
+		{
+			cerr << "AsyncIO::Flush: io_uring_submit failed" << endl;
+			return FAIL;
+		}
+	}
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::ReleaseSlot
+//
+// Input    : slot - a finished request's slot
+// Output   : done - the request's completion
+// Purpose  : Report the request and put its slot back on the free list.
+//            Called with the latch held.
+//--------------------------------------------------------------------
+void AsyncIO::ReleaseSlot(int slot, IOCompletion &done)
+{
+	done.tag = requests[slot].tag;
+	done.status = requests[slot].status;
+	requests[slot].next = freeSlot;
+	freeSlot = slot;
+	numOutstanding--;
+}
+
+//--------------------------------------------------------------------
+// AsyncIO::WaitForCompletions
+//
+// Input    : minDone - wait until at least this many requests have
+//                      finished
+//            maxDone - room in done
+// Output   : done    - the finished requests
+// Purpose  : Flush, then collect up to maxDone finished requests. Never
+//            waits for more requests than are outstanding.
+// Return   : The number of entries stored in done.
+//--------------------------------------------------------------------
+int AsyncIO::WaitForCompletions(int minDone, IOCompletion *done, int maxDone)
+{
+	if (Flush() != OK)
+		return 0;
+
+	Monitor::Enter(latch);
+	if (minDone > numOutstanding)
+		minDone = numOutstanding;
+	if (minDone > maxDone)
+		minDone = maxDone;
+
+	int n = 0;
+	if (backend == IO_URING)
+	{
+		while (n < maxDone)
+		{
+			int slot;
+			bool transferred;
+			if (ring->Reap(n < minDone, slot, transferred) <= 0)
+				break;
+
+			requests[slot].status = transferred ? OK : FAIL;
+			ReleaseSlot(slot, done[n++]);
+		}
+		Monitor::Exit(latch);
+		return n;
+	}
+
+	while (n < maxDone)
+	{
+		while (numFinished == 0 && n < minDone)
+			Monitor::Wait(latch);
+		if (numFinished == 0)
+			break;
+
+		int slot = finished[finishedHead];
+		finishedHead = (finishedHead + 1) % queueDepth;
+		numFinished--;
+		ReleaseSlot(slot, done[n++]);
+	}
+	Monitor::Exit(latch);
+	return n;
+}
+
+int AsyncIO::GetNumOutstanding()
+{
+	Monitor::Enter(latch);
+	int n = numOutstanding;
+	Monitor::Exit(latch);
+	return n;
+}
+
+IOBackend AsyncIO::GetBackend()
+{
+	return backend;
+}
@@ -0,0 +1,808 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "bufmgr_bench.h"
+#include "read_ahead.h"
+#include "spacemap.h"
+#include "bufmgr.h"
+
+using namespace System::Diagnostics;
+
+// Pages pinned by the benchmark. They all fit in the pool, so the run
+// measures latching and bookkeeping rather than disk reads.
+static const int numOfBenchPages = 512;
+static const int numOfOpsPerThread = 200000;
+static const int maxNumOfThreads = 16;
+
+void PinUnpinWorker::run()
+{
+	Page *page;
+	for (int i = 0; i < numOfOps; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		PageID pid = pids[(seed >> 16) % numOfPids];
+
+		if (BM->PinPage(pid, page, false) != OK)
+		{
+			cerr << "PinUnpinWorker: could not pin page " << pid << endl;
+			return;
+		}
+		BM->UnpinPage(pid, (int)((seed >> 8) % 100) < dirtyPercent);
+	}
+}
+
+//--------------------------------------------------------------------
+// runPinUnpin
+//
+// Input    : numOfShards  - number of shards of the buffer manager
+//            numOfThreads - number of concurrent workers
+// Output   : None
+// Purpose  : Create a buffer manager holding the benchmark pages and let
+//            numOfThreads workers pin and unpin them concurrently.
+// Return   : Pin/unpin pairs per second, over all threads.
+//--------------------------------------------------------------------
+static double runPinUnpin(int numOfShards, int numOfThreads)
+{
+	ThreadSafeBufMgr^ BM = gcnew ThreadSafeBufMgr(MINIBASE_BUFFER_POOL_SIZE, numOfShards);
+
+	PageID *pids = new PageID[numOfBenchPages];
+	Page *page;
+	for (int i = 0; i < numOfBenchPages; i++)
+	{
+		BM->NewPage(pids[i], page, 1);
+		BM->UnpinPage(pids[i], true);
+	}
+
+	array<Thread^>^ threads = gcnew array<Thread^>(numOfThreads);
+	for (int t = 0; t < numOfThreads; t++)
+	{
+		PinUnpinWorker^ w = gcnew PinUnpinWorker(BM, pids, numOfBenchPages, numOfOpsPerThread, 0, t);
+		threads[t] = gcnew Thread(gcnew ThreadStart(w, &PinUnpinWorker::run));
+	}
+
+	Stopwatch^ timer = Stopwatch::StartNew();
+	for (int t = 0; t < numOfThreads; t++)
+		threads[t]->Start();
+	for (int t = 0; t < numOfThreads; t++)
+		threads[t]->Join();
+	timer->Stop();
+
+	for (int i = 0; i < numOfBenchPages; i++)
+		BM->FreePage(pids[i]);
+	delete BM;
+	delete [] pids;
+
+	return (double)numOfThreads * numOfOpsPerThread / timer->Elapsed.TotalSeconds;
+}
+
+void benchPinUnpin()
+{
+	int numOfShards = MINIBASE_BUFFER_POOL_SIZE / 64;
+
+	cout << "Pin/unpin throughput, " << MINIBASE_BUFFER_POOL_SIZE << " frames, "
+		<< numOfBenchPages << " resident pages" << endl;
+	cout << "threads    1 shard (ops/s)    " << numOfShards << " shards (ops/s)" << endl;
+
+	for (int numOfThreads = 1; numOfThreads <= maxNumOfThreads; numOfThreads *= 2)
+	{
+		double single = runPinUnpin(1, numOfThreads);
+		double sharded = runPinUnpin(numOfShards, numOfThreads);
+		printf("%-10d %-18.0f %.0f\n", numOfThreads, single, sharded);
+	}
+}
+
+void benchFlusher()
+{
+	const int numOfShards = MINIBASE_BUFFER_POOL_SIZE / 64;
+	const int numOfPages = MINIBASE_BUFFER_POOL_SIZE * 4;
+	const int numOfThreads = 4;
+	const int numOfOps = 20000;
+
+	// The pages do not fit in the database main creates, so MINIBASE_DB is
+	// swapped for a scratch one while the benchmark runs.
+	Status status;
+	DB *db = new DB("FLUSHER.DB", numOfPages + 1024, status);
+	if (status != OK)
+	{
+		cerr << "benchFlusher: could not create the database" << endl;
+		return;
+	}
+	DB *savedDB = MINIBASE_DB;
+	MINIBASE_DB = db;
+
+	cout << "Write-back stalls, " << numOfThreads << " threads over " << numOfPages
+		<< " pages, " << MINIBASE_BUFFER_POOL_SIZE << " frames, half the pins dirty the page" << endl;
+	cout << "flusher    seconds    foreground writes    stalls avoided    flushed" << endl;
+
+	for (int useFlusher = 0; useFlusher <= 1; useFlusher++)
+	{
+		ThreadSafeBufMgr^ BM = gcnew ThreadSafeBufMgr(MINIBASE_BUFFER_POOL_SIZE, numOfShards);
+
+		PageID *pids = new PageID[numOfPages];
+		Page *page;
+		int numAllocated = 0;
+		for (; numAllocated < numOfPages; numAllocated++)
+		{
+			if (BM->NewPage(pids[numAllocated], page, 1) != OK)
+				break;
+			BM->UnpinPage(pids[numAllocated], true);
+		}
+		if (numAllocated < numOfPages)
+		{
+			cerr << "benchFlusher: could not allocate page " << numAllocated << endl;
+			for (int i = 0; i < numAllocated; i++)
+				BM->FreePage(pids[i]);
+			delete BM;
+			delete [] pids;
+			break;
+		}
+		BM->FlushAllPages();
+		BM->ResetStat();
+
+		if (useFlusher)
+			BM->StartFlusher(20000, 20, 10);
+
+		array<Thread^>^ threads = gcnew array<Thread^>(numOfThreads);
+		for (int t = 0; t < numOfThreads; t++)
+		{
+			PinUnpinWorker^ w = gcnew PinUnpinWorker(BM, pids, numOfPages, numOfOps, 50, t);
+			threads[t] = gcnew Thread(gcnew ThreadStart(w, &PinUnpinWorker::run));
+		}
+
+		Stopwatch^ timer = Stopwatch::StartNew();
+		for (int t = 0; t < numOfThreads; t++)
+			threads[t]->Start();
+		for (int t = 0; t < numOfThreads; t++)
+			threads[t]->Join();
+		timer->Stop();
+
+		BM->StopFlusher();
+
+		long flushedNo, stallAvoidNo, dirtyWriteNo;
+		BM->GetFlushStat(flushedNo, stallAvoidNo, dirtyWriteNo);
+		printf("%-10s %-10.2f %-20ld %-17ld %ld\n", useFlusher ? "on" : "off",
+			timer->Elapsed.TotalSeconds, dirtyWriteNo, stallAvoidNo, flushedNo);
+
+		for (int i = 0; i < numOfPages; i++)
+			BM->FreePage(pids[i]);
+		delete BM;
+		delete [] pids;
+	}
+
+	MINIBASE_DB = savedDB;
+	delete db;
+	remove("FLUSHER.DB");
+}
+
+// Sum of the bytes read by the last scan, kept so the summing is not
+// optimized away.
+static long scanChecksum;
+
+//--------------------------------------------------------------------
+// scanPages
+//
+// Input    : first     - first page of the file
+//            pids      - pages in scan order, or NULL to scan first,
+//                        first + 1, ...
+//            count     - number of pages to scan
+//            readAhead - prefetch window, 0 to pin pages one at a time
+//            mapped    - pin pages from a read-only mapping of the file
+// Output   : None
+// Purpose  : Scan the pages from a cold pool, summing every byte as a
+//            stand-in for processing the records on each page.
+// Return   : Elapsed seconds.
+//--------------------------------------------------------------------
+static double scanPages(PageID first, const PageID *pids, int count, int readAhead, bool mapped)
+{
+	ThreadSafeBufMgr^ BM = gcnew ThreadSafeBufMgr(MINIBASE_BUFFER_POOL_SIZE, MINIBASE_BUFFER_POOL_SIZE / 64);
+	if (mapped && BM->MapDatabase() != OK)
+	{
+		delete BM;
+		return 0;
+	}
+	long checksum = 0;
+	Page *page;
+	PageID pid;
+
+	Stopwatch^ timer = Stopwatch::StartNew();
+	if (readAhead > 0)
+	{
+		ReadAheadScan^ scan = (pids != NULL)
+			? gcnew ReadAheadScan(BM, pids, count, readAhead)
+			: gcnew ReadAheadScan(BM, first, count, readAhead);
+		while (scan->GetNext(pid, page) == OK)
+		{
+			const char *data = (const char *)page;
+			for (int b = 0; b < MINIBASE_PAGESIZE; b++)
+				checksum += data[b];
+		}
+		delete scan;
+	}
+	else
+	{
+		for (int i = 0; i < count; i++)
+		{
+			pid = (pids != NULL) ? pids[i] : first + i;
+			if (BM->PinPage(pid, page, false) != OK)
+				break;
+			const char *data = (const char *)page;
+			for (int b = 0; b < MINIBASE_PAGESIZE; b++)
+				checksum += data[b];
+			BM->UnpinPage(pid, false);
+		}
+	}
+	timer->Stop();
+
+	delete BM;
+	scanChecksum = checksum;
+	return timer->Elapsed.TotalSeconds;
+}
+
+void benchReadAhead()
+{
+	const int numOfPages = MINIBASE_BUFFER_POOL_SIZE * 4;
+	const int window = 32;
+
+	// The file is bigger than the database main creates, so MINIBASE_DB
+	// is swapped for a scratch one while the benchmark runs.
+	Status status;
+	DB *db = new DB("READAHEAD.DB", numOfPages + 1024, status);
+	if (status != OK)
+	{
+		cerr << "benchReadAhead: could not create the database" << endl;
+		return;
+	}
+	DB *savedDB = MINIBASE_DB;
+	MINIBASE_DB = db;
+
+	// Write the file through a pool of its own, so that the scans start
+	// with an empty pool. The operating system's file cache is not
+	// dropped, so the gain measured here is a lower bound.
+	ThreadSafeBufMgr^ loader = gcnew ThreadSafeBufMgr(MINIBASE_BUFFER_POOL_SIZE, 1);
+	PageID first = INVALID_PAGE;
+	Page *page;
+	status = loader->NewPage(first, page, numOfPages);
+	if (status == OK)
+	{
+		loader->UnpinPage(first, true);
+		for (int i = 1; i < numOfPages && status == OK; i++)
+		{
+			status = loader->PinPage(first + i, page, true);
+			if (status == OK)
+				loader->UnpinPage(first + i, true);
+		}
+	}
+	delete loader;
+	if (status != OK)
+	{
+		cerr << "benchReadAhead: could not write the " << numOfPages << " page file" << endl;
+		MINIBASE_DB = savedDB;
+		delete db;
+		remove("READAHEAD.DB");
+		return;
+	}
+
+	// B+ tree leaves are linked in key order, which is not page order once
+	// the tree has split a few times.
+	PageID *leafOrder = new PageID[numOfPages];
+	for (int i = 0; i < numOfPages; i++)
+		leafOrder[i] = first + i;
+	unsigned int seed = 12345;
+	for (int i = numOfPages - 1; i > 0; i--)
+	{
+		seed = seed * 1103515245 + 12345;
+		int j = (seed >> 16) % (i + 1);
+		PageID t = leafOrder[i];
+		leafOrder[i] = leafOrder[j];
+		leafOrder[j] = t;
+	}
+
+	cout << "Cold full scan of " << numOfPages << " pages, " << MINIBASE_BUFFER_POOL_SIZE
+		<< " frames, read-ahead window " << window << endl;
+	cout << "order        no read-ahead (s)    read-ahead (s)" << endl;
+
+	double plain = scanPages(first, NULL, numOfPages, 0, false);
+	double ahead = scanPages(first, NULL, numOfPages, window, false);
+	printf("%-12s %-20.3f %.3f\n", "file", plain, ahead);
+
+	plain = scanPages(first, leafOrder, numOfPages, 0, false);
+	ahead = scanPages(first, leafOrder, numOfPages, window, false);
+	printf("%-12s %-20.3f %.3f\n", "leaf chain", plain, ahead);
+
+	delete [] leafOrder;
+	MINIBASE_DB = savedDB;
+	delete db;
+	remove("READAHEAD.DB");
+}
+
+// Size of the database used by benchVectoredIO, and the part of it that
+// is transferred by each measurement.
+static const int numOfVectoredDBPages = 1000000;
+static const int numOfVectoredPages = 65536;
+
+static double transferMBps(DB *db, PageID first, int runLength, bool write, Page *pages, Page **run)
+{
+	Stopwatch^ sw = Stopwatch::StartNew();
+	for (int start = 0; start < numOfVectoredPages; start += runLength)
+	{
+		Status status;
+		if (runLength == 1)
+		{
+			status = write ? db->WritePage(first + start, &pages[0])
+				: db->ReadPage(first + start, &pages[0]);
+		}
+		else
+		{
+			for (int i = 0; i < runLength; i++)
+				run[i] = &pages[i];
+			status = write ? db->WritePages(first + start, runLength, run)
+				: db->ReadPages(first + start, runLength, run);
+		}
+
+		if (status != OK)
+		{
+			cerr << "benchVectoredIO: transfer at page " << first + start << " failed" << endl;
+			return 0;
+		}
+	}
+	sw->Stop();
+
+	double mb = (double)numOfVectoredPages * MINIBASE_PAGESIZE / (1024 * 1024);
+	return mb / sw->Elapsed.TotalSeconds;
+}
+
+void benchVectoredIO()
+{
+	const int maxRunLength = 64;
+
+	Status status;
+	DB *db = new DB("VECTORED.DB", numOfVectoredDBPages, status);
+	if (status != OK)
+	{
+		cerr << "benchVectoredIO: could not create the database" << endl;
+		return;
+	}
+
+	// Take the run from the middle of the file, away from the space map.
+	PageID first;
+	PageID skip;
+	db->AllocatePage(skip, numOfVectoredDBPages / 2);
+	if (db->AllocatePage(first, numOfVectoredPages) != OK)
+	{
+		cerr << "benchVectoredIO: could not allocate " << numOfVectoredPages << " pages" << endl;
+		delete db;
+		return;
+	}
+
+	Page *pages = new Page[maxRunLength];
+	Page **run = new Page*[maxRunLength];
+	memset(pages, 0, sizeof(Page) * maxRunLength);
+
+	cout << "Transfer of " << numOfVectoredPages << " pages of a " << numOfVectoredDBPages
+		<< " page database" << endl;
+	cout << "pages/call   write (MB/s)   read (MB/s)" << endl;
+	for (int runLength = 1; runLength <= maxRunLength; runLength *= 4)
+	{
+		double w = transferMBps(db, first, runLength, true, pages, run);
+		double r = transferMBps(db, first, runLength, false, pages, run);
+		printf("%-12d %-14.1f %.1f\n", runLength, w, r);
+	}
+
+	delete [] run;
+	delete [] pages;
+	delete db;
+	remove("VECTORED.DB");
+}
+
+// Size of the file used by benchAsyncIO: 1 GB of pages, so that most
+// reads miss the operating system's file cache on a box with a few GB
+// of memory. Reads are counted per queue depth and backend.
+static const int numOfIOPSPages = 262144;
+static const int numOfIOPSReads = 20000;
+static const int maxQueueDepth = 64;
+
+static double randomReadIOPS(DB *db, IOBackend backend, int queueDepth, Page *pages)
+{
+	Status status;
+	AsyncIO^ io = gcnew AsyncIO(db, backend, queueDepth, status);
+	if (status != OK)
+	{
+		delete io;
+		return 0;
+	}
+
+	// Slot i reads into pages[i] and is resubmitted as soon as it is done,
+	// which keeps queueDepth reads outstanding.
+	IOCompletion done[maxQueueDepth];
+	unsigned int seed = 4242;
+	int numSubmitted = 0;
+	int numDone = 0;
+
+	Stopwatch^ sw = Stopwatch::StartNew();
+	for (int i = 0; i < queueDepth; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		io->SubmitRead(1 + (seed >> 8) % (numOfIOPSPages - 1), &pages[i], i);
+		numSubmitted++;
+	}
+
+	while (numDone < numOfIOPSReads)
+	{
+		int n = io->WaitForCompletions(1, done, queueDepth);
+		for (int i = 0; i < n; i++)
+		{
+			if (done[i].status != OK)
+				cerr << "benchAsyncIO: read failed" << endl;
+			numDone++;
+
+			if (numSubmitted < numOfIOPSReads)
+			{
+				seed = seed * 1103515245 + 12345;
+				io->SubmitRead(1 + (seed >> 8) % (numOfIOPSPages - 1), &pages[done[i].tag], done[i].tag);
+				numSubmitted++;
+			}
+		}
+	}
+	sw->Stop();
+
+	delete io;
+	return numOfIOPSReads / sw->Elapsed.TotalSeconds;
+}
+
+void benchAsyncIO()
+{
+	Status status;
+	DB *db = new DB("IOPS.DB", numOfIOPSPages, status);
+	if (status != OK)
+	{
+		cerr << "benchAsyncIO: could not create the database" << endl;
+		return;
+	}
+
+	// Fill the file so that the reads hit real blocks rather than holes.
+	Page *pages = new Page[maxQueueDepth];
+	Page *run[maxQueueDepth];
+	memset(pages, 0, sizeof(Page) * maxQueueDepth);
+	for (int i = 0; i < maxQueueDepth; i++)
+		run[i] = &pages[i];
+	PageID first;
+	db->AllocatePage(first, numOfIOPSPages - 2 * maxQueueDepth);
+	for (int pid = first; pid + maxQueueDepth <= numOfIOPSPages; pid += maxQueueDepth)
+		db->WritePages(pid, maxQueueDepth, run);
+
+	Status uringStatus;
+	AsyncIO^ probe = gcnew AsyncIO(db, IO_URING, 1, uringStatus);
+	delete probe;
+
+	cout << "Random 4 KB reads over " << numOfIOPSPages << " pages" << endl;
+	cout << "queue depth  io_uring (IOPS)   thread pool (IOPS)" << endl;
+	for (int qd = 1; qd <= maxQueueDepth; qd *= 2)
+	{
+		double uring = (uringStatus == OK) ? randomReadIOPS(db, IO_URING, qd, pages) : 0;
+		double pool = randomReadIOPS(db, IO_THREAD_POOL, qd, pages);
+		if (uringStatus == OK)
+			printf("%-12d %-17.0f %.0f\n", qd, uring, pool);
+		else
+			printf("%-12d %-17s %.0f\n", qd, "n/a", pool);
+	}
+
+	delete [] pages;
+	delete db;
+	remove("IOPS.DB");
+}
+
+// Workload of benchDirectIO: a file four times larger than a 64 MB pool.
+static const int numOfDirectFrames = 16384;
+static const int numOfDirectPages = 65536;
+
+//--------------------------------------------------------------------
+// pageCacheMB
+//
+// Input    : None
+// Output   : None
+// Return   : The size of the operating system's file cache in MB, read
+//            from /proc/meminfo, or from the "Cache Bytes" performance
+//            counter on Windows. -1 if neither is available.
+//--------------------------------------------------------------------
+static double pageCacheMB()
+{
+#ifdef _WIN32
+	try
+	{
+		PerformanceCounter^ cache = gcnew PerformanceCounter("Memory", "Cache Bytes");
+		double bytes = cache->NextValue();
+		delete cache;
+		return bytes / (1024 * 1024);
+	}
+	catch (Exception^)
+	{
+		return -1;
+	}
+#else
+	ifstream meminfo("/proc/meminfo");
+	string key;
+	double kb;
+	string unit;
+	while (meminfo >> key >> kb >> unit)
+	{
+		if (key == "Cached:")
+			return kb / 1024;
+	}
+	return -1;
+#endif
+}
+
+static void runDirectWorkload(bool directIO)
+{
+	ThreadSafeBufMgr^ BM = gcnew ThreadSafeBufMgr(numOfDirectFrames, numOfDirectFrames / 64, directIO);
+	double cacheBefore = pageCacheMB();
+
+	// Insert: fill every page of the file, the way a heap file load does,
+	// and write them all out.
+	Stopwatch^ sw = Stopwatch::StartNew();
+	PageID first;
+	Page *page;
+	BM->NewPage(first, page, numOfDirectPages);
+	BM->UnpinPage(first, true);
+	for (int i = 0; i < numOfDirectPages; i++)
+	{
+		BM->PinPage(first + i, page, true);
+		memset(page, i & 0xff, sizeof(Page));
+		BM->UnpinPage(first + i, true);
+	}
+	BM->FlushAllPages();
+	double insertSecs = sw->Elapsed.TotalSeconds;
+
+	// Scan: read every page back twice.
+	sw->Restart();
+	long checksum = 0;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = 0; i < numOfDirectPages; i++)
+		{
+			BM->PinPage(first + i, page, false);
+			checksum += ((unsigned char *)page)[MINIBASE_PAGESIZE - 1];
+			BM->UnpinPage(first + i, false);
+		}
+	}
+	double scanSecs = sw->Elapsed.TotalSeconds;
+
+	double mb = (double)numOfDirectPages * MINIBASE_PAGESIZE / (1024 * 1024);
+	double rss = (double)Process::GetCurrentProcess()->WorkingSet64 / (1024 * 1024);
+	double cacheAfter = pageCacheMB();
+
+	printf("%-8s %-15.1f %-15.1f %-10.0f ", directIO ? "direct" : "cached",
+		mb / insertSecs, 2 * mb / scanSecs, rss);
+	if (cacheBefore < 0)
+		printf("n/a\n");
+	else
+		printf("%.0f\n", cacheAfter - cacheBefore);
+
+	delete BM;
+	MINIBASE_DB->DeallocatePage(first, numOfDirectPages);
+	if (checksum < 0)
+		cerr << "benchDirectIO: bad checksum" << endl;
+}
+
+void benchDirectIO()
+{
+	// The workload needs a bigger database than the one main creates, so
+	// MINIBASE_DB is swapped for a scratch one while it runs.
+	Status status;
+	DB *db = new DB("DIRECT.DB", numOfDirectPages + 1024, status);
+	if (status != OK)
+	{
+		cerr << "benchDirectIO: could not create the database" << endl;
+		return;
+	}
+	DB *savedDB = MINIBASE_DB;
+	MINIBASE_DB = db;
+
+	cout << "Insert and scan of " << numOfDirectPages << " pages through a pool of "
+		<< numOfDirectFrames << " frames" << endl;
+	cout << "mode     insert (MB/s)   scan (MB/s)     RSS (MB)   page cache growth (MB)" << endl;
+	runDirectWorkload(false);
+	runDirectWorkload(true);
+
+	MINIBASE_DB = savedDB;
+	delete db;
+	remove("DIRECT.DB");
+}
+
+void benchMappedScan()
+{
+	const int numOfPages = 16384;
+	const int window = 32;
+
+	// The file is bigger than the database main creates, so MINIBASE_DB
+	// is swapped for a scratch one while the benchmark runs.
+	Status status;
+	DB *db = new DB("MAPPED.DB", numOfPages + 1024, status);
+	if (status != OK)
+	{
+		cerr << "benchMappedScan: could not create the database" << endl;
+		return;
+	}
+	DB *savedDB = MINIBASE_DB;
+	MINIBASE_DB = db;
+
+	ThreadSafeBufMgr^ loader = gcnew ThreadSafeBufMgr(MINIBASE_BUFFER_POOL_SIZE, 1);
+	PageID first;
+	Page *page;
+	loader->NewPage(first, page, numOfPages);
+	loader->UnpinPage(first, true);
+	for (int i = 0; i < numOfPages; i++)
+	{
+		loader->PinPage(first + i, page, true);
+		memset(page, i & 0x7f, sizeof(Page));
+		loader->UnpinPage(first + i, true);
+	}
+	delete loader;
+
+	// A B+ tree range scan reads a quarter of the leaves, in key order.
+	const int numOfLeaves = numOfPages / 4;
+	PageID *leafOrder = new PageID[numOfLeaves];
+	unsigned int seed = 777;
+	for (int i = 0; i < numOfLeaves; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		leafOrder[i] = first + (seed >> 8) % numOfPages;
+	}
+
+	// A replica's file is usually in the operating system's cache, so the
+	// scans run warm: the difference is the copy into a frame and the
+	// bookkeeping of the pool.
+	scanPages(first, NULL, numOfPages, 0, false);
+
+	cout << "Warm scans of a " << numOfPages << " page read-only file, "
+		<< MINIBASE_BUFFER_POOL_SIZE << " frames" << endl;
+	cout << "scan                      buffered (s)   mapped (s)" << endl;
+
+	double buffered = scanPages(first, NULL, numOfPages, 0, false);
+	double mapped = scanPages(first, NULL, numOfPages, 0, true);
+	printf("%-25s %-14.3f %.3f\n", "full heap scan", buffered, mapped);
+
+	buffered = scanPages(first, NULL, numOfPages, window, false);
+	mapped = scanPages(first, NULL, numOfPages, window, true);
+	printf("%-25s %-14.3f %.3f\n", "full scan, read-ahead", buffered, mapped);
+
+	buffered = scanPages(first, leafOrder, numOfLeaves, 0, false);
+	mapped = scanPages(first, leafOrder, numOfLeaves, 0, true);
+	printf("%-25s %-14.3f %.3f\n", "B+ tree range scan", buffered, mapped);
+
+	delete [] leafOrder;
+	MINIBASE_DB = savedDB;
+	delete db;
+	remove("MAPPED.DB");
+}
+
+// Allocation churn of benchSpaceMap. DB::AllocatePage is far slower on a
+// full database, so it gets fewer operations.
+static const int numOfSpaceMapOps = 100000;
+static const int numOfDBAllocOps = 500;
+
+// A run allocated by benchSpaceMap.
+struct AllocatedRun
+{
+	PageID start;
+	int size;
+};
+
+//--------------------------------------------------------------------
+// churnAllocations
+//
+// Input    : sm        - allocate through sm, or through MINIBASE_DB if
+//                        NULL
+//            runs      - the live runs, numOfRuns of them
+//            numOfOps  - number of allocations
+// Output   : runs is updated
+// Purpose  : Allocate a run of 1 to 8 pages and free a random live run,
+//            numOfOps times, which keeps the fill level steady while
+//            fragmenting the free space.
+// Return   : Microseconds per allocation and free.
+//--------------------------------------------------------------------
+static double churnAllocations(SpaceMap *sm, AllocatedRun *runs, int numOfRuns, int numOfOps)
+{
+	unsigned int seed = 99;
+	Stopwatch^ sw = Stopwatch::StartNew();
+	for (int i = 0; i < numOfOps; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		int size = 1 + (seed >> 16) % 8;
+		int victim = (seed >> 8) % numOfRuns;
+
+		PageID start;
+		Status status = (sm != NULL) ? sm->AllocatePage(start, size) : MINIBASE_DB->AllocatePage(start, size);
+		if (status != OK)
+		{
+			cerr << "benchSpaceMap: allocation failed" << endl;
+			break;
+		}
+
+		if (sm != NULL)
+			sm->DeallocatePage(runs[victim].start, runs[victim].size);
+		else
+			MINIBASE_DB->DeallocatePage(runs[victim].start, runs[victim].size);
+		runs[victim].start = start;
+		runs[victim].size = size;
+	}
+	sw->Stop();
+	return sw->Elapsed.TotalMilliseconds * 1000 / numOfOps;
+}
+
+void benchSpaceMap()
+{
+	const int fills[] = { 10, 50, 95 };
+
+	cout << "Page allocation in a " << MINIBASE_DB_SIZE << " page database" << endl;
+	cout << "fill (%)   DB::AllocatePage (us/op)   SpaceMap (us/op)" << endl;
+
+	for (int f = 0; f < 3; f++)
+	{
+		// Allocation goes through MINIBASE_BM and MINIBASE_DB, so both
+		// are swapped for scratch ones.
+		Status status;
+		DB *db = new DB("SPACEMAP.DB", MINIBASE_DB_SIZE, status);
+		if (status != OK)
+		{
+			cerr << "benchSpaceMap: could not create the database" << endl;
+			return;
+		}
+		MINIBASE_BM->FlushAllPages();
+		DB *savedDB = MINIBASE_DB;
+		BufMgr *savedBM = MINIBASE_BM;
+		MINIBASE_DB = db;
+		MINIBASE_BM = new BufMgr(NUMBUF);
+
+		SpaceMap *sm = new SpaceMap(db, status);
+
+		// Fill with runs of 1 to 16 pages, then free an eighth of them at
+		// random and fill up again, so that the free space is in holes.
+		int target = (int)((long long)MINIBASE_DB_SIZE * fills[f] / 100);
+		int maxRuns = target;
+		AllocatedRun *runs = new AllocatedRun[maxRuns];
+		int numOfRuns = 0;
+		int used = MINIBASE_DB_SIZE - sm->GetNumOfFreePages();
+		unsigned int seed = 7;
+		for (int round = 0; round < 2; round++)
+		{
+			while (used < target)
+			{
+				seed = seed * 1103515245 + 12345;
+				int size = 1 + (seed >> 16) % 16;
+				if (sm->AllocatePage(runs[numOfRuns].start, size) != OK)
+					break;
+				runs[numOfRuns++].size = size;
+				used += size;
+			}
+
+			if (round == 0)
+			{
+				for (int i = 0; i < numOfRuns; i++)
+				{
+					seed = seed * 1103515245 + 12345;
+					if ((seed >> 16) % 8 != 0)
+						continue;
+					sm->DeallocatePage(runs[i].start, runs[i].size);
+					used -= runs[i].size;
+					runs[i] = runs[--numOfRuns];
+				}
+			}
+		}
+
+		double dbTime = churnAllocations(NULL, runs, numOfRuns, numOfDBAllocOps);
+		sm->Reload();
+		double smTime = churnAllocations(sm, runs, numOfRuns, numOfSpaceMapOps);
+		printf("%-10d %-26.2f %.3f\n", fills[f], dbTime, smTime);
+
+		delete [] runs;
+		delete sm;
+		delete MINIBASE_BM;
+		MINIBASE_BM = savedBM;
+		MINIBASE_DB = savedDB;
+		delete db;
+		remove("SPACEMAP.DB");
+	}
+}
@@ -0,0 +1,357 @@
+/*
+ * Vectored reads and writes of page runs, and direct I/O that bypasses
+ * the operating system's page cache, for the DB class.
+ */
+
+#ifdef _WIN32
+#include <io.h>
+#include <stdio.h>
+#include <string.h>
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "db.h"
+
+// Most pages moved by one system call.
+#if defined(IOV_MAX) && IOV_MAX < 256
+static const int maxPagesPerCall = IOV_MAX;
+#else
+static const int maxPagesPerCall = 256;
+#endif
+
+#ifdef _WIN32
+
+//--------------------------------------------------------------------
+// TransferRun
+//
+// Input    : fd       - the database file
+//            write    - true to write the pages, false to read them
+//            pageno   - first page of the run
+//            count    - number of pages in the run
+//            pageptrs - one buffer per page
+// Output   : None
+// Purpose  : Move a run of pages between the file and the buffers. The C
+//            runtime has no vectored I/O, and ReadFileScatter needs an
+//            unbuffered handle, so the pages are copied through a
+//            contiguous bounce buffer: one _read/_write per
+//            maxPagesPerCall pages instead of one per page. The copies
+//            cost far less than the system calls they save.
+// Return   : true on success, false on an I/O error or end of file.
+//--------------------------------------------------------------------
+static bool TransferRun(int fd, bool write, PageID pageno, int count, Page **pageptrs)
+{
+	int n = (count < maxPagesPerCall) ? count : maxPagesPerCall;
+	char *buffer = new char[(size_t)n * MINIBASE_PAGESIZE];
+	bool ok = (_lseeki64(fd, (__int64)pageno * MINIBASE_PAGESIZE, SEEK_SET) >= 0);
+
+	for (int done = 0; ok && done < count; done += n)
+	{
+		if (n > count - done)
+			n = count - done;
+		unsigned bytes = (unsigned)n * MINIBASE_PAGESIZE;
+
+		if (write)
+		{
+			for (int i = 0; i < n; i++)
+				memcpy(buffer + (size_t)i * MINIBASE_PAGESIZE, pageptrs[done + i], MINIBASE_PAGESIZE);
+			ok = (_write(fd, buffer, bytes) == (int)bytes);
+		}
+		else
+		{
+			ok = (_read(fd, buffer, bytes) == (int)bytes);
+			for (int i = 0; ok && i < n; i++)
+				memcpy(pageptrs[done + i], buffer + (size_t)i * MINIBASE_PAGESIZE, MINIBASE_PAGESIZE);
+		}
+	}
+
+	delete [] buffer;
+	return ok;
+}
+
+//--------------------------------------------------------------------
+// TransferRunDirect
+//
+// Input    : handle   - the database file, opened by OpenDirect
+//            write    - true to write the pages, false to read them
+//            pageno   - first page of the run
+//            count    - number of pages in the run
+//            pageptrs - one buffer per page, each MINIBASE_PAGESIZE
+//                       aligned
+// Output   : None
+// Purpose  : Move a run of pages between the unbuffered file and the
+//            buffers, one ReadFileScatter/WriteFileGather per
+//            maxPagesPerCall pages. The handle is overlapped, so each
+//            call carries its own offset and event and concurrent calls
+//            do not disturb each other.
+// Return   : true on success, false on an I/O error or end of file.
+//--------------------------------------------------------------------
+static bool TransferRunDirect(HANDLE handle, bool write, PageID pageno, int count, Page **pageptrs)
+{
+	FILE_SEGMENT_ELEMENT segments[maxPagesPerCall + 1];
+	OVERLAPPED overlapped;
+	HANDLE event = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (event == NULL)
+		return false;
+
+	bool ok = true;
+	for (int done = 0; ok && done < count; )
+	{
+		int n = count - done;
+		if (n > maxPagesPerCall)
+			n = maxPagesPerCall;
+
+		for (int i = 0; i < n; i++)
+			segments[i].Buffer = PtrToPtr64(pageptrs[done + i]);
+		segments[n].Buffer = NULL;
+
+		ULONGLONG offset = (ULONGLONG)(pageno + done) * MINIBASE_PAGESIZE;
+		memset(&overlapped, 0, sizeof(overlapped));
+		overlapped.Offset = (DWORD)offset;
+		overlapped.OffsetHigh = (DWORD)(offset >> 32);
+		overlapped.hEvent = event;
+
+		DWORD bytes = (DWORD)n * MINIBASE_PAGESIZE;
+		BOOL started = write ? WriteFileGather(handle, segments, bytes, NULL, &overlapped)
+			: ReadFileScatter(handle, segments, bytes, NULL, &overlapped);
+		DWORD moved = 0;
+		ok = (started || GetLastError() == ERROR_IO_PENDING)
+			&& GetOverlappedResult(handle, &overlapped, &moved, TRUE)
+			&& moved == bytes;
+		done += n;
+	}
+
+	CloseHandle(event);
+	return ok;
+}
+
+#else
+
+//--------------------------------------------------------------------
+// TransferRun
+//
+// Input    : fd       - the database file
+//            write    - true to write the pages, false to read them
+//            pageno   - first page of the run
+//            count    - number of pages in the run
+//            pageptrs - one buffer per page
+// Output   : None
+// Purpose  : Move a run of pages between the file and the buffers, one
+//            preadv/pwritev per maxPagesPerCall pages. Partial transfers
+//            are resumed where they stopped.
+// Return   : true on success, false on an I/O error or end of file.
+//--------------------------------------------------------------------
+static bool TransferRun(int fd, bool write, PageID pageno, int count, Page **pageptrs)
+{
+	struct iovec iov[maxPagesPerCall];
+	off_t offset = (off_t)pageno * MINIBASE_PAGESIZE;
+	int done = 0;
+	size_t skip = 0;	// Bytes of page 'done' already transferred.
+
+	while (done < count)
+	{
+		int n = count - done;
+		if (n > maxPagesPerCall)
+			n = maxPagesPerCall;
+
+		for (int i = 0; i < n; i++)
+		{
+			iov[i].iov_base = (char *)pageptrs[done + i];
+			iov[i].iov_len = MINIBASE_PAGESIZE;
+		}
+		iov[0].iov_base = (char *)iov[0].iov_base + skip;
+		iov[0].iov_len -= skip;
+
+		ssize_t bytes = write ? pwritev(fd, iov, n, offset) : preadv(fd, iov, n, offset);
+		if (bytes < 0 && errno == EINTR)
+			continue;
+		if (bytes <= 0)
+			return false;
+
+		offset += bytes;
+		bytes += skip;
+		done += (int)(bytes / MINIBASE_PAGESIZE);
+		skip = (size_t)(bytes % MINIBASE_PAGESIZE);
+	}
+	return true;
+}
+
+#endif
+
+//--------------------------------------------------------------------
+// DB::ReadPages
+//
+// Input    : pageno   - first page of the run
+//            count    - number of pages in the run
+// Output   : pageptrs - the contents of the pages
+// Purpose  : Read a run of contiguous pages with vectored reads, or on
+//            Windows with large reads into a bounce buffer.
+// Return   : OK, or DBMGR with the error posted.
+//--------------------------------------------------------------------
+Status DB::ReadPages(PageID pageno, int count, Page **pageptrs)
+{
+	if (count < 0)
+		return MINIBASE_FIRST_ERROR(DBMGR, NEG_RUN_SIZE);
+	if (pageno < 0 || (unsigned)pageno + count > num_pages)
+		return MINIBASE_FIRST_ERROR(DBMGR, BAD_PAGE_NO);
+
+	if (!TransferRun(fd, false, pageno, count, pageptrs))
+		return MINIBASE_FIRST_ERROR(DBMGR, FILE_IO_ERROR);
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// DB::WritePages
+//
+// Input    : pageno   - first page of the run
+//            count    - number of pages in the run
+//            pageptrs - the contents to write
+// Output   : None
+// Purpose  : Write a run of contiguous pages with vectored writes, or on
+//            Windows with large writes from a bounce buffer.
+// Return   : OK, or DBMGR with the error posted.
+//--------------------------------------------------------------------
+Status DB::WritePages(PageID pageno, int count, Page **pageptrs)
+{
+	if (count < 0)
+		return MINIBASE_FIRST_ERROR(DBMGR, NEG_RUN_SIZE);
+	if (pageno < 0 || (unsigned)pageno + count > num_pages)
+		return MINIBASE_FIRST_ERROR(DBMGR, BAD_PAGE_NO);
+
+	if (!TransferRun(fd, true, pageno, count, pageptrs))
+		return MINIBASE_FIRST_ERROR(DBMGR, FILE_IO_ERROR);
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// DB::OpenDirect
+//
+// Input    : None
+// Output   : directFd - a new descriptor on the database file
+// Purpose  : Open the database file again with O_DIRECT, so that pages
+//            moved through the new descriptor skip the page cache.
+//            DB's own descriptor is left alone, since the space map and
+//            the directory are read into buffers that are not aligned.
+//            On Windows the file is opened with FILE_FLAG_NO_BUFFERING
+//            and FILE_FLAG_WRITE_THROUGH, overlapped for the scatter and
+//            gather calls, and the handle is wrapped in a C runtime
+//            descriptor. Pages must then be whole memory pages, since
+//            ReadFileScatter moves one memory page per segment.
+// Return   : OK, or DBMGR with UNIX_ERROR posted if the platform or the
+//            file system does not support direct I/O.
+//--------------------------------------------------------------------
+Status DB::OpenDirect(int &directFd)
+{
+	directFd = -1;
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	if (info.dwPageSize != MINIBASE_PAGESIZE)
+		return MINIBASE_FIRST_ERROR(DBMGR, UNIX_ERROR);
+
+	HANDLE handle = CreateFileA(name, GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+		FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH | FILE_FLAG_OVERLAPPED, NULL);
+	if (handle != INVALID_HANDLE_VALUE)
+	{
+		directFd = _open_osfhandle((intptr_t)handle, 0);
+		if (directFd < 0)
+			CloseHandle(handle);
+	}
+#elif defined(O_DIRECT)
+	directFd = open(name, O_RDWR | O_DIRECT);
+#else
+	// No O_DIRECT on macOS; F_NOCACHE has the same effect.
+	directFd = open(name, O_RDWR);
+	if (directFd >= 0 && fcntl(directFd, F_NOCACHE, 1) < 0)
+	{
+		close(directFd);
+		directFd = -1;
+	}
+#endif
+	if (directFd < 0)
+		return MINIBASE_FIRST_ERROR(DBMGR, UNIX_ERROR);
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// DB::CloseDirect
+//
+// Input    : directFd - a descriptor from OpenDirect
+// Output   : None
+// Return   : OK, or DBMGR with UNIX_ERROR posted.
+//--------------------------------------------------------------------
+Status DB::CloseDirect(int directFd)
+{
+#ifdef _WIN32
+	// Closes the handle as well.
+	if (_close(directFd) == 0)
+		return OK;
+#else
+	if (close(directFd) == 0)
+		return OK;
+#endif
+	return MINIBASE_FIRST_ERROR(DBMGR, UNIX_ERROR);
+}
+
+//--------------------------------------------------------------------
+// DB::ReadPagesDirect
+//
+// Input    : directFd - a descriptor from OpenDirect
+//            pageno   - first page of the run
+//            count    - number of pages in the run
+// Output   : pageptrs - the contents of the pages, each of which must
+//                       be MINIBASE_PAGESIZE aligned
+// Purpose  : Same as ReadPages, bypassing the page cache.
+// Return   : OK, or DBMGR with the error posted.
+//--------------------------------------------------------------------
+Status DB::ReadPagesDirect(int directFd, PageID pageno, int count, Page **pageptrs)
+{
+	if (count < 0)
+		return MINIBASE_FIRST_ERROR(DBMGR, NEG_RUN_SIZE);
+	if (pageno < 0 || (unsigned)pageno + count > num_pages)
+		return MINIBASE_FIRST_ERROR(DBMGR, BAD_PAGE_NO);
+
+#ifdef _WIN32
+	if (TransferRunDirect((HANDLE)_get_osfhandle(directFd), false, pageno, count, pageptrs))
+		return OK;
+#else
+	if (TransferRun(directFd, false, pageno, count, pageptrs))
+		return OK;
+#endif
+	return MINIBASE_FIRST_ERROR(DBMGR, FILE_IO_ERROR);
+}
+
+//--------------------------------------------------------------------
+// DB::WritePagesDirect
+//
+// Input    : directFd - a descriptor from OpenDirect
+//            pageno   - first page of the run
+//            count    - number of pages in the run
+//            pageptrs - the contents to write, each MINIBASE_PAGESIZE
+//                       aligned
+// Output   : None
+// Purpose  : Same as WritePages, bypassing the page cache.
+// Return   : OK, or DBMGR with the error posted.
+//--------------------------------------------------------------------
+Status DB::WritePagesDirect(int directFd, PageID pageno, int count, Page **pageptrs)
+{
+	if (count < 0)
+		return MINIBASE_FIRST_ERROR(DBMGR, NEG_RUN_SIZE);
+	if (pageno < 0 || (unsigned)pageno + count > num_pages)
+		return MINIBASE_FIRST_ERROR(DBMGR, BAD_PAGE_NO);
+
+#ifdef _WIN32
+	if (TransferRunDirect((HANDLE)_get_osfhandle(directFd), true, pageno, count, pageptrs))
+		return OK;
+#else
+	if (TransferRun(directFd, true, pageno, count, pageptrs))
+		return OK;
+#endif
+	return MINIBASE_FIRST_ERROR(DBMGR, FILE_IO_ERROR);
+}
@@ -14,6 +14,7 @@
 #include "threadsafe_HashIndex.h"
 #include "deadlock_detector.h"
 #include "test.h"
+#include "bufmgr_bench.h"
 
 using namespace System;
 
@@ -35,6 +36,14 @@ int main()
 	//test2(HI);
 	//test3(HI);
 	test4(HI);
+	//benchPinUnpin();
+	//benchFlusher();
+	//benchReadAhead();
+	//benchVectoredIO();
+	//benchAsyncIO();
+	//benchDirectIO();
+	//benchMappedScan();
+	//benchSpaceMap();
 
 	Console::ReadLine();
 	return 0;
@@ -0,0 +1,107 @@
+#include "read_ahead.h"
+
+ReadAheadScan::ReadAheadScan(ThreadSafeBufMgr^ BM, const PageID *pids, int count, int window)
+{
+	this->BM = BM;
+	this->pids = pids;
+	this->first = INVALID_PAGE;
+	this->count = count;
+	this->window = (window > 0) ? window : 1;
+	next = 0;
+	prefetched = 0;
+	current = INVALID_PAGE;
+}
+
+ReadAheadScan::ReadAheadScan(ThreadSafeBufMgr^ BM, PageID first, int count, int window)
+{
+	this->BM = BM;
+	this->pids = NULL;
+	this->first = first;
+	this->count = count;
+	this->window = (window > 0) ? window : 1;
+	next = 0;
+	prefetched = 0;
+	current = INVALID_PAGE;
+}
+
+ReadAheadScan::~ReadAheadScan()
+{
+	if (current != INVALID_PAGE)
+	{
+		BM->UnpinPage(current, false);
+		current = INVALID_PAGE;
+	}
+}
+
+//--------------------------------------------------------------------
+// ReadAheadScan::PageAt
+//
+// Input    : i - index of a page of the scan
+// Output   : None
+// Return   : The page id of the i-th page of the scan.
+//--------------------------------------------------------------------
+PageID ReadAheadScan::PageAt(int i)
+{
+	return (pids != NULL) ? pids[i] : first + i;
+}
+
+//--------------------------------------------------------------------
+// ReadAheadScan::ReadAhead
+//
+// Input    : None
+// Output   : None
+// Purpose  : Once fewer than half a window of pages is being prefetched
+//            ahead of the scan, ask for the next window. Requests go out
+//            in window-sized batches so a contiguous run is read as a
+//            run.
+//--------------------------------------------------------------------
+void ReadAheadScan::ReadAhead()
+{
+	if (prefetched >= count || prefetched - next > window / 2)
+		return;
+
+	int from = (prefetched > next) ? prefetched : next;
+	int to = next + window;
+	if (to > count)
+		to = count;
+	if (from >= to)
+		return;
+
+	if (pids != NULL)
+		BM->Prefetch(pids + from, to - from);
+	else
+		BM->Prefetch(first + from, to - from);
+	prefetched = to;
+}
+
+//--------------------------------------------------------------------
+// ReadAheadScan::GetNext
+//
+// Input    : None
+// Output   : pid  - the next page of the scan
+//            page - the page, pinned
+// Purpose  : Unpin the previous page, keep the prefetch window filled
+//            and pin the next page.
+// Return   : OK if a page was pinned, DONE at the end of the scan,
+//            FAIL if the page could not be pinned.
+//--------------------------------------------------------------------
+Status ReadAheadScan::GetNext(PageID &pid, Page *&page)
+{
+	if (current != INVALID_PAGE)
+	{
+		BM->UnpinPage(current, false);
+		current = INVALID_PAGE;
+	}
+
+	if (next >= count)
+		return DONE;
+
+	pid = PageAt(next++);
+	ReadAhead();
+
+	if (BM->PinPage(pid, page, false) != OK)
+		return FAIL;
+
+	current = pid;
+	return OK;
+}
@@ -0,0 +1,314 @@
+#include <string.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "spacemap.h"
+#include "bufmgr.h"
+
+// Bits of the space map held by one page.
+static const int bitsPerPage = MINIBASE_PAGESIZE * 8;
+
+// Words of the space map held by one page.
+static const int wordsPerPage = MINIBASE_PAGESIZE / 8;
+
+static const unsigned long long allBits = ~0ULL;
+
+//--------------------------------------------------------------------
+// CountTrailingZeros
+//
+// Input    : w - a non-zero word
+// Output   : None
+// Return   : The index of the lowest set bit of w.
+//--------------------------------------------------------------------
+static inline int CountTrailingZeros(unsigned long long w)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, w);
+	return (int)index;
+#else
+	return __builtin_ctzll(w);
+#endif
+}
+
+static inline int PopCount(unsigned long long w)
+{
+#ifdef _MSC_VER
+	return (int)__popcnt64(w);
+#else
+	return __builtin_popcountll(w);
+#endif
+}
+
+//--------------------------------------------------------------------
+// SpaceMap::SpaceMap
+//
+// Input   : db - an open database
+// Output  : status - OK, or FAIL if the space map could not be read
+// Purpose : Load the database's space map into memory.
+//--------------------------------------------------------------------
+SpaceMap::SpaceMap(DB *db, Status &status)
+{
+	this->db = db;
+	numOfPages = db->GetNumOfPages();
+	numOfMapPages = (numOfPages + bitsPerPage - 1) / bitsPerPage;
+	numOfWords = (numOfPages + 63) / 64;
+	words = new unsigned long long[numOfMapPages * wordsPerPage];
+	status = Reload();
+}
+
+SpaceMap::~SpaceMap()
+{
+	delete [] words;
+}
+
+//--------------------------------------------------------------------
+// SpaceMap::Reload
+//
+// Input    : None
+// Output   : None
+// Purpose  : Read the space map pages again, after pages were allocated
+//            or freed through DB directly. Resets the cursor and hints.
+// Return   : OK, or FAIL if a space map page could not be pinned.
+//--------------------------------------------------------------------
+Status SpaceMap::Reload()
+{
+	for (int p = 0; p < numOfMapPages; p++)
+	{
+		Page *page;
+		if (MINIBASE_BM->PinPage(1 + p, page) != OK)
+		{
+			cerr << "SpaceMap: could not pin space map page " << 1 + p << endl;
+			return FAIL;
+		}
+		memcpy(&words[p * wordsPerPage], page, MINIBASE_PAGESIZE);
+		MINIBASE_BM->UnpinPage(1 + p);
+	}
+
+	// Pages past the end of the database are never free.
+	if (numOfPages % 64 != 0)
+		words[numOfWords - 1] |= allBits << (numOfPages % 64);
+
+	numOfFree = 0;
+	for (int i = 0; i < numOfWords; i++)
+		numOfFree += 64 - PopCount(words[i]);
+
+	cursor = 0;
+	for (int k = 0; k <= MAX_HINTED_RUN; k++)
+		hints[k] = -1;
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// SpaceMap::FindRun
+//
+// Input    : runSize  - number of free pages needed
+//            fromWord - first word to look at
+//            toWord   - one past the last word a run may start in
+// Output   : None
+// Purpose  : Find the first run of runSize free pages that starts in
+//            [fromWord, toWord). Full words are skipped whole, empty
+//            words add 64 pages at once, and in mixed words each free
+//            or allocated stretch is measured with one
+//            CountTrailingZeros.
+// Return   : The first page of the run, or -1 if there is none.
+//--------------------------------------------------------------------
+int SpaceMap::FindRun(int runSize, int fromWord, int toWord)
+{
+	int runStart = 0;
+	int runLength = 0;
+
+	for (int i = fromWord; i < numOfWords; i++)
+	{
+		unsigned long long w = words[i];
+
+		if (w == allBits)
+		{
+			if (i + 1 >= toWord)
+				return -1;
+			runLength = 0;
+			continue;
+		}
+
+		if (w == 0)
+		{
+			if (runLength == 0)
+			{
+				if (i >= toWord)
+					return -1;
+				runStart = i * 64;
+			}
+			runLength += 64;
+			if (runLength >= runSize)
+				return runStart;
+			continue;
+		}
+
+		int bit = 0;
+		while (bit < 64)
+		{
+			// Zeros shifted in at the top read as free, which is what
+			// CountTrailingZeros of the allocated bits needs.
+			unsigned long long rest = w >> bit;
+			if ((rest & 1) == 0)
+			{
+				int length = (rest == 0) ? 64 - bit : CountTrailingZeros(rest);
+				if (runLength == 0)
+				{
+					if (i >= toWord)
+						return -1;
+					runStart = i * 64 + bit;
+				}
+				runLength += length;
+				if (runLength >= runSize)
+					return runStart;
+				bit += length;
+			}
+			else
+			{
+				unsigned long long free = ~rest;
+				int length = (free == 0) ? 64 - bit : CountTrailingZeros(free);
+				runLength = 0;
+				bit += length;
+			}
+		}
+
+		if (runLength == 0 && i + 1 >= toWord)
+			return -1;
+	}
+	return -1;
+}
+
+//--------------------------------------------------------------------
+// SpaceMap::SetBits
+//
+// Input    : start     - first page of the run
+//            runSize   - number of pages in the run
+//            allocated - the new state of the pages
+// Output   : None
+// Purpose  : Mark the run in memory, a word at a time.
+//--------------------------------------------------------------------
+void SpaceMap::SetBits(PageID start, int runSize, bool allocated)
+{
+	int page = start;
+	int end = start + runSize;
+	while (page < end)
+	{
+		int i = page / 64;
+		int bit = page % 64;
+		int n = (end - page < 64 - bit) ? end - page : 64 - bit;
+		unsigned long long mask = (n == 64) ? allBits : ((1ULL << n) - 1) << bit;
+
+		if (allocated)
+			words[i] |= mask;
+		else
+			words[i] &= ~mask;
+		page += n;
+	}
+}
+
+//--------------------------------------------------------------------
+// SpaceMap::WriteBack
+//
+// Input    : start   - first page of a run that changed
+//            runSize - number of pages in the run
+// Output   : None
+// Purpose  : Copy the bytes of the space map that cover the run to the
+//            space map pages.
+// Return   : OK, or FAIL if a space map page could not be pinned.
+//--------------------------------------------------------------------
+Status SpaceMap::WriteBack(PageID start, int runSize)
+{
+	const char *bytes = (const char *)words;
+	int firstByte = start / 8;
+	int endByte = (start + runSize - 1) / 8 + 1;
+
+	while (firstByte < endByte)
+	{
+		int p = firstByte / MINIBASE_PAGESIZE;
+		int pageEnd = (p + 1) * MINIBASE_PAGESIZE;
+		int n = (endByte < pageEnd ? endByte : pageEnd) - firstByte;
+
+		Page *page;
+		if (MINIBASE_BM->PinPage(1 + p, page) != OK)
+		{
+			cerr << "SpaceMap: could not pin space map page " << 1 + p << endl;
+			return FAIL;
+		}
+		memcpy((char *)page + firstByte % MINIBASE_PAGESIZE, bytes + firstByte, n);
+		MINIBASE_BM->UnpinPage(1 + p, true);
+		firstByte += n;
+	}
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// SpaceMap::AllocatePage
+//
+// Input    : runSize - number of contiguous pages needed
+// Output   : start   - the first page of the run
+// Purpose  : Allocate a run of pages. A hint for this size or a larger
+//            one is tried first; otherwise the search goes on from the
+//            cursor to the end of the database and wraps around.
+// Return   : OK, or DBMGR with NEG_RUN_SIZE or DB_FULL posted.
+//--------------------------------------------------------------------
+Status SpaceMap::AllocatePage(PageID &start, int runSize)
+{
+	if (runSize < 1)
+		return MINIBASE_FIRST_ERROR(DBMGR, NEG_RUN_SIZE);
+	if (runSize > numOfFree)
+		return MINIBASE_FIRST_ERROR(DBMGR, DB_FULL);
+
+	int found = -1;
+	for (int k = (runSize < MAX_HINTED_RUN ? runSize : MAX_HINTED_RUN); k <= MAX_HINTED_RUN && found < 0; k++)
+	{
+		if (hints[k] < 0)
+			continue;
+		found = FindRun(runSize, hints[k], hints[k] + 1);
+		hints[k] = -1;
+	}
+
+	if (found < 0)
+		found = FindRun(runSize, cursor, numOfWords);
+	if (found < 0)
+		found = FindRun(runSize, 0, cursor + 1);
+	if (found < 0)
+		return MINIBASE_FIRST_ERROR(DBMGR, DB_FULL);
+
+	SetBits(found, runSize, true);
+	numOfFree -= runSize;
+	cursor = (found + runSize) / 64;
+	if (cursor >= numOfWords)
+		cursor = 0;
+
+	start = found;
+	return WriteBack(found, runSize);
+}
+
+//--------------------------------------------------------------------
+// SpaceMap::DeallocatePage
+//
+// Input    : start   - the first page of the run
+//            runSize - number of pages in the run
+// Output   : None
+// Purpose  : Free a run of pages and leave a hint for its size.
+// Return   : OK, or DBMGR with NEG_RUN_SIZE or BAD_PAGE_NO posted.
+//--------------------------------------------------------------------
+Status SpaceMap::DeallocatePage(PageID start, int runSize)
+{
+	if (runSize < 1)
+		return MINIBASE_FIRST_ERROR(DBMGR, NEG_RUN_SIZE);
+	if (start <= numOfMapPages || start + runSize > numOfPages)
+		return MINIBASE_FIRST_ERROR(DBMGR, BAD_PAGE_NO);
+
+	SetBits(start, runSize, false);
+	numOfFree += runSize;
+	hints[runSize < MAX_HINTED_RUN ? runSize : MAX_HINTED_RUN] = start / 64;
+	return WriteBack(start, runSize);
+}
+
+int SpaceMap::GetNumOfFreePages()
+{
+	return numOfFree;
+}
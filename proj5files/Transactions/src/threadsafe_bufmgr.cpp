@@ -0,0 +1,1457 @@
+#include <algorithm>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "threadsafe_bufmgr.h"
+
+// Most page ids waiting for the prefetcher.
+static const int maxPrefetchQueue = 1024;
+
+// Most pages moved by one DB::ReadPages or DB::WritePages call.
+static const int maxPagesPerRun = 64;
+
+// Most pages the flusher writes from one shard per round.
+static const int flushBatchSize = 16;
+
+// How long the flusher sleeps when it found nothing to write.
+static const int flushIdleMs = 10;
+
+//--------------------------------------------------------------------
+// AllocatePageSlab
+//
+// Input    : numOfPages - number of frames in the pool
+// Output   : None
+// Purpose  : Allocate the memory of every frame as one block aligned to
+//            MINIBASE_PAGESIZE, as direct I/O requires.
+// Return   : The block, or NULL if it could not be allocated.
+//--------------------------------------------------------------------
+static Page *AllocatePageSlab(int numOfPages)
+{
+	size_t size = (size_t)numOfPages * MINIBASE_PAGESIZE;
+#ifdef _WIN32
+	return (Page *)_aligned_malloc(size, MINIBASE_PAGESIZE);
+#else
+	void *slab;
+	if (posix_memalign(&slab, MINIBASE_PAGESIZE, size) != 0)
+		return NULL;
+	return (Page *)slab;
+#endif
+}
+
+static void FreePageSlab(Page *slab)
+{
+#ifdef _WIN32
+	_aligned_free(slab);
+#else
+	free(slab);
+#endif
+}
+
+// Orders frames collected for a batch by page id.
+static bool FrameRefLess(const FrameRef &a, const FrameRef &b)
+{
+	return a.pid < b.pid;
+}
+
+//--------------------------------------------------------------------
+// Constructor for ThreadSafeBufMgr
+//
+// Input   : bufSize     - number of pages in this buffer manager
+//           numOfShards - number of partitions of the pool
+// Output  : None
+// PostCond: All frames are empty and are replacement candidates.
+//--------------------------------------------------------------------
+ThreadSafeBufMgr::ThreadSafeBufMgr(int bufSize, int numOfShards)
+{
+	Init(bufSize, numOfShards, false);
+}
+
+//--------------------------------------------------------------------
+// Constructor for ThreadSafeBufMgr
+//
+// Input   : bufSize     - number of pages in this buffer manager
+//           numOfShards - number of partitions of the pool
+//           directIO    - read and write pages with O_DIRECT
+// Output  : None
+// PostCond: All frames are empty and are replacement candidates.
+//--------------------------------------------------------------------
+ThreadSafeBufMgr::ThreadSafeBufMgr(int bufSize, int numOfShards, bool directIO)
+{
+	Init(bufSize, numOfShards, directIO);
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::Init
+//
+// Input   : bufSize     - number of pages in this buffer manager
+//           numOfShards - number of partitions of the pool
+//           directIO    - read and write pages with O_DIRECT
+// Output  : None
+// Purpose : Set up the shards. The frames of all shards share one slab
+//           of page memory. If direct I/O was asked for but the file
+//           system does not support it, the pool goes through the page
+//           cache as usual.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::Init(int bufSize, int numOfShards, bool directIO)
+{
+	if (numOfShards < 1)
+		numOfShards = 1;
+	if (numOfShards > bufSize)
+		numOfShards = bufSize;
+
+	this->numOfBuf = bufSize;
+	this->numOfShards = numOfShards;
+	shards = new BufShard[numOfShards];
+	shardLatches = gcnew array<Object^>(numOfShards);
+	dbLatch = gcnew Object();
+
+	pageSlab = AllocatePageSlab(bufSize);
+	int slabOffset = 0;
+
+	directFd = -1;
+	if (directIO && MINIBASE_DB->OpenDirect(directFd) != OK)
+	{
+		cerr << "ThreadSafeBufMgr: direct I/O is not available, using the page cache" << endl;
+		directFd = -1;
+	}
+
+	for (int s = 0; s < numOfShards; s++)
+	{
+		BufShard &shard = shards[s];
+
+		// Spread the remainder over the first shards.
+		shard.numOfBuf = bufSize / numOfShards + (s < bufSize % numOfShards ? 1 : 0);
+		shard.frames = new ShardFrame[shard.numOfBuf];
+		shard.pages = pageSlab + slabOffset;
+		slabOffset += shard.numOfBuf;
+		// A dirty victim stays mapped until it is written back, next to
+		// the page that took its frame, so each frame may map two pages.
+		shard.pageTable = new PageTable(2 * shard.numOfBuf);
+		shard.replacer = new ArrayLRU(shard.numOfBuf);
+		shard.numDirty = 0;
+		shard.totalCall = 0;
+		shard.totalMiss = 0;
+		shard.numDirtyWrite = 0;
+		shard.numStallAvoided = 0;
+		shard.numFlushed = 0;
+		shard.numPrefetched = 0;
+
+		for (int f = 0; f < shard.numOfBuf; f++)
+		{
+			shard.frames[f].pid = INVALID_PAGE;
+			shard.frames[f].pinCount = 0;
+			shard.frames[f].dirty = false;
+			shard.frames[f].flushed = false;
+			shard.frames[f].inIO = false;
+			shard.frames[f].victimPid = INVALID_PAGE;
+			shard.replacer->AddFrame(f);
+		}
+
+		shardLatches[s] = gcnew Object();
+	}
+
+	flusher = nullptr;
+	flusherRunning = false;
+	prefetcher = nullptr;
+	prefetchQueue = gcnew Queue<PageID>();
+	asyncIO = nullptr;
+	spaceMap = NULL;
+	mapBase = NULL;
+	numOfMappedPages = 0;
+	numOfMappedPins = 0;
+	flushCandidates = new int[bufSize / numOfShards + 1];
+	flushFrames = new int[bufSize / numOfShards + 1];
+}
+
+//--------------------------------------------------------------------
+// Destructor for ThreadSafeBufMgr
+//
+// Input   : None
+// Output  : None
+// PostCond: All dirty pages are written to disk and the pool is freed.
+//--------------------------------------------------------------------
+ThreadSafeBufMgr::~ThreadSafeBufMgr()
+{
+	if (shards == NULL)
+		return;
+
+	StopFlusher();
+	StopPrefetcher();
+	UnmapDatabase();
+	FlushAllPages();
+	if (directFd >= 0)
+		MINIBASE_DB->CloseDirect(directFd);
+	directFd = -1;
+
+	this->!ThreadSafeBufMgr();
+}
+
+//--------------------------------------------------------------------
+// Finalizer for ThreadSafeBufMgr
+//
+// Input   : None
+// Output  : None
+// Purpose : Free the native memory of the pool. This runs on the garbage
+//           collector's thread when the pool was never disposed, and
+//           possibly after MINIBASE_DB is gone, so it does not write dirty
+//           pages or touch the database.
+//--------------------------------------------------------------------
+ThreadSafeBufMgr::!ThreadSafeBufMgr()
+{
+	if (shards == NULL)
+		return;
+
+	for (int s = 0; s < numOfShards; s++)
+	{
+		delete [] shards[s].frames;
+		delete shards[s].pageTable;
+		delete shards[s].replacer;
+	}
+	delete [] shards;
+	shards = NULL;
+	FreePageSlab(pageSlab);
+	pageSlab = NULL;
+	delete [] flushCandidates;
+	delete [] flushFrames;
+	flushCandidates = NULL;
+	flushFrames = NULL;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::ShardOf
+//
+// Input    : pid - a page id
+// Output   : None
+// Purpose  : Map a page to its shard. Consecutive page ids, as written by
+//            a scan or a bulk load, land in different shards.
+// Return   : The index of the shard owning the page.
+//--------------------------------------------------------------------
+int ThreadSafeBufMgr::ShardOf(PageID pid)
+{
+	return (int)((((unsigned int)pid * 2654435769u) >> 16) % (unsigned int)numOfShards);
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::ReadPage
+//
+// Input    : pid  - page id of a particular page
+//            page - the frame's page to read into
+// Output   : None
+// Purpose  : Read a page from the database, serialized with every other
+//            access to MINIBASE_DB.
+// Return   : The status returned by DB::ReadPage.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::ReadPage(PageID pid, Page *page)
+{
+	if (directFd >= 0)
+		return ReadPages(pid, 1, &page);
+
+	Monitor::Enter(dbLatch);
+	Status status = MINIBASE_DB->ReadPage(pid, page);
+	Monitor::Exit(dbLatch);
+	return status;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::WritePage
+//
+// Input    : pid  - page id of a particular page
+//            page - the frame's page to write out
+// Output   : None
+// Purpose  : Write a page to the database, serialized with every other
+//            access to MINIBASE_DB.
+// Return   : The status returned by DB::WritePage.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::WritePage(PageID pid, Page *page)
+{
+	if (directFd >= 0)
+		return WritePages(pid, 1, &page);
+
+	Monitor::Enter(dbLatch);
+	Status status = MINIBASE_DB->WritePage(pid, page);
+	Monitor::Exit(dbLatch);
+	return status;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::ReadPages
+//
+// Input    : first - page id of the first page of a run
+//            count - number of pages in the run
+//            pages - the frames' pages to read into
+// Output   : None
+// Purpose  : Read a run of pages with one vectored read, serialized with
+//            every other access to MINIBASE_DB. Direct reads are
+//            positional and need no serialization.
+// Return   : The status returned by DB::ReadPages.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::ReadPages(PageID first, int count, Page **pages)
+{
+	if (directFd >= 0)
+		return MINIBASE_DB->ReadPagesDirect(directFd, first, count, pages);
+
+	Monitor::Enter(dbLatch);
+	Status status = MINIBASE_DB->ReadPages(first, count, pages);
+	Monitor::Exit(dbLatch);
+	return status;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::WritePages
+//
+// Input    : first - page id of the first page of a run
+//            count - number of pages in the run
+//            pages - the frames' pages to write out
+// Output   : None
+// Purpose  : Write a run of pages with one vectored write, serialized
+//            with every other access to MINIBASE_DB. Direct writes are
+//            positional and need no serialization.
+// Return   : The status returned by DB::WritePages.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::WritePages(PageID first, int count, Page **pages)
+{
+	if (directFd >= 0)
+		return MINIBASE_DB->WritePagesDirect(directFd, first, count, pages);
+
+	Monitor::Enter(dbLatch);
+	Status status = MINIBASE_DB->WritePages(first, count, pages);
+	Monitor::Exit(dbLatch);
+	return status;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::ReserveFrame
+//
+// Input    : shard - a latched shard
+//            f     - a frame returned by the shard's replacer
+//            pid   - the page to put in the frame
+// Output   : None
+// Purpose  : Give the victim frame to pid, pinned once and marked in I/O,
+//            so that the caller can release the latch to read the page.
+//            A dirty victim stays in the page table, as the frame's
+//            victimPid, until WriteBackVictim has written it out; a
+//            thread pinning it meanwhile waits instead of reading a stale
+//            copy from disk.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::ReserveFrame(BufShard &shard, int f, PageID pid)
+{
+	ShardFrame &frame = shard.frames[f];
+	frame.victimPid = INVALID_PAGE;
+	if (frame.pid != INVALID_PAGE)
+	{
+		if (frame.dirty)
+		{
+			frame.victimPid = frame.pid;
+		}
+		else
+		{
+			if (frame.flushed)
+				shard.numStallAvoided++;
+			shard.pageTable->Delete(frame.pid);
+		}
+	}
+
+	frame.pid = pid;
+	frame.pinCount = 1;
+	frame.dirty = false;
+	frame.flushed = false;
+	frame.inIO = true;
+	shard.pageTable->Insert(pid, f);
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::WriteBackVictim
+//
+// Input    : s - a shard, not latched by the caller
+//            f - a frame reserved by ReserveFrame
+// Output   : None
+// Purpose  : Write out the dirty page the frame held before it was
+//            reserved, if any, then drop that page from the page table.
+//            The latch is only taken after the write.
+// Return   : OK if the frame is ready for its new page. FAIL if the write
+//            failed; the frame then holds its old, dirty page again and
+//            is a replacement candidate.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::WriteBackVictim(int s, int f)
+{
+	BufShard &shard = shards[s];
+	ShardFrame &frame = shard.frames[f];
+
+	// Only the thread that reserved the frame changes victimPid while the
+	// frame is in I/O, so it can be read without the latch.
+	PageID victimPid = frame.victimPid;
+	if (victimPid == INVALID_PAGE)
+		return OK;
+
+	Status status = WritePage(victimPid, &shard.pages[f]);
+
+	Monitor::Enter(shardLatches[s]);
+	frame.victimPid = INVALID_PAGE;
+	if (status == OK)
+	{
+		shard.pageTable->Delete(victimPid);
+		shard.numDirty--;
+		shard.numDirtyWrite++;
+	}
+	else
+	{
+		shard.pageTable->Delete(frame.pid);
+		frame.pid = victimPid;
+		frame.dirty = true;
+		frame.pinCount = 0;
+		frame.inIO = false;
+		shard.replacer->AddFrame(f);
+		Monitor::PulseAll(shardLatches[s]);
+	}
+	Monitor::Exit(shardLatches[s]);
+	return status;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::WaitForFrame
+//
+// Input    : s   - a shard, latched by the caller
+//            pid - a page id
+// Output   : None
+// Purpose  : Look the page up, waiting while its frame is in I/O, i.e.
+//            while another thread is reading the page or writing it back.
+//            The shard latch is released while waiting.
+// Return   : The frame holding the page, or INVALID_FRAME.
+//--------------------------------------------------------------------
+int ThreadSafeBufMgr::WaitForFrame(int s, PageID pid)
+{
+	int f = shards[s].pageTable->LookUp(pid);
+	while (f != INVALID_FRAME && shards[s].frames[f].inIO)
+	{
+		Monitor::Wait(shardLatches[s]);
+		f = shards[s].pageTable->LookUp(pid);
+	}
+	return f;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::PinPage
+//
+// Input    : pid     - page id of a particular page
+//            isEmpty - if true the page is not read from disk
+// Output   : page - a pointer to the page in the buffer pool
+// Purpose  : Pin the page, reading it into a frame of its shard if it is
+//            not resident. A dirty victim is written back first. The
+//            shard is unlatched during both, so that other threads of the
+//            shard are not held up behind the disk. If another thread is
+//            reading the page, wait for it instead.
+// Return   : OK if operation is successful.  FAIL otherwise.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::PinPage(PageID pid, Page *&page, bool isEmpty)
+{
+	page = NULL;
+	if (pid == INVALID_PAGE)
+		return FAIL;
+
+	if (mapBase != NULL)
+	{
+		// Mapped pages are read only, so there is nothing to pin an empty
+		// page for.
+		if (isEmpty || pid < 0 || pid >= numOfMappedPages)
+			return FAIL;
+		page = (Page *)(mapBase + (size_t)pid * MINIBASE_PAGESIZE);
+		Interlocked::Increment(numOfMappedPins);
+		return OK;
+	}
+
+	int s = ShardOf(pid);
+	BufShard &shard = shards[s];
+	Monitor::Enter(shardLatches[s]);
+
+	shard.totalCall++;
+	int f = WaitForFrame(s, pid);
+	if (f != INVALID_FRAME)
+	{
+		if (shard.frames[f].pinCount == 0)
+			shard.replacer->RemoveFrame(f);
+		shard.frames[f].pinCount++;
+		page = &shard.pages[f];
+		Monitor::Exit(shardLatches[s]);
+		return OK;
+	}
+
+	shard.totalMiss++;
+	f = shard.replacer->PickVictim();
+	if (f == INVALID_FRAME)
+	{
+		Monitor::Exit(shardLatches[s]);
+		cerr << "ThreadSafeBufMgr::PinPage: every frame of shard " << s << " is pinned" << endl;
+		return FAIL;
+	}
+
+	ReserveFrame(shard, f, pid);
+	ShardFrame &frame = shard.frames[f];
+	if (isEmpty && frame.victimPid == INVALID_PAGE)
+	{
+		// Nothing to read or write.
+		frame.inIO = false;
+		page = &shard.pages[f];
+		Monitor::Exit(shardLatches[s]);
+		return OK;
+	}
+	Monitor::Exit(shardLatches[s]);
+
+	// Threads pinning pid, or the victim, wait in WaitForFrame until the
+	// frame leaves I/O.
+	if (WriteBackVictim(s, f) != OK)
+		return FAIL;
+
+	Status status = isEmpty ? OK : ReadPage(pid, &shard.pages[f]);
+
+	Monitor::Enter(shardLatches[s]);
+	frame.inIO = false;
+	if (status == OK)
+	{
+		page = &shard.pages[f];
+	}
+	else
+	{
+		shard.pageTable->Delete(pid);
+		frame.pid = INVALID_PAGE;
+		frame.pinCount = 0;
+		shard.replacer->AddFreeFrame(f);
+	}
+	Monitor::PulseAll(shardLatches[s]);
+	Monitor::Exit(shardLatches[s]);
+	return status;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::UnpinPage
+//
+// Input    : pid   - page id of a particular page
+//            dirty - whether the caller modified the page
+// Output   : None
+// Purpose  : Drop one pin on the page. The frame becomes a replacement
+//            candidate when its last pin is dropped.
+// Return   : OK if operation is successful.  FAIL otherwise.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::UnpinPage(PageID pid, bool dirty)
+{
+	if (mapBase != NULL)
+	{
+		if (dirty || pid < 0 || pid >= numOfMappedPages)
+			return FAIL;
+		Interlocked::Decrement(numOfMappedPins);
+		return OK;
+	}
+
+	int s = ShardOf(pid);
+	BufShard &shard = shards[s];
+	Monitor::Enter(shardLatches[s]);
+
+	// A dirty victim being written back is still in the page table, but
+	// its frame already holds another page.
+	int f = shard.pageTable->LookUp(pid);
+	if (f == INVALID_FRAME || shard.frames[f].pid != pid || shard.frames[f].pinCount == 0)
+	{
+		Monitor::Exit(shardLatches[s]);
+		return FAIL;
+	}
+
+	ShardFrame &frame = shard.frames[f];
+	if (dirty && !frame.dirty)
+	{
+		frame.dirty = true;
+		frame.flushed = false;
+		shard.numDirty++;
+	}
+	if (--frame.pinCount == 0)
+		shard.replacer->AddFrame(f);
+
+	Monitor::Exit(shardLatches[s]);
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::NewPage
+//
+// Input    : howMany - how many pages to allocate
+// Output   : firstPid  - the page id of the first page allocated
+//            firstPage - a pointer to the page in memory
+// Purpose  : Allocate a run of pages and pin the first one. The run is
+//            deallocated again if the first page cannot be pinned.
+// Return   : OK if operation is successful.  FAIL otherwise.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::NewPage(PageID &firstPid, Page *&firstPage, int howMany)
+{
+	if (howMany < 1 || mapBase != NULL)
+		return FAIL;
+
+	Monitor::Enter(dbLatch);
+	Status status = (spaceMap != NULL) ? spaceMap->AllocatePage(firstPid, howMany)
+		: MINIBASE_DB->AllocatePage(firstPid, howMany);
+	Monitor::Exit(dbLatch);
+	if (status != OK)
+		return FAIL;
+
+	if (PinPage(firstPid, firstPage, true) != OK)
+	{
+		Monitor::Enter(dbLatch);
+		if (spaceMap != NULL)
+			spaceMap->DeallocatePage(firstPid, howMany);
+		else
+			MINIBASE_DB->DeallocatePage(firstPid, howMany);
+		Monitor::Exit(dbLatch);
+		return FAIL;
+	}
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::FreePage
+//
+// Input    : pid - page id of a particular page
+// Output   : None
+// Purpose  : Drop the page from its frame, without writing it, and
+//            deallocate it from the database.
+// Return   : OK if operation is successful.  FAIL otherwise.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::FreePage(PageID pid)
+{
+	if (mapBase != NULL)
+		return FAIL;
+
+	int s = ShardOf(pid);
+	BufShard &shard = shards[s];
+	Monitor::Enter(shardLatches[s]);
+
+	int f = WaitForFrame(s, pid);
+	if (f != INVALID_FRAME)
+	{
+		ShardFrame &frame = shard.frames[f];
+		if (frame.pinCount > 1)
+		{
+			Monitor::Exit(shardLatches[s]);
+			return FAIL;
+		}
+
+		if (frame.dirty)
+			shard.numDirty--;
+		shard.pageTable->Delete(pid);
+		frame.pid = INVALID_PAGE;
+		frame.pinCount = 0;
+		frame.dirty = false;
+		frame.flushed = false;
+		shard.replacer->AddFreeFrame(f);
+	}
+
+	Monitor::Exit(shardLatches[s]);
+
+	Monitor::Enter(dbLatch);
+	Status status = (spaceMap != NULL) ? spaceMap->DeallocatePage(pid)
+		: MINIBASE_DB->DeallocatePage(pid);
+	Monitor::Exit(dbLatch);
+	return status;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::FlushAllPages
+//
+// Input    : None
+// Output   : None
+// Purpose  : Write every dirty page to disk. Each shard is latched in
+//            turn only to pin its dirty frames and mark them clean. The
+//            pages of the whole pool are then sorted by PageID and each
+//            run of consecutive pages is written with a single
+//            DB::WritePages, even though consecutive pages live in
+//            different shards, with no shard latched. A page dirtied
+//            again meanwhile is marked dirty by its UnpinPage; a page
+//            whose write failed is marked dirty again afterwards.
+// Return   : OK if operation is successful.  FAIL otherwise.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::FlushAllPages()
+{
+	FrameRef *dirty = new FrameRef[numOfBuf];
+	int numOfDirty = 0;
+	for (int s = 0; s < numOfShards; s++)
+	{
+		BufShard &shard = shards[s];
+		Monitor::Enter(shardLatches[s]);
+		for (int f = 0; f < shard.numOfBuf; f++)
+		{
+			// A frame in I/O may be a victim being written back; wait for
+			// it to be on disk.
+			while (shard.frames[f].inIO)
+				Monitor::Wait(shardLatches[s]);
+
+			ShardFrame &frame = shard.frames[f];
+			if (frame.pid == INVALID_PAGE || !frame.dirty)
+				continue;
+
+			if (frame.pinCount == 0)
+				shard.replacer->RemoveFrame(f);
+			frame.pinCount++;
+			frame.dirty = false;
+			shard.numDirty--;
+
+			dirty[numOfDirty].pid = frame.pid;
+			dirty[numOfDirty].shard = s;
+			dirty[numOfDirty].frame = f;
+			numOfDirty++;
+		}
+		Monitor::Exit(shardLatches[s]);
+	}
+	std::sort(dirty, dirty + numOfDirty, FrameRefLess);
+
+	Status status = OK;
+	Page **run = new Page*[maxPagesPerRun];
+	int start = 0;
+	while (start < numOfDirty)
+	{
+		int end = start + 1;
+		while (end < numOfDirty && end - start < maxPagesPerRun &&
+			dirty[end].pid == dirty[end - 1].pid + 1)
+		{
+			end++;
+		}
+
+		for (int i = start; i < end; i++)
+			run[i - start] = &shards[dirty[i].shard].pages[dirty[i].frame];
+
+		bool written = (WritePages(dirty[start].pid, end - start, run) == OK);
+		if (!written)
+			status = FAIL;
+
+		for (int i = start; i < end; i++)
+		{
+			int s = dirty[i].shard;
+			ShardFrame &frame = shards[s].frames[dirty[i].frame];
+			Monitor::Enter(shardLatches[s]);
+			if (!written && !frame.dirty)
+			{
+				frame.dirty = true;
+				frame.flushed = false;
+				shards[s].numDirty++;
+			}
+			if (--frame.pinCount == 0)
+				shards[s].replacer->AddFrame(dirty[i].frame);
+			Monitor::Exit(shardLatches[s]);
+		}
+		start = end;
+	}
+	delete [] run;
+	delete [] dirty;
+	return status;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::GetNumOfUnpinnedFrames
+//
+// Input    : None
+// Output   : None
+// Return   : The number of unpinned frames across all shards.
+//--------------------------------------------------------------------
+unsigned int ThreadSafeBufMgr::GetNumOfUnpinnedFrames()
+{
+	unsigned int numUnpinned = 0;
+	for (int s = 0; s < numOfShards; s++)
+	{
+		Monitor::Enter(shardLatches[s]);
+		for (int f = 0; f < shards[s].numOfBuf; f++)
+		{
+			if (shards[s].frames[f].pinCount == 0)
+				numUnpinned++;
+		}
+		Monitor::Exit(shardLatches[s]);
+	}
+	return numUnpinned;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::GetStat
+//
+// Input    : None
+// Output   : pinNo  - number of pin requests
+//            missNo - number of pin requests that read the page
+// Purpose  : Sum the counters of every shard.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::GetStat(long &pinNo, long &missNo)
+{
+	pinNo = 0;
+	missNo = 0;
+	for (int s = 0; s < numOfShards; s++)
+	{
+		Monitor::Enter(shardLatches[s]);
+		pinNo += shards[s].totalCall;
+		missNo += shards[s].totalMiss;
+		Monitor::Exit(shardLatches[s]);
+	}
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::GetFlushStat
+//
+// Input    : None
+// Output   : flushedNo    - pages written by the flusher
+//            stallAvoidNo - misses whose victim the flusher had cleaned
+//            dirtyWriteNo - misses that wrote a dirty victim themselves
+// Purpose  : Sum the write-back counters of every shard.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::GetFlushStat(long &flushedNo, long &stallAvoidNo, long &dirtyWriteNo)
+{
+	flushedNo = 0;
+	stallAvoidNo = 0;
+	dirtyWriteNo = 0;
+	for (int s = 0; s < numOfShards; s++)
+	{
+		Monitor::Enter(shardLatches[s]);
+		flushedNo += shards[s].numFlushed;
+		stallAvoidNo += shards[s].numStallAvoided;
+		dirtyWriteNo += shards[s].numDirtyWrite;
+		Monitor::Exit(shardLatches[s]);
+	}
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::GetNumOfPrefetchedPages
+//
+// Input    : None
+// Output   : None
+// Return   : The number of pages the prefetcher read into the pool.
+//--------------------------------------------------------------------
+long ThreadSafeBufMgr::GetNumOfPrefetchedPages()
+{
+	long prefetchNo = 0;
+	for (int s = 0; s < numOfShards; s++)
+	{
+		Monitor::Enter(shardLatches[s]);
+		prefetchNo += shards[s].numPrefetched;
+		Monitor::Exit(shardLatches[s]);
+	}
+	return prefetchNo;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::ResetStat
+//
+// Input    : None
+// Output   : None
+// Purpose  : Clear the counters of every shard.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::ResetStat()
+{
+	for (int s = 0; s < numOfShards; s++)
+	{
+		Monitor::Enter(shardLatches[s]);
+		shards[s].totalCall = 0;
+		shards[s].totalMiss = 0;
+		shards[s].numDirtyWrite = 0;
+		shards[s].numStallAvoided = 0;
+		shards[s].numFlushed = 0;
+		shards[s].numPrefetched = 0;
+		Monitor::Exit(shardLatches[s]);
+	}
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::StartFlusher
+//
+// Input    : pagesPerSecond - write rate limit of the flusher
+//            highWatermark  - dirty percentage that starts a bulk flush
+//            lowWatermark   - dirty percentage that ends a bulk flush
+// Output   : None
+// Purpose  : Start the background flusher thread.
+// Return   : OK if the flusher was started, FAIL otherwise.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::StartFlusher(int pagesPerSecond, int highWatermark, int lowWatermark)
+{
+	if (flusher != nullptr || pagesPerSecond <= 0 ||
+		lowWatermark < 0 || highWatermark > 100 || lowWatermark > highWatermark)
+	{
+		return FAIL;
+	}
+
+	flushRate = pagesPerSecond;
+	this->highWatermark = highWatermark;
+	this->lowWatermark = lowWatermark;
+
+	flusherRunning = true;
+	flusher = gcnew Thread(gcnew ThreadStart(this, &ThreadSafeBufMgr::FlushLoop));
+	flusher->IsBackground = true;
+	flusher->Start();
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::StopFlusher
+//
+// Input    : None
+// Output   : None
+// Purpose  : Ask the flusher thread to exit and wait for it.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::StopFlusher()
+{
+	if (flusher == nullptr)
+		return;
+
+	flusherRunning = false;
+	flusher->Join();
+	flusher = nullptr;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::FlushLoop
+//
+// Input    : None
+// Output   : None
+// Purpose  : Body of the flusher thread. Each round cleans the dirty
+//            frames among the next victims of every shard's replacer.
+//            Once the pool is more than highWatermark percent dirty it
+//            cleans every unpinned frame, until the pool is back under
+//            lowWatermark percent. Rounds are paced to flushRate pages
+//            per second.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::FlushLoop()
+{
+	bool bulkFlush = false;
+
+	while (flusherRunning)
+	{
+		// The counters are read without latching the shards; an
+		// approximate dirty percentage is good enough to steer the flusher.
+		int numDirty = 0;
+		for (int s = 0; s < numOfShards; s++)
+			numDirty += shards[s].numDirty;
+
+		int dirtyPercent = numDirty * 100 / numOfBuf;
+		if (dirtyPercent >= highWatermark)
+			bulkFlush = true;
+		else if (dirtyPercent <= lowWatermark)
+			bulkFlush = false;
+
+		int written = 0;
+		for (int s = 0; s < numOfShards && flusherRunning; s++)
+		{
+			// Look ahead of the replacer by an eighth of the shard, or over
+			// the whole shard during a bulk flush.
+			int lookAhead = bulkFlush ? shards[s].numOfBuf : shards[s].numOfBuf / 8 + 1;
+			written += FlushShard(s, lookAhead, flushBatchSize);
+		}
+
+		int sleepMs = (written > 0) ? written * 1000 / flushRate : flushIdleMs;
+		Thread::Sleep(sleepMs > 0 ? sleepMs : 1);
+	}
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::FlushShard
+//
+// Input    : s         - the shard to clean
+//            lookAhead - how many of the next victims to examine
+//            maxPages  - the most pages to write
+// Output   : None
+// Purpose  : Write back the dirty frames among the shard's next victims,
+//            in PageID order. The shard is latched only to pick the
+//            frames, which are taken out of the replacer and marked in
+//            I/O, and again to put them back. While they are written no
+//            thread can pin them, so they cannot be dirtied again or
+//            evicted half way through.
+// Return   : The number of pages written.
+//--------------------------------------------------------------------
+int ThreadSafeBufMgr::FlushShard(int s, int lookAhead, int maxPages)
+{
+	BufShard &shard = shards[s];
+	Monitor::Enter(shardLatches[s]);
+
+	int numCandidates = shard.replacer->GetLeastRecent(flushCandidates, lookAhead);
+
+	// Keep the dirty candidates at the front of flushCandidates, least
+	// recently used first, and in flushFrames sorted by PageID so that
+	// the writes sweep the file in one direction. Batches are small, so
+	// an insertion sort is enough.
+	int numBatch = 0;
+	for (int i = 0; i < numCandidates && numBatch < maxPages; i++)
+	{
+		int f = flushCandidates[i];
+		if (!shard.frames[f].dirty)
+			continue;
+
+		flushCandidates[numBatch] = f;
+		int j = numBatch++;
+		while (j > 0 && shard.frames[flushFrames[j - 1]].pid > shard.frames[f].pid)
+		{
+			flushFrames[j] = flushFrames[j - 1];
+			j--;
+		}
+		flushFrames[j] = f;
+
+		shard.replacer->RemoveFrame(f);
+		shard.frames[f].inIO = true;
+	}
+	Monitor::Exit(shardLatches[s]);
+
+	int written = 0;
+	while (written < numBatch)
+	{
+		int f = flushFrames[written];
+		if (WritePage(shard.frames[f].pid, &shard.pages[f]) != OK)
+			break;
+		written++;
+	}
+
+	Monitor::Enter(shardLatches[s]);
+	for (int i = 0; i < written; i++)
+	{
+		ShardFrame &frame = shard.frames[flushFrames[i]];
+		frame.dirty = false;
+		frame.flushed = true;
+		shard.numDirty--;
+		shard.numFlushed++;
+	}
+
+	// Put the frames back where they were taken from, at the least
+	// recently used end, in their old order.
+	for (int i = numBatch - 1; i >= 0; i--)
+	{
+		int f = flushCandidates[i];
+		shard.frames[f].inIO = false;
+		shard.replacer->AddFreeFrame(f);
+	}
+	if (numBatch > 0)
+		Monitor::PulseAll(shardLatches[s]);
+	Monitor::Exit(shardLatches[s]);
+	return written;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::Prefetch
+//
+// Input    : first - page id of the first page of a run
+//            count - number of pages in the run
+// Output   : None
+// Purpose  : Ask the prefetcher to read the run into the pool. The call
+//            returns at once; the pages are read in the background and
+//            are not pinned. Requests beyond the prefetch queue length
+//            are dropped, as a later PinPage reads the page anyway.
+// Return   : OK if the request was queued, FAIL if the run is invalid.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::Prefetch(PageID first, int count)
+{
+	if (first == INVALID_PAGE || count < 0)
+		return FAIL;
+
+	if (mapBase != NULL)
+	{
+		// Let the kernel read the run ahead into the mapping.
+		if (first < 0 || first >= numOfMappedPages)
+			return FAIL;
+		if (count > numOfMappedPages - first)
+			count = numOfMappedPages - first;
+#ifndef _WIN32
+		madvise(mapBase + (size_t)first * MINIBASE_PAGESIZE, (size_t)count * MINIBASE_PAGESIZE, MADV_WILLNEED);
+#endif
+		return OK;
+	}
+
+	StartPrefetcher();
+
+	Monitor::Enter(prefetchQueue);
+	for (int i = 0; i < count && prefetchQueue->Count < maxPrefetchQueue; i++)
+	{
+		prefetchQueue->Enqueue(first + i);
+	}
+	Monitor::Pulse(prefetchQueue);
+	Monitor::Exit(prefetchQueue);
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::Prefetch
+//
+// Input    : pids  - page ids in the order they will be pinned
+//            count - number of page ids
+// Output   : None
+// Purpose  : Same as Prefetch(first, count), for pages that do not form
+//            a run, such as the data pages listed by a directory page or
+//            the leaves listed by an index page.
+// Return   : OK if the request was queued, FAIL if the list is invalid.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::Prefetch(const PageID *pids, int count)
+{
+	if (pids == NULL || count < 0)
+		return FAIL;
+
+	if (mapBase != NULL)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (pids[i] != INVALID_PAGE)
+				Prefetch(pids[i], 1);
+		}
+		return OK;
+	}
+
+	StartPrefetcher();
+
+	Monitor::Enter(prefetchQueue);
+	for (int i = 0; i < count && prefetchQueue->Count < maxPrefetchQueue; i++)
+	{
+		if (pids[i] != INVALID_PAGE)
+			prefetchQueue->Enqueue(pids[i]);
+	}
+	Monitor::Pulse(prefetchQueue);
+	Monitor::Exit(prefetchQueue);
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::StartPrefetcher
+//
+// Input    : None
+// Output   : None
+// Purpose  : Start the prefetcher thread the first time it is needed.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::StartPrefetcher()
+{
+	Monitor::Enter(prefetchQueue);
+	if (prefetcher == nullptr)
+	{
+		prefetcherRunning = true;
+		prefetcher = gcnew Thread(gcnew ThreadStart(this, &ThreadSafeBufMgr::PrefetchLoop));
+		prefetcher->IsBackground = true;
+		prefetcher->Start();
+	}
+	Monitor::Exit(prefetchQueue);
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::StopPrefetcher
+//
+// Input    : None
+// Output   : None
+// Purpose  : Drop the queued requests, stop the prefetcher thread and
+//            wait for it to exit.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::StopPrefetcher()
+{
+	Monitor::Enter(prefetchQueue);
+	Thread^ t = prefetcher;
+	prefetcherRunning = false;
+	prefetchQueue->Clear();
+	Monitor::Pulse(prefetchQueue);
+	Monitor::Exit(prefetchQueue);
+
+	if (t != nullptr)
+		t->Join();
+	prefetcher = nullptr;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::PrefetchLoop
+//
+// Input    : None
+// Output   : None
+// Purpose  : Body of the prefetcher thread: take up to maxPagesPerRun
+//            queued pages at a time and load them, until asked to stop.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::PrefetchLoop()
+{
+	PageID *batch = new PageID[maxPagesPerRun];
+
+	while (true)
+	{
+		Monitor::Enter(prefetchQueue);
+		while (prefetchQueue->Count == 0 && prefetcherRunning)
+			Monitor::Wait(prefetchQueue);
+
+		if (!prefetcherRunning)
+		{
+			Monitor::Exit(prefetchQueue);
+			break;
+		}
+
+		int n = 0;
+		while (n < maxPagesPerRun && prefetchQueue->Count > 0)
+			batch[n++] = prefetchQueue->Dequeue();
+		Monitor::Exit(prefetchQueue);
+
+		LoadPages(batch, n);
+	}
+
+	delete [] batch;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::LoadPages
+//
+// Input    : pids  - page ids to load, at most maxPagesPerRun
+//            count - number of page ids
+// Output   : None
+// Purpose  : Read pages into unpinned frames without pinning them.
+//            Each page that is not resident gets a frame, reserved and
+//            marked in I/O under its shard's latch. The reads happen
+//            with the latches released, so pins of other pages go
+//            ahead, and each run of consecutive page ids is read with a
+//            single DB::ReadPages. A PinPage of a page being read waits
+//            until its read is done.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::LoadPages(const PageID *pids, int count)
+{
+	FrameRef *loading = new FrameRef[count];
+	int numLoading = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		int s = ShardOf(pids[i]);
+		BufShard &shard = shards[s];
+		Monitor::Enter(shardLatches[s]);
+
+		if (shard.pageTable->LookUp(pids[i]) != INVALID_FRAME)
+		{
+			Monitor::Exit(shardLatches[s]);
+			continue;
+		}
+
+		int f = shard.replacer->PickVictim();
+		if (f == INVALID_FRAME)
+		{
+			Monitor::Exit(shardLatches[s]);
+			continue;
+		}
+
+		// The reserved frame is pinned, so neither the replacer nor the
+		// flusher touches it while it is being read.
+		ReserveFrame(shard, f, pids[i]);
+		Monitor::Exit(shardLatches[s]);
+
+		if (WriteBackVictim(s, f) != OK)
+			continue;
+
+		loading[numLoading].pid = pids[i];
+		loading[numLoading].shard = s;
+		loading[numLoading].frame = f;
+		numLoading++;
+	}
+
+	AsyncIO^ io = asyncIO;
+	if (io != nullptr)
+	{
+		// Every read is in flight at once, up to the queue depth of io,
+		// and the disk serves them in whatever order suits it.
+		IOCompletion *done = new IOCompletion[numLoading];
+		int numInFlight = 0;
+		for (int i = 0; i < numLoading; i++)
+		{
+			Page *page = &shards[loading[i].shard].pages[loading[i].frame];
+			bool submitted = (io->SubmitRead(loading[i].pid, page, i) == OK);
+			while (!submitted && numInFlight > 0)
+			{
+				// The queue is full; make room.
+				int n = io->WaitForCompletions(1, done, numInFlight);
+				for (int j = 0; j < n; j++)
+					FinishLoad(loading[done[j].tag], done[j].status);
+				numInFlight -= n;
+				submitted = (io->SubmitRead(loading[i].pid, page, i) == OK);
+			}
+
+			if (submitted)
+				numInFlight++;
+			else
+				FinishLoad(loading[i], FAIL);
+		}
+
+		while (numInFlight > 0)
+		{
+			int n = io->WaitForCompletions(1, done, numInFlight);
+			for (int j = 0; j < n; j++)
+				FinishLoad(loading[done[j].tag], done[j].status);
+			numInFlight -= n;
+		}
+		delete [] done;
+		delete [] loading;
+		return;
+	}
+
+	Page **run = new Page*[maxPagesPerRun];
+	int start = 0;
+	while (start < numLoading)
+	{
+		int end = start + 1;
+		while (end < numLoading && loading[end].pid == loading[end - 1].pid + 1)
+			end++;
+
+		for (int i = start; i < end; i++)
+			run[i - start] = &shards[loading[i].shard].pages[loading[i].frame];
+		Status status = ReadPages(loading[start].pid, end - start, run);
+
+		for (int i = start; i < end; i++)
+			FinishLoad(loading[i], status);
+		start = end;
+	}
+
+	delete [] run;
+	delete [] loading;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::FinishLoad
+//
+// Input    : ref    - a frame reserved by LoadPages
+//            status - the outcome of the frame's read
+// Output   : None
+// Purpose  : Make the frame a replacement candidate, holding the page if
+//            it was read and empty otherwise, and wake up the threads
+//            waiting for it.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::FinishLoad(const FrameRef &ref, Status status)
+{
+	BufShard &shard = shards[ref.shard];
+	ShardFrame &frame = shard.frames[ref.frame];
+
+	Monitor::Enter(shardLatches[ref.shard]);
+	frame.inIO = false;
+	frame.pinCount = 0;
+	if (status != OK)
+	{
+		shard.pageTable->Delete(frame.pid);
+		frame.pid = INVALID_PAGE;
+		shard.replacer->AddFreeFrame(ref.frame);
+	}
+	else
+	{
+		shard.numPrefetched++;
+		shard.replacer->AddFrame(ref.frame);
+	}
+	Monitor::PulseAll(shardLatches[ref.shard]);
+	Monitor::Exit(shardLatches[ref.shard]);
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::UseAsyncIO
+//
+// Input    : io - an AsyncIO over MINIBASE_DB, or nullptr
+// Output   : None
+// Purpose  : Let the prefetcher keep all of a batch's reads in flight at
+//            once through io, instead of one vectored read per run of
+//            consecutive pages. nullptr goes back to vectored reads.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::UseAsyncIO(AsyncIO^ io)
+{
+	asyncIO = io;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::UseSpaceMap
+//
+// Input    : sm - a SpaceMap over MINIBASE_DB, or NULL
+// Output   : None
+// Purpose  : Allocate and free pages through sm, which finds free runs a
+//            word at a time, rather than through DB, which walks the
+//            space map bit by bit from the first page. NULL goes back to
+//            DB. The pool does not own sm.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::UseSpaceMap(SpaceMap *sm)
+{
+	Monitor::Enter(dbLatch);
+	spaceMap = sm;
+	Monitor::Exit(dbLatch);
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::MapDatabase
+//
+// Input    : None
+// Output   : None
+// Purpose  : Map the whole database file read only and serve every pin
+//            from the mapping. The pool must be empty, since pages in
+//            frames would shadow the mapping.
+// Return   : OK if the file is mapped. FAIL if a page is resident, the
+//            pool is already mapped or the file could not be mapped.
+//--------------------------------------------------------------------
+Status ThreadSafeBufMgr::MapDatabase()
+{
+	if (mapBase != NULL)
+		return FAIL;
+
+	StopFlusher();
+	StopPrefetcher();
+	for (int s = 0; s < numOfShards; s++)
+	{
+		for (int f = 0; f < shards[s].numOfBuf; f++)
+		{
+			if (shards[s].frames[f].pid != INVALID_PAGE)
+			{
+				cerr << "ThreadSafeBufMgr::MapDatabase: the pool is not empty" << endl;
+				return FAIL;
+			}
+		}
+	}
+
+	int numOfPages = MINIBASE_DB->GetNumOfPages();
+	size_t size = (size_t)numOfPages * MINIBASE_PAGESIZE;
+
+#ifdef _WIN32
+	// The C runtime has no mmap; use the framework's memory mapped files.
+	try
+	{
+		// DB keeps the file open, so it has to be shared.
+		FileStream^ stream = gcnew FileStream(gcnew String(MINIBASE_DB->GetName()),
+			FileMode::Open, FileAccess::Read, FileShare::ReadWrite);
+		mappedFile = MemoryMappedFile::CreateFromFile(stream, nullptr, 0, MemoryMappedFileAccess::Read,
+			nullptr, HandleInheritability::None, false);
+		mappedView = mappedFile->CreateViewAccessor(0, size, MemoryMappedFileAccess::Read);
+	}
+	catch (Exception^)
+	{
+		cerr << "ThreadSafeBufMgr::MapDatabase: could not map " << MINIBASE_DB->GetName() << endl;
+		delete mappedFile;
+		mappedFile = nullptr;
+		return FAIL;
+	}
+	unsigned char *base = NULL;
+	mappedView->SafeMemoryMappedViewHandle->AcquirePointer(base);
+	mapBase = (char *)base;
+#else
+	void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, MINIBASE_DB->GetFileDescriptor(), 0);
+	if (base == MAP_FAILED)
+	{
+		cerr << "ThreadSafeBufMgr::MapDatabase: could not map " << MINIBASE_DB->GetName() << endl;
+		return FAIL;
+	}
+	mapBase = (char *)base;
+#endif
+
+	numOfMappedPages = numOfPages;
+	numOfMappedPins = 0;
+	return OK;
+}
+
+//--------------------------------------------------------------------
+// ThreadSafeBufMgr::UnmapDatabase
+//
+// Input    : None
+// Output   : None
+// Purpose  : Drop the mapping, if any, and go back to reading pages
+//            into frames.
+// Condition: No mapped page is pinned.
+//--------------------------------------------------------------------
+void ThreadSafeBufMgr::UnmapDatabase()
+{
+	if (mapBase == NULL)
+		return;
+
+	if (numOfMappedPins != 0)
+		cerr << "ThreadSafeBufMgr::UnmapDatabase: " << numOfMappedPins << " pins outstanding" << endl;
+
+#ifdef _WIN32
+	mappedView->SafeMemoryMappedViewHandle->ReleasePointer();
+	delete mappedView;
+	delete mappedFile;
+	mappedView = nullptr;
+	mappedFile = nullptr;
+#else
+	munmap(mapBase, (size_t)numOfMappedPages * MINIBASE_PAGESIZE);
+#endif
+	mapBase = NULL;
+	numOfMappedPages = 0;
+}
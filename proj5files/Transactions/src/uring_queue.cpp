@@ -0,0 +1,150 @@
+// Native code: this file is compiled without /clr, see uring_queue.h.
+
+#include <errno.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef MINIBASE_IO_URING
+#include <liburing.h>
+#endif
+
+#include "uring_queue.h"
+
+//-------------------------------------------------------------------
+// UringQueue::UringQueue
+//
+// Input   : fd       - the file to transfer pages of
+//           pageSize - bytes per page
+//           depth    - the most transfers outstanding at once
+// Output  : ok - false if io_uring is not available
+// Purpose : Set up a ring with one submission entry per transfer.
+//-------------------------------------------------------------------
+UringQueue::UringQueue(int fd, int pageSize, int depth, bool &ok)
+{
+	this->fd = fd;
+	this->pageSize = pageSize;
+	ring = NULL;
+	numUnsubmitted = 0;
+	ok = false;
+
+#ifdef MINIBASE_IO_URING
+	ring = new struct io_uring;
+	if (io_uring_queue_init(depth, ring, 0) < 0)
+	{
+		delete ring;
+		ring = NULL;
+		return;
+	}
+	ok = true;
+#endif
+}
+
+//-------------------------------------------------------------------
+// UringQueue::~UringQueue
+//
+// Input   : None
+// Output  : None
+// Purpose : Tear down the ring.
+//-------------------------------------------------------------------
+UringQueue::~UringQueue()
+{
+#ifdef MINIBASE_IO_URING
+	if (ring != NULL)
+	{
+		io_uring_queue_exit(ring);
+		delete ring;
+	}
+#endif
+}
+
+//-------------------------------------------------------------------
+// UringQueue::Prepare
+//
+// Input   : write  - true to write the page, false to read it
+//           pageNo - the page
+//           page   - the page's memory
+//           slot   - returned by Reap with the transfer's outcome
+// Output  : None
+// Purpose : Queue the transfer in the ring. If every submission entry
+//           is taken, the queued ones are submitted first; if that does
+//           not free one either, the transfer is refused.
+// Return  : true if the transfer is queued.
+//-------------------------------------------------------------------
+bool UringQueue::Prepare(bool write, int pageNo, void *page, int slot)
+{
+#ifdef MINIBASE_IO_URING
+	struct io_uring_sqe *sqe = io_uring_get_sqe(ring);
+	if (sqe == NULL && Submit())
+		sqe = io_uring_get_sqe(ring);
+	if (sqe == NULL)
+		return false;
+
+	off_t offset = (off_t)pageNo * pageSize;
+	if (write)
+		io_uring_prep_write(sqe, fd, page, pageSize, offset);
+	else
+		io_uring_prep_read(sqe, fd, page, pageSize, offset);
+	io_uring_sqe_set_data(sqe, (void *)(long)slot);
+	numUnsubmitted++;
+	return true;
+#else
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------
+// UringQueue::Submit
+//
+// Input   : None
+// Output  : None
+// Purpose : Hand the queued transfers to the kernel with one system
+//           call.
+// Return  : false if io_uring_submit failed.
+//-------------------------------------------------------------------
+bool UringQueue::Submit()
+{
+#ifdef MINIBASE_IO_URING
+	if (numUnsubmitted == 0)
+		return true;
+	if (io_uring_submit(ring) < 0)
+		return false;
+	numUnsubmitted = 0;
+	return true;
+#else
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------
+// UringQueue::Reap
+//
+// Input   : wait - block until a transfer finishes
+// Output  : slot        - the finished transfer's slot
+//           transferred - whether the whole page was transferred
+// Purpose : Collect one finished transfer from the completion queue.
+// Return  : 1 if a transfer was collected, 0 if none is ready and wait
+//           is false, -1 on an error of the ring.
+//-------------------------------------------------------------------
+int UringQueue::Reap(bool wait, int &slot, bool &transferred)
+{
+#ifdef MINIBASE_IO_URING
+	struct io_uring_cqe *cqe;
+	int error;
+	do
+	{
+		error = wait ? io_uring_wait_cqe(ring, &cqe) : io_uring_peek_cqe(ring, &cqe);
+	} while (error == -EINTR);
+
+	if (error == -EAGAIN && !wait)
+		return 0;
+	if (error < 0)
+		return -1;
+
+	slot = (int)(long)io_uring_cqe_get_data(cqe);
+	transferred = (cqe->res == pageSize);
+	io_uring_cqe_seen(ring, cqe);
+	return 1;
+#else
+	return -1;
+#endif
+}